@@ -0,0 +1,28 @@
+dnl
+dnl Check which flags are needed for std::thread
+dnl
+
+AC_CACHE_CHECK([for the flags needed for std::thread], [ac_cv_pthread_libs], [
+  AC_LANG_PUSH(C++)
+  ac_save_CXXFLAGS="$CXXFLAGS"
+  ac_save_LIBS="$LIBS"
+  CXXFLAGS="$CXXFLAGS $STD_CXX"
+  ac_cv_pthread_libs=no
+
+  for flags in "" -pthread -lpthread; do
+    LIBS="$ac_save_LIBS $flags"
+    AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <thread>]], [[std::thread t([]() {}); t.join();]])],
+                   [ac_cv_pthread_libs="$flags"; break])
+  done
+
+  CXXFLAGS="$ac_save_CXXFLAGS"
+  LIBS="$ac_save_LIBS"
+  AC_LANG_POP()
+])
+
+if test x"$ac_cv_pthread_libs" = xno; then
+  AC_MSG_ERROR([The C++ compiler and its standard library do not support std::thread.])
+fi
+
+PTHREAD_LIBS="$ac_cv_pthread_libs"
+AC_SUBST(PTHREAD_LIBS)
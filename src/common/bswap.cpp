@@ -15,9 +15,127 @@
 
 #include "common/bswap.h"
 #include "common/endian.h"
+#include "common/simd.h"
+
+#if defined(MTX_SIMD_X86)
+# include <immintrin.h>
+#endif
 
 namespace mtx {
 
+namespace {
+
+#if defined(MTX_SIMD_X86)
+MTX_SIMD_TARGET("sse2")
+std::size_t
+bswap_buffer_sse2(unsigned char const *src,
+                  unsigned char *dst,
+                  std::size_t num_bytes,
+                  std::size_t word_length) {
+  if (2 != word_length)
+    return 0;
+
+  std::size_t idx = 0;
+
+  for (; (idx + 16) <= num_bytes; idx += 16) {
+    auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&src[idx]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[idx]), _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8)));
+  }
+
+  return idx;
+}
+
+/** \brief Swaps as many words as possible sixteen bytes at a time
+
+   For 24-bit words only the first twelve bytes of each block are
+   swapped. The remaining four bytes are stored unmodified and
+   processed again with the next block.
+
+   \return The number of bytes that have been swapped.
+*/
+MTX_SIMD_TARGET("ssse3")
+std::size_t
+bswap_buffer_ssse3(unsigned char const *src,
+                   unsigned char *dst,
+                   std::size_t num_bytes,
+                   std::size_t word_length) {
+  __m128i mask;
+  std::size_t step = 16;
+
+  if (2 == word_length)
+    mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+  else if (3 == word_length) {
+    mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+    step = 12;
+
+  } else if (4 == word_length)
+    mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+  else if (8 == word_length)
+    mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+  else
+    return 0;
+
+  std::size_t idx = 0;
+
+  for (; (idx + 16) <= num_bytes; idx += step) {
+    auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&src[idx]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[idx]), _mm_shuffle_epi8(block, mask));
+  }
+
+  return idx;
+}
+
+MTX_SIMD_TARGET("avx2")
+std::size_t
+bswap_buffer_avx2(unsigned char const *src,
+                  unsigned char *dst,
+                  std::size_t num_bytes,
+                  std::size_t word_length) {
+  // The shuffle works within each 128-bit lane; therefore 24-bit
+  // words are left to the SSSE3 kernel.
+  __m256i mask;
+
+  if (2 == word_length)
+    mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+  else if (4 == word_length)
+    mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+  else if (8 == word_length)
+    mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+  else
+    return 0;
+
+  std::size_t idx = 0;
+
+  for (; (idx + 32) <= num_bytes; idx += 32) {
+    auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&src[idx]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst[idx]), _mm256_shuffle_epi8(block, mask));
+  }
+
+  return idx;
+}
+#endif  // MTX_SIMD_X86
+
+template<typename T, T (*swapper)(T)>
+void
+bswap_words(unsigned char const *src,
+            unsigned char *dst,
+            std::size_t num_bytes) {
+  for (std::size_t idx = 0; idx < num_bytes; idx += sizeof(T)) {
+    T word;
+    std::memcpy(&word, &src[idx], sizeof(T));
+    word = swapper(word);
+    std::memcpy(&dst[idx], &word, sizeof(T));
+  }
+}
+
+}
+
 void
 bswap_buffer(unsigned char const *src,
              unsigned char *dst,
@@ -26,8 +144,44 @@ bswap_buffer(unsigned char const *src,
   if ((num_bytes % word_length) != 0)
     throw std::invalid_argument((boost::format(Y("The number of bytes to swap isn't divisible by %1%.")) % word_length).str());
 
-  for (std::size_t idx = 0; idx < num_bytes; idx += word_length)
-    put_uint_le(&dst[idx], get_uint_be(&src[idx], word_length), word_length);
+#if defined(MTX_SIMD_X86)
+  auto level     = mtx::simd::get_level();
+  auto skip_done = [&src, &dst, &num_bytes](std::size_t num_done) {
+    src       += num_done;
+    dst       += num_done;
+    num_bytes -= num_done;
+  };
+
+  if (mtx::simd::level_e::avx2 <= level)
+    skip_done(bswap_buffer_avx2(src, dst, num_bytes, word_length));
+
+  if (mtx::simd::level_e::ssse3 <= level)
+    skip_done(bswap_buffer_ssse3(src, dst, num_bytes, word_length));
+
+  else if (mtx::simd::level_e::sse2 <= level)
+    skip_done(bswap_buffer_sse2(src, dst, num_bytes, word_length));
+#endif
+
+  if (2 == word_length)
+    bswap_words<uint16_t, bswap_16>(src, dst, num_bytes);
+
+  else if (4 == word_length)
+    bswap_words<uint32_t, bswap_32>(src, dst, num_bytes);
+
+  else if (8 == word_length)
+    bswap_words<uint64_t, bswap_64>(src, dst, num_bytes);
+
+  else if (3 == word_length)
+    for (std::size_t idx = 0; idx < num_bytes; idx += 3) {
+      auto first   = src[idx];
+      dst[idx]     = src[idx + 2];
+      dst[idx + 1] = src[idx + 1];
+      dst[idx + 2] = first;
+    }
+
+  else
+    for (std::size_t idx = 0; idx < num_bytes; idx += word_length)
+      put_uint_le(&dst[idx], get_uint_be(&src[idx], word_length), word_length);
 }
 
 }
@@ -28,6 +28,7 @@
 
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
+#include "common/output_channel.h"
 #include "common/random.h"
 #include "common/stereo_mode.h"
 #include "common/strings/editing.h"
@@ -81,6 +82,8 @@ static std::string s_program_name;
 
 static void
 mtx_common_cleanup() {
+  mtx::output::stop_channel();
+
   // Make sure g_mm_stdio is closed before the global destruction
   // kicks in. If it's redirected to a file then this is an instance
   // of a buffered file. If it's only collected via global destruction
@@ -27,6 +27,7 @@
 
 #include "common/debugging.h"
 #include "common/logger.h"
+#include "common/output_channel.h"
 #include "common/strings/editing.h"
 #include "common/strings/formatting.h"
 
@@ -92,13 +93,50 @@ debugging_c::send_to_logger(bool enable) {
 }
 
 void
-debugging_c::output(std::string const &msg) {
+debugging_c::write(std::string const &msg) {
   if (ms_send_to_logger)
     log_it(msg);
   else
     mxmsg(MXMSG_INFO, msg);
 }
 
+std::string
+debugging_c::format_location(char const *file,
+                             unsigned int line,
+                             std::string const &msg) {
+  return (boost::format("Debug> %1%:%|2$04d|: %3%") % file % line % msg).str();
+}
+
+void
+debugging_c::output(std::string const &msg) {
+  if (mtx::output::use_channel())
+    mtx::output::post_to_channel([msg]() { write(msg); });
+  else
+    write(msg);
+}
+
+void
+debugging_c::output(char const *file,
+                    unsigned int line,
+                    std::string const &msg) {
+  if (mtx::output::use_channel())
+    mtx::output::post_to_channel([file, line, msg]() { write(format_location(file, line, msg)); });
+  else
+    write(format_location(file, line, msg));
+}
+
+void
+debugging_c::output(char const *file,
+                    unsigned int line,
+                    boost::format const &msg) {
+  // Only a copy of the format object is made here. Assembling the
+  // message is left to the channel's thread.
+  if (mtx::output::use_channel())
+    mtx::output::post_to_channel([file, line, msg]() { write(format_location(file, line, msg.str())); });
+  else
+    write(format_location(file, line, msg.str()));
+}
+
 void
 debugging_c::hexdump(const void *buffer_to_dump,
                      size_t length) {
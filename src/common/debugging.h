@@ -33,6 +33,17 @@ public:
     output(msg.str());
   }
 
+  // Used by mxdebug(). If the output channel is active then the
+  // message is formatted by its background thread.
+  static void output(char const *file, unsigned int line, std::string const &msg);
+  static void output(char const *file, unsigned int line, boost::format const &msg);
+  template<typename T>
+  static void output(char const *file,
+                     unsigned int line,
+                     T const &msg) {
+    output(file, line, (boost::format("%1%") % msg).str());
+  }
+
   static void hexdump(const void *buffer_to_dump, size_t lenth);
   static void hexdump(memory_c const &buffer_to_dump, boost::optional<std::size_t> max_length = boost::none);
   static void hexdump(memory_cptr const &buffer_to_dump, boost::optional<std::size_t> max_length = boost::none);
@@ -43,6 +54,10 @@ public:
   }
   static void request(const std::string &options, bool enable = true);
   static void init();
+
+protected:
+  static void write(std::string const &msg);
+  static std::string format_location(char const *file, unsigned int line, std::string const &msg);
 };
 
 class debugging_option_c {
@@ -90,7 +105,7 @@ public:
   static void invalidate_cache();
 };
 
-#define mxdebug(msg) debugging_c::output((boost::format("Debug> %1%:%|2$04d|: %3%") % __FILE__ % __LINE__ % (msg)).str())
+#define mxdebug(msg) debugging_c::output(__FILE__, __LINE__, (msg))
 
 #define mxdebug_if(condition, msg) \
   if (condition) {                 \
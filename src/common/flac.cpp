@@ -21,6 +21,7 @@
 #include <stdarg.h>
 
 #include "common/bit_cursor.h"
+#include "common/checksums/crc.h"
 #include "common/flac.h"
 #include "common/mm_io_x.h"
 
@@ -250,6 +251,72 @@ get_num_samples(unsigned char const *mem,
   }
 }
 
+// Checks whether or not a complete & valid frame header starts at
+// 'mem'. Returns its size including the CRC-8 if it is and 0 if it
+// isn't or if 'size' isn't big enough to contain it.
+size_t
+get_frame_header_size(unsigned char const *mem,
+                      size_t size) {
+  // Sync word (14 bits), a reserved bit that must be 0 and the
+  // blocking strategy.
+  if ((4 > size) || (0xff != mem[0]) || (0xf8 != (mem[1] & 0xfe)))
+    return 0;
+
+  auto block_size_code  = mem[2] >> 4;
+  auto sample_rate_code = mem[2] & 0x0f;
+  auto channels_code    = mem[3] >> 4;
+  auto sample_size_code = (mem[3] >> 1) & 0x07;
+
+  if (   (0x00 == block_size_code)
+      || (0x0f == sample_rate_code)
+      || (0x0b <= channels_code)
+      || (0x03 == sample_size_code)
+      || (0x07 == sample_size_code)
+      || (mem[3] & 0x01))
+    return 0;
+
+  // Sample or frame number coded like UTF-8.
+  if (5 > size)
+    return 0;
+
+  auto first     = mem[4];
+  auto num_extra = !(first & 0x80)            ? 0
+                 : (0xc0 == (first & 0xe0))   ? 1
+                 : (0xe0 == (first & 0xf0))   ? 2
+                 : (0xf0 == (first & 0xf8))   ? 3
+                 : (0xf8 == (first & 0xfc))   ? 4
+                 : (0xfc == (first & 0xfe))   ? 5
+                 : (0xfe == first)            ? 6
+                 :                              -1;
+
+  if (-1 == num_extra)
+    return 0;
+
+  auto pos = 5u + num_extra;
+  if (pos > size)
+    return 0;
+
+  for (auto idx = 5u; idx < pos; ++idx)
+    if (0x80 != (mem[idx] & 0xc0))
+      return 0;
+
+  pos += 6 == block_size_code  ? 1
+       : 7 == block_size_code  ? 2
+       :                         0;
+  pos += 12 == sample_rate_code ? 1
+       : 13 <= sample_rate_code ? 2
+       :                          0;
+
+  if ((pos + 1) > size)
+    return 0;
+
+  // The CRC-8 over the whole header including the CRC itself must be 0.
+  checksum::crc8_atm_c crc;
+  crc.add(mem, pos + 1);
+
+  return crc.get_result_as_uint() ? 0 : pos + 1;
+}
+
 #define FPFX "flac_decode_headers: "
 
 struct header_extractor_t {
@@ -29,6 +29,11 @@ namespace mtx { namespace flac {
 #define FLAC_HEADER_APPLICATION      8
 #define FLAC_HEADER_SEEKTABLE       16
 
+// Sync code (14 bits) through the CRC-8 with the longest possible
+// coded sample/frame number and the optional block size & sample rate
+// fields.
+#define FLAC_FRAME_HEADER_MAX_SIZE  16
+
 class decoder_deleter_c {
 public:
   void operator()(FLAC__StreamDecoder *decoder) {
@@ -61,6 +66,7 @@ public:
 };
 
 int get_num_samples(unsigned char const *buf, int size, FLAC__StreamMetadata_StreamInfo const &stream_info);
+size_t get_frame_header_size(unsigned char const *buf, size_t size);
 int decode_headers(unsigned char const *mem, int size, int num_elements, ...);
 
 }}                              // namespace mtx::flac
@@ -21,6 +21,7 @@
 #include "common/checksums/base.h"
 #include "common/endian.h"
 #include "common/hacks.h"
+#include "common/memory_accounting.h"
 #include "common/mm_io.h"
 #include "common/mpeg.h"
 #include "common/hevc.h"
@@ -28,6 +29,8 @@
 
 namespace mtx { namespace hevc {
 
+static auto &s_frame_memory = mtx::memory_accounting::component("HEVC/h.265 parser");
+
 std::unordered_map<int, std::string> es_parser_c::ms_nalu_names_by_type;
 
 hevcc_c::hevcc_c()
@@ -1431,6 +1434,8 @@ es_parser_c::es_parser_c()
 }
 
 es_parser_c::~es_parser_c() {
+  s_frame_memory.remove(m_num_queued_frame_bytes);
+
   mxdebug_if(debugging_c::requested("hevc_statistics"),
              boost::format("HEVC statistics: #frames: out %1% discarded %2% #timecodes: in %3% generated %4% discarded %5% num_fields: %6% num_frames: %7%\n")
              % m_stats.num_frames_out % m_stats.num_frames_discarded % m_stats.num_timecodes_in % m_stats.num_timecodes_generated % m_stats.num_timecodes_discarded
@@ -1537,8 +1542,11 @@ es_parser_c::flush() {
 
   m_unparsed_buffer.reset();
   if (m_have_incomplete_frame) {
+    add_nalus_to_incomplete_frame();
     m_frames.push_back(m_incomplete_frame);
     m_have_incomplete_frame = false;
+
+    account_queued_frame(m_frames.back(), true);
   }
 
   cleanup();
@@ -1556,9 +1564,36 @@ es_parser_c::flush_incomplete_frame() {
   if (!m_have_incomplete_frame || !m_hevcc_ready)
     return;
 
+  add_nalus_to_incomplete_frame();
+
   m_frames.push_back(m_incomplete_frame);
   m_incomplete_frame.clear();
   m_have_incomplete_frame = false;
+
+  account_queued_frame(m_frames.back(), true);
+}
+
+// Appends all slice NALUs following the first one to the incomplete
+// frame's data. Doing this once the frame is complete requires only a
+// single re-allocation instead of one per slice.
+void
+es_parser_c::add_nalus_to_incomplete_frame() {
+  if (m_incomplete_frame_nalus.empty())
+    return;
+
+  auto &mem     = *m_incomplete_frame.m_data;
+  auto offset   = mem.get_size();
+  auto new_size = boost::accumulate(m_incomplete_frame_nalus, offset, [this](std::size_t size, memory_cptr const &nalu) { return size + m_nalu_size_length + nalu->get_size(); });
+
+  mem.resize(new_size);
+
+  for (auto const &nalu : m_incomplete_frame_nalus) {
+    put_uint_be(mem.get_buffer() + offset, nalu->get_size(), m_nalu_size_length);
+    memcpy(mem.get_buffer() + offset + m_nalu_size_length, nalu->get_buffer(), nalu->get_size());
+    offset += m_nalu_size_length + nalu->get_size();
+  }
+
+  m_incomplete_frame_nalus.clear();
 }
 
 void
@@ -1588,11 +1623,12 @@ es_parser_c::handle_slice_nalu(memory_cptr const &nalu) {
     flush_incomplete_frame();
 
   if (m_have_incomplete_frame) {
-    memory_c &mem = *(m_incomplete_frame.m_data.get());
-    int offset    = mem.get_size();
-    mem.resize(offset + m_nalu_size_length + nalu->get_size());
-    mtx::mpeg::write_nalu_size(mem.get_buffer() + offset, nalu->get_size(), m_nalu_size_length, m_ignore_nalu_size_length_errors);
-    memcpy(mem.get_buffer() + offset + m_nalu_size_length, nalu->get_buffer(), nalu->get_size());
+    // The size field is only written once the frame is complete, but
+    // NALUs too big for it must be reported right away.
+    unsigned char size_field[8];
+    mtx::mpeg::write_nalu_size(size_field, nalu->get_size(), m_nalu_size_length, m_ignore_nalu_size_length_errors);
+
+    m_incomplete_frame_nalus.push_back(nalu);
 
     return;
   }
@@ -2013,6 +2049,9 @@ es_parser_c::cleanup() {
     m_stats.num_frames_discarded    += m_frames.size();
     m_stats.num_timecodes_discarded += m_provided_timecodes.size();
 
+    for (auto const &frame : m_frames)
+      account_queued_frame(frame, false);
+
     m_frames.clear();
     m_provided_timecodes.clear();
     m_provided_stream_positions.clear();
@@ -2130,6 +2169,18 @@ es_parser_c::cleanup() {
   m_frames.clear();
 }
 
+// A frame's data isn't modified anymore once it has been queued.
+// Moving frames from m_frames to m_frames_out therefore doesn't change
+// the total.
+void
+es_parser_c::account_queued_frame(frame_t const &frame,
+                                  bool queued) {
+  auto num_bytes = static_cast<int64_t>(frame.m_data ? frame.m_data->get_size() : 0) * (queued ? 1 : -1);
+
+  s_frame_memory.add(num_bytes);
+  m_num_queued_frame_bytes += num_bytes;
+}
+
 memory_cptr
 es_parser_c::create_nalu_with_size(const memory_cptr &src,
                                    bool add_extra_data) {
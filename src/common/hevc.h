@@ -438,6 +438,7 @@ protected:
   int64_rational_c m_par;
 
   std::deque<frame_t> m_frames, m_frames_out;
+  int64_t m_num_queued_frame_bytes{};
   std::deque<int64_t> m_provided_timecodes;
   std::deque<uint64_t> m_provided_stream_positions;
   int64_t m_max_timecode;
@@ -457,6 +458,7 @@ protected:
   uint64_t m_stream_position, m_parsed_position;
 
   frame_t m_incomplete_frame;
+  std::vector<memory_cptr> m_incomplete_frame_nalus;
   bool m_have_incomplete_frame;
   std::deque<memory_cptr> m_unhandled_nalus;
 
@@ -515,6 +517,8 @@ public:
     frame_t frame(*m_frames_out.begin());
     m_frames_out.erase(m_frames_out.begin(), m_frames_out.begin() + 1);
 
+    account_queued_frame(frame, false);
+
     return frame;
   }
 
@@ -588,7 +592,9 @@ protected:
   void handle_sei_nalu(memory_cptr const &nalu);
   void handle_slice_nalu(memory_cptr const &nalu);
   void cleanup();
+  void account_queued_frame(frame_t const &frame, bool queued);
   void flush_incomplete_frame();
+  void add_nalus_to_incomplete_frame();
   void flush_unhandled_nalus();
   memory_cptr create_nalu_with_size(const memory_cptr &src, bool add_extra_data = false);
   static void init_nalu_names();
@@ -14,6 +14,9 @@
 #include "common/common_pch.h"
 
 #include <algorithm>
+#if !defined(SYS_WINDOWS)
+# include <sys/stat.h>
+#endif
 
 #include <ebml/EbmlHead.h>
 #include <ebml/EbmlStream.h>
@@ -24,14 +27,18 @@
 #include <matroska/KaxTags.h>
 
 #include "common/bitvalue.h"
+#include "common/checksums/base.h"
 #include "common/construct.h"
 #include "common/ebml.h"
 #include "common/endian.h"
 #include "common/error.h"
+#include "common/fs_sys_helpers.h"
+#include "common/json.h"
 #include "common/list_utils.h"
 #include "common/kax_analyzer.h"
 #include "common/mm_io_x.h"
 #include "common/strings/editing.h"
+#include "common/strings/formatting.h"
 
 using namespace libebml;
 using namespace libmatroska;
@@ -40,6 +47,8 @@ using namespace libmatroska;
 
 #define CONSOLE_PERCENTAGE_WIDTH 25
 
+#define INDEX_CACHE_VERSION 2
+
 bool
 operator <(const kax_analyzer_data_cptr &d1,
            const kax_analyzer_data_cptr &d2) {
@@ -245,6 +254,12 @@ kax_analyzer_c::set_parser_start_position(uint64_t position) {
   return *this;
 }
 
+kax_analyzer_c &
+kax_analyzer_c::set_use_index_cache(bool use_index_cache) {
+  m_use_index_cache = use_index_cache;
+  return *this;
+}
+
 bool
 kax_analyzer_c::process() {
   try {
@@ -309,6 +324,13 @@ kax_analyzer_c::process_internal() {
   m_segment_end        = m_segment->IsFiniteSize() ? m_segment->GetElementPosition() + m_segment->HeadSize() + m_segment->GetSize() : m_file->get_size();
   EbmlElement *l1      = nullptr;
 
+  // A valid index cache entry for this file saves us from having to
+  // locate all level 1 elements again.
+  if (m_use_index_cache && !m_parser_start_position && load_index_cache()) {
+    show_progress_done();
+    return true;
+  }
+
   // In certain situations the caller doesn't way to have to pay the
   // price for full analysis. Then it can configure the parser to
   // start parsing at a certain offset. EbmlStream::FindNextElement()
@@ -353,6 +375,9 @@ kax_analyzer_c::process_internal() {
     if (parse_mode_full != m_parse_mode)
       fix_element_sizes(file_size);
 
+    if (!m_parser_start_position)
+      save_index_cache();
+
     return true;
   }
 
@@ -431,6 +456,8 @@ kax_analyzer_c::update_element(EbmlElement *e,
     call_and_validate(add_to_meta_seek(e),                        "update_element_6");
     call_and_validate(merge_void_elements(),                      "update_element_7");
 
+    save_index_cache();
+
   } catch (kax_analyzer_c::update_element_result_e result) {
     debug_dump_elements_maybe("update_element_exception");
     return result;
@@ -455,6 +482,8 @@ kax_analyzer_c::remove_elements(EbmlId const &id) {
     call_and_validate(remove_from_meta_seeks(id),                 "remove_elements_4");
     call_and_validate(merge_void_elements(),                      "remove_elements_5");
 
+    save_index_cache();
+
   } catch (kax_analyzer_c::update_element_result_e result) {
     debug_dump_elements_maybe("update_element_exception");
     return result;
@@ -1449,6 +1478,12 @@ kax_analyzer_c::get_segment_data_start_pos()
   return m_segment->GetElementPosition() + m_segment->HeadSize();
 }
 
+uint64_t
+kax_analyzer_c::get_segment_end()
+  const {
+  return m_segment_end;
+}
+
 bitvalue_cptr
 kax_analyzer_c::read_segment_uid_from(std::string const &file_name) {
   try {
@@ -1481,6 +1516,165 @@ kax_analyzer_c::read_segment_uid_from(std::string const &file_name) {
   throw mtx::kax_analyzer_x{boost::format(Y("No segment UID could be found in the file '%1%'.")) % file_name};
 }
 
+bfs::path
+kax_analyzer_c::get_index_cache_file_name()
+  const {
+  auto data_folder = mtx::sys::get_application_data_folder();
+  if (data_folder.empty())
+    return {};
+
+  auto path = bfs::absolute(bfs::path{m_file_name}).string();
+  auto hash = mtx::checksum::calculate(mtx::checksum::algorithm_e::md5, path.c_str(), path.length());
+
+  return data_folder / "kax_analyzer_index_cache" / (to_hex(hash, true) + ".json");
+}
+
+std::string
+kax_analyzer_c::read_segment_uid_for_index_cache() {
+  auto idx = find(EBML_ID(KaxInfo));
+  if (-1 == idx)
+    return {};
+
+  auto element      = read_element(idx);
+  auto segment_info = dynamic_cast<KaxInfo *>(element.get());
+  auto segment_uid  = segment_info ? FindChild<KaxSegmentUID>(segment_info) : nullptr;
+
+  return segment_uid ? to_hex(*segment_uid, true) : std::string{};
+}
+
+/** \brief Identify the file's current content for the index cache
+
+    File systems or APIs with a timestamp resolution of one second
+    cannot detect a modification of the same size made within the
+    same second. Therefore the identity consists of the modification
+    time in nanoseconds and the device and inode numbers where
+    available, and of an MD5 checksum over the file's first and last
+    64 KB.
+ */
+std::string
+kax_analyzer_c::get_file_identity_for_index_cache() {
+  auto identity = std::string{};
+
+#if defined(SYS_WINDOWS)
+  identity = (boost::format("%1%") % static_cast<int64_t>(bfs::last_write_time(bfs::path{m_file_name}))).str();
+#else
+  struct stat st;
+  if (::stat(m_file_name.c_str(), &st) != 0)
+    throw mtx::mm_io::open_x{std::error_code{errno, std::system_category()}};
+
+# if defined(SYS_APPLE)
+  auto const &mtime = st.st_mtimespec;
+# else
+  auto const &mtime = st.st_mtim;
+# endif
+
+  identity = (boost::format("%1%:%2%:%3%.%4%") % st.st_dev % st.st_ino % mtime.tv_sec % mtime.tv_nsec).str();
+#endif
+
+  auto const chunk_size = uint64_t{64 * 1024};
+  auto file_size        = m_file->get_size();
+  auto previous_pos     = m_file->getFilePointer();
+  auto head_size        = std::min(file_size, chunk_size);
+  auto tail_size        = std::min(file_size - head_size, chunk_size);
+  auto buffer           = memory_c::alloc(head_size + tail_size);
+
+  m_file->setFilePointer(0);
+  m_file->read(buffer->get_buffer(), head_size);
+  m_file->setFilePointer(file_size - tail_size);
+  m_file->read(buffer->get_buffer() + head_size, tail_size);
+  m_file->setFilePointer(previous_pos);
+
+  return identity + ":" + to_hex(mtx::checksum::calculate(mtx::checksum::algorithm_e::md5, *buffer), true);
+}
+
+/** \brief Replace the level 1 element index with one read from the cache
+
+    The cache entry is only used if it was written for the same file
+    size, file identity (see \c get_file_identity_for_index_cache())
+    and segment position. Additionally the
+    segment UID recorded in the cache must match the one stored in the
+    segment information element the cached index points to. Verifying
+    that only requires reading that single element.
+
+    \return \c true if \c m_data has been filled from a valid cache
+      entry and \c false otherwise.
+ */
+bool
+kax_analyzer_c::load_index_cache() {
+  auto cache_file_name = get_index_cache_file_name();
+  if (cache_file_name.empty() || !bfs::exists(cache_file_name))
+    return false;
+
+  try {
+    auto content = mm_file_io_c::slurp(cache_file_name.string());
+    auto cache   = mtx::json::parse(std::string{reinterpret_cast<char const *>(content->get_buffer()), content->get_size()});
+
+    if (   (cache.value("version",           0)           != INDEX_CACHE_VERSION)
+        || (cache.value("file_size",         int64_t{-1}) != static_cast<int64_t>(m_file->get_size()))
+        || (cache.value("file_identity",     std::string{}) != get_file_identity_for_index_cache())
+        || (cache.value("segment_position",  int64_t{-1}) != static_cast<int64_t>(m_segment->GetElementPosition()))
+        || ((parse_mode_full == m_parse_mode) && !cache.value("parsed_fully", false))) {
+      mxdebug_if(m_debug, boost::format("kax_analyzer: index cache %1% is outdated\n") % cache_file_name.string());
+      return false;
+    }
+
+    for (auto const &element : cache["elements"])
+      m_data.push_back(kax_analyzer_data_c::create(EbmlId{element[0].get<uint32_t>(), element[1].get<unsigned int>()}, element[2].get<uint64_t>(), element[3].get<int64_t>(), element[4].get<bool>()));
+
+    if (read_segment_uid_for_index_cache() == cache.value("segment_uid", std::string{})) {
+      mxdebug_if(m_debug, boost::format("kax_analyzer: using index cache %1% with %2% entries\n") % cache_file_name.string() % m_data.size());
+      return true;
+    }
+
+    mxdebug_if(m_debug, boost::format("kax_analyzer: segment UID mismatch in index cache %1%\n") % cache_file_name.string());
+
+  } catch (...) {
+    mxdebug_if(m_debug, boost::format("kax_analyzer: index cache %1% could not be read\n") % cache_file_name.string());
+  }
+
+  m_data.clear();
+
+  return false;
+}
+
+void
+kax_analyzer_c::save_index_cache() {
+  if (!m_use_index_cache || !m_segment)
+    return;
+
+  auto cache_file_name = get_index_cache_file_name();
+  if (cache_file_name.empty())
+    return;
+
+  try {
+    // The file identity must be determined after all pending writes
+    // have reached the file.
+    m_file->flush();
+
+    auto elements = nlohmann::json::array();
+    for (auto const &data : m_data)
+      elements.push_back(nlohmann::json::array({ EBML_ID_VALUE(data->m_id), EBML_ID_LENGTH(data->m_id), data->m_pos, data->m_size, data->m_size_known }));
+
+    auto cache = nlohmann::json{
+      { "version",           INDEX_CACHE_VERSION                                                   },
+      { "file_size",         static_cast<int64_t>(m_file->get_size())                              },
+      { "file_identity",     get_file_identity_for_index_cache()                                   },
+      { "segment_position",  static_cast<int64_t>(m_segment->GetElementPosition())                 },
+      { "segment_uid",       read_segment_uid_for_index_cache()                                    },
+      { "parsed_fully",      parse_mode_full == m_parse_mode                                       },
+      { "elements",          elements                                                              },
+    };
+
+    mm_file_io_c out{cache_file_name.string(), MODE_CREATE};
+    out.write(mtx::json::dump(cache));
+
+    mxdebug_if(m_debug, boost::format("kax_analyzer: index cache %1% written with %2% entries\n") % cache_file_name.string() % m_data.size());
+
+  } catch (...) {
+    mxdebug_if(m_debug, boost::format("kax_analyzer: index cache %1% could not be written\n") % cache_file_name.string());
+  }
+}
+
 int
 kax_analyzer_c::find(EbmlId const &id) {
   for (int idx = 0, end = m_data.size(); idx < end; idx++)
@@ -107,7 +107,7 @@ private:
   debugging_option_c m_debug{"kax_analyzer"};
   parse_mode_e m_parse_mode{parse_mode_full};
   open_mode m_open_mode{MODE_WRITE};
-  bool m_throw_on_error{};
+  bool m_throw_on_error{}, m_use_index_cache{};
   boost::optional<uint64_t> m_parser_start_position;
 
 public:                         // Static functions
@@ -133,11 +133,13 @@ public:
 
   virtual uint64_t get_segment_pos() const;
   virtual uint64_t get_segment_data_start_pos() const;
+  virtual uint64_t get_segment_end() const;
 
   virtual kax_analyzer_c &set_parse_mode(parse_mode_e parse_mode);
   virtual kax_analyzer_c &set_open_mode(open_mode mode);
   virtual kax_analyzer_c &set_throw_on_error(bool throw_on_error);
   virtual kax_analyzer_c &set_parser_start_position(uint64_t position);
+  virtual kax_analyzer_c &set_use_index_cache(bool use_index_cache);
 
   virtual bool process();
 
@@ -201,6 +203,12 @@ protected:
   virtual void fix_element_sizes(uint64_t file_size);
   virtual void fix_unknown_size_for_last_level1_element();
 
+  virtual bfs::path get_index_cache_file_name() const;
+  virtual std::string get_file_identity_for_index_cache();
+  virtual std::string read_segment_uid_for_index_cache();
+  virtual bool load_index_cache();
+  virtual void save_index_cache();
+
 protected:
   virtual bool process_internal();
 };
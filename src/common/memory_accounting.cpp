@@ -0,0 +1,123 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   accounting for the memory held by queues and buffers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <mutex>
+
+#include "common/memory_accounting.h"
+
+namespace mtx { namespace memory_accounting {
+
+namespace {
+
+std::atomic<int64_t> s_current{}, s_peak{}, s_limit{};
+
+void
+update_peak(std::atomic<int64_t> &peak,
+            int64_t value) {
+  auto previous = peak.load();
+  while ((previous < value) && !peak.compare_exchange_weak(previous, value))
+    ;
+}
+
+// Components are referenced from objects that may be destroyed while
+// the program exits. Therefore the registry is never freed.
+struct registry_t {
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<component_c>> m_components;
+};
+
+registry_t &
+registry() {
+  static auto s_registry = new registry_t;
+  return *s_registry;
+}
+
+}
+
+component_c::component_c(std::string const &name)
+  : m_name{name}
+{
+}
+
+void
+component_c::add(int64_t num_bytes) {
+  update_peak(m_peak, m_current += num_bytes);
+  update_peak(s_peak, s_current += num_bytes);
+}
+
+void
+component_c::remove(int64_t num_bytes) {
+  m_current -= num_bytes;
+  s_current -= num_bytes;
+}
+
+component_c &
+component(std::string const &name) {
+  auto &reg = registry();
+  std::lock_guard<std::mutex> lock{reg.m_mutex};
+
+  for (auto const &existing : reg.m_components)
+    if (existing->get_name() == name)
+      return *existing;
+
+  reg.m_components.emplace_back(std::make_unique<component_c>(name));
+
+  return *reg.m_components.back();
+}
+
+std::vector<component_c const *>
+components() {
+  auto &reg = registry();
+  std::lock_guard<std::mutex> lock{reg.m_mutex};
+
+  auto result = std::vector<component_c const *>{};
+  for (auto const &existing : reg.m_components)
+    result.push_back(existing.get());
+
+  return result;
+}
+
+int64_t
+get_current() {
+  return s_current;
+}
+
+int64_t
+get_peak() {
+  return s_peak;
+}
+
+/** \brief Sets the number of bytes all components may hold together
+
+   A limit of 0 means unlimited. Reaching the limit doesn't fail any
+   allocation; it only tells the producers to pause where they can.
+*/
+void
+set_limit(int64_t limit) {
+  s_limit = std::max<int64_t>(limit, 0);
+}
+
+int64_t
+get_limit() {
+  return s_limit;
+}
+
+bool
+limit_reached() {
+  auto limit = s_limit.load();
+  return limit && (s_current >= limit);
+}
+
+}}
@@ -0,0 +1,64 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   accounting for the memory held by queues and buffers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MEMORY_ACCOUNTING_H
+#define MTX_COMMON_MEMORY_ACCOUNTING_H
+
+#include "common/common_pch.h"
+
+#include <atomic>
+
+namespace mtx { namespace memory_accounting {
+
+/** \brief Memory held by one kind of queue or buffer
+
+   All instances of a queue type share one component, e.g. all
+   packetizers' packet queues. Components are created on first use
+   with \c component() and live until the program exits. Adding and
+   removing bytes is thread-safe.
+*/
+class component_c {
+protected:
+  std::string const m_name;
+  std::atomic<int64_t> m_current{}, m_peak{};
+
+public:
+  explicit component_c(std::string const &name);
+
+  void add(int64_t num_bytes);
+  void remove(int64_t num_bytes);
+
+  std::string const &get_name() const {
+    return m_name;
+  }
+  int64_t get_current() const {
+    return m_current;
+  }
+  int64_t get_peak() const {
+    return m_peak;
+  }
+};
+
+component_c &component(std::string const &name);
+std::vector<component_c const *> components();
+
+int64_t get_current();
+int64_t get_peak();
+
+void set_limit(int64_t limit);
+int64_t get_limit();
+bool limit_reached();
+
+}}
+
+#endif // MTX_COMMON_MEMORY_ACCOUNTING_H
@@ -22,6 +22,9 @@
 #endif
 #include <sys/stat.h>
 #include <sys/types.h>
+#if !defined(SYS_WINDOWS)
+# include <fcntl.h>
+#endif
 
 #include "common/endian.h"
 #include "common/error.h"
@@ -37,25 +40,55 @@ union double_to_uint64_t {
 };
 
 #if !defined(SYS_WINDOWS)
+namespace {
+
+// Reads and writes of at least this size bypass the file's own buffer.
+std::size_t const s_file_buffer_size   = 64 * 1024;
+
+// O_DIRECT requires the buffer address, the file position and the
+// size to be multiples of the file system's block size.
+std::size_t const s_direct_alignment   = 4096;
+std::size_t const s_direct_buffer_size = 4 * 1024 * 1024;
+
+int64_t const s_page_cache_chunk_size  = 16 * 1024 * 1024;
+
+}
+
 mm_file_io_c::mm_file_io_c(const std::string &path,
-                           const open_mode mode)
+                           const open_mode mode,
+                           unsigned int flags)
   : m_file_name(path)
-  , m_file(nullptr)
+  , m_fd(-1)
+  , m_direct_fd(-1)
+  , m_eof(false)
+  , m_seekable(true)
+  , m_writable(false)
+  , m_buffer_pos(0)
+  , m_buffer_fill(0)
+  , m_buffer_dirty(false)
+  , m_direct_buffer(nullptr)
+  , m_direct_pos(-1)
+  , m_direct_fill(0)
+  , m_uncached_read_start(-1)
+  , m_uncached_write_start(-1)
+  , m_uncached_write_end(-1)
+  , m_previous_write_chunk_start(-1)
+  , m_avoid_page_cache(flags & FLAG_AVOID_PAGE_CACHE)
 {
-  const char *cmode;
+  int open_flags;
 
   switch (mode) {
     case MODE_READ:
-      cmode = "rb";
+      open_flags = O_RDONLY;
       break;
     case MODE_WRITE:
-      cmode = "r+b";
+      open_flags = O_RDWR;
       break;
     case MODE_CREATE:
-      cmode = "w+b";
+      open_flags = O_RDWR | O_CREAT | O_TRUNC;
       break;
     case MODE_SAFE:
-      cmode = "rb";
+      open_flags = O_RDONLY;
       break;
     default:
       throw mtx::invalid_parameter_x();
@@ -69,70 +102,442 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
   if ((0 == stat(local_path.c_str(), &st)) && S_ISDIR(st.st_mode))
     throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
 
-  m_file = (FILE *)fopen(local_path.c_str(), cmode);
+  m_fd = ::open(local_path.c_str(), open_flags, 0666);
 
-  if (!m_file)
+  if (-1 == m_fd)
     throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
+
+  m_writable = O_RDONLY != open_flags;
+  m_seekable = (0 == fstat(m_fd, &st)) && (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode));
+
+#if defined(HAVE_POSIX_FADVISE)
+  if (m_avoid_page_cache && m_seekable && !m_writable)
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+#if defined(O_DIRECT)
+  // Data that cannot be written with O_DIRECT (partial blocks at the
+  // end or writes after seeking) is written through m_fd.
+  if ((flags & FLAG_DIRECT_OUTPUT) && m_seekable && m_writable)
+    m_direct_fd = ::open(local_path.c_str(), O_WRONLY | O_DIRECT);
+
+  if (-1 != m_direct_fd) {
+    m_af_direct_buffer = memory_c::alloc(s_direct_buffer_size + s_direct_alignment);
+    auto address       = reinterpret_cast<uintptr_t>(m_af_direct_buffer->get_buffer());
+    m_direct_buffer    = m_af_direct_buffer->get_buffer() + (s_direct_alignment - address % s_direct_alignment) % s_direct_alignment;
+  }
+#endif
 }
 
 void
 mm_file_io_c::setFilePointer(int64 offset,
                              seek_mode mode) {
-  int whence = mode == seek_beginning ? SEEK_SET
-             : mode == seek_end       ? SEEK_END
-             :                          SEEK_CUR;
+  int64_t base = 0;
+
+  if (seek_current == mode)
+    base = m_current_position;
+
+  else if ((seek_end == mode) && !m_seekable) {
+    // Everything written so far is the end of the stream.
+    if (!m_writable) {
+      errno = ESPIPE;
+      throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+    }
+    base = m_current_position;
+
+  } else if (seek_end == mode) {
+    struct stat st;
+    if (0 != fstat(m_fd, &st))
+      throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+
+    // Buffered data hasn't reached the file yet.
+    base = st.st_size;
+    if (m_buffer_dirty)
+      base = std::max<int64_t>(base, m_buffer_pos + m_buffer_fill);
+    if (-1 != m_direct_pos)
+      base = std::max<int64_t>(base, m_direct_pos + m_direct_fill);
+  }
 
-  if (fseeko((FILE *)m_file, offset, whence) != 0)
+  int64_t new_position = base + offset;
+  if (0 > new_position) {
+    errno = EINVAL;
     throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+  }
+
+  // Without seeking only data that is still in the buffer can be
+  // read again.
+  if (   !m_seekable
+      && (new_position != static_cast<int64_t>(m_current_position))
+      && (   m_buffer_dirty
+          || (new_position < m_buffer_pos)
+          || (new_position > static_cast<int64_t>(m_buffer_pos + m_buffer_fill)))) {
+    errno = ESPIPE;
+    throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+  }
+
+  if (m_buffer_dirty && (new_position != static_cast<int64_t>(m_buffer_pos + m_buffer_fill)))
+    flush_buffer();
 
-  m_current_position = ftello((FILE *)m_file);
+  m_current_position = new_position;
+  m_eof              = false;
+}
+
+std::size_t
+mm_file_io_c::read_at(unsigned char *buffer,
+                      std::size_t size,
+                      int64_t position) {
+  std::size_t total = 0;
+
+  while (total < size) {
+    auto num_read = m_seekable ? ::pread(m_fd, buffer + total, size - total, position + total) : ::read(m_fd, buffer + total, size - total);
+    if ((-1 == num_read) && (EINTR == errno))
+      continue;
+    if (0 >= num_read)
+      break;
+
+    total += num_read;
+  }
+
+  drop_from_page_cache(position, total, false);
+
+  return total;
+}
+
+void
+mm_file_io_c::write_at(int fd,
+                       unsigned char const *buffer,
+                       std::size_t size,
+                       int64_t position) {
+  std::size_t total = 0;
+
+  while (total < size) {
+    auto num_written = m_seekable ? ::pwrite(fd, buffer + total, size - total, position + total) : ::write(fd, buffer + total, size - total);
+    if ((-1 == num_written) && (EINTR == errno))
+      continue;
+
+    if (0 == num_written)
+      errno = ENOSPC;
+    if (0 >= num_written)
+      throw mtx::mm_io::read_write_x{mtx::mm_io::make_error_code()};
+
+    total += num_written;
+  }
+
+  if (fd == m_fd)
+    drop_from_page_cache(position, size, true);
 }
 
 size_t
 mm_file_io_c::_write(const void *buffer,
                      size_t size) {
-  size_t bwritten = fwrite(buffer, 1, size, (FILE *)m_file);
-  if (ferror((FILE *)m_file) != 0)
-    throw mtx::mm_io::read_write_x{mtx::mm_io::make_error_code()};
+  if (!size)
+    return 0;
+
+  auto source   = static_cast<unsigned char const *>(buffer);
+  m_cached_size = -1;
+
+  // Data read ahead might be outdated now.
+  if (!m_buffer_dirty)
+    m_buffer_fill = 0;
+
+  if (-1 != m_direct_fd) {
+    write_direct(source, size);
+    return size;
+  }
+
+  if (   m_buffer_dirty
+      && (   (static_cast<int64_t>(m_buffer_pos + m_buffer_fill) != m_current_position)
+          || ((m_buffer_fill + size) > s_file_buffer_size)))
+    flush_buffer();
+
+  if (size >= s_file_buffer_size)
+    write_at(m_fd, source, size, m_current_position);
+
+  else {
+    if (!m_buffer)
+      m_buffer = memory_c::alloc(s_file_buffer_size);
+
+    if (!m_buffer_dirty) {
+      m_buffer_pos   = m_current_position;
+      m_buffer_dirty = true;
+    }
+
+    std::memcpy(m_buffer->get_buffer() + m_buffer_fill, source, size);
+    m_buffer_fill += size;
+  }
+
+  m_current_position += size;
+
+  return size;
+}
+
+/** \brief Collects data in the aligned staging area
+
+   Full staging areas are written with O_DIRECT. If the data doesn't
+   continue where the staging area ends then the area is written
+   normally, and a new one is started at the block containing the
+   current position. The part of that block before the current
+   position is read from the file first.
+*/
+void
+mm_file_io_c::write_direct(unsigned char const *buffer,
+                           std::size_t size) {
+  while (size) {
+    if (-1 == m_direct_fd) {
+      _write(buffer, size);
+      return;
+    }
+
+    if ((-1 == m_direct_pos) || ((m_direct_pos + static_cast<int64_t>(m_direct_fill)) != m_current_position)) {
+      flush_direct_buffer();
+
+      m_direct_pos  = m_current_position - (m_current_position % s_direct_alignment);
+      m_direct_fill = m_current_position - m_direct_pos;
+
+      if (m_direct_fill) {
+        auto num_read = read_at(m_direct_buffer, m_direct_fill, m_direct_pos);
+        std::memset(m_direct_buffer + num_read, 0, m_direct_fill - num_read);
+      }
+    }
+
+    auto num_bytes = std::min(size, s_direct_buffer_size - m_direct_fill);
+
+    std::memcpy(m_direct_buffer + m_direct_fill, buffer, num_bytes);
+    m_direct_fill      += num_bytes;
+    m_current_position += num_bytes;
+    buffer             += num_bytes;
+    size               -= num_bytes;
+
+    if (m_direct_fill < s_direct_buffer_size)
+      continue;
+
+    std::size_t total = 0;
+    while (total < m_direct_fill) {
+      auto num_written = ::pwrite(m_direct_fd, m_direct_buffer + total, m_direct_fill - total, m_direct_pos + total);
+      if ((-1 == num_written) && (EINTR == errno))
+        continue;
+      if (0 >= num_written)
+        break;
+      total += num_written;
+    }
 
-  m_current_position += bwritten;
-  m_cached_size       = -1;
+    // Not all file systems support O_DIRECT. Continue without it.
+    if (total != m_direct_fill) {
+      ::close(m_direct_fd);
+      m_direct_fd = -1;
+      flush_direct_buffer();
+      continue;
+    }
+
+    m_direct_pos  += m_direct_fill;
+    m_direct_fill  = 0;
+  }
+}
+
+void
+mm_file_io_c::flush_buffer() {
+  if (!m_buffer_dirty)
+    return;
+
+  // Reset first so that a failing write isn't retried when the file
+  // is closed.
+  auto fill      = m_buffer_fill;
+  m_buffer_dirty = false;
+  m_buffer_fill  = 0;
+
+  write_at(m_fd, m_buffer->get_buffer(), fill, m_buffer_pos);
+}
+
+void
+mm_file_io_c::flush_direct_buffer() {
+  if (-1 == m_direct_pos)
+    return;
+
+  auto position = m_direct_pos;
+  auto fill     = m_direct_fill;
+  m_direct_pos  = -1;
+  m_direct_fill = 0;
+
+  if (fill)
+    write_at(m_fd, m_direct_buffer, fill, position);
+}
+
+/** \brief Removes data that is streamed once from the page cache
+
+   Only done for files opened with \c FLAG_AVOID_PAGE_CACHE. Source files
+   are dropped behind the reading position in chunks. Destination
+   files are handled in chunks, too: the kernel starts writing back a
+   chunk when it is dropped. Its dirty pages stay in the cache until
+   they have been written, though. Therefore the previous chunk is
+   dropped again at the same time.
+*/
+void
+mm_file_io_c::drop_from_page_cache(int64_t position,
+                                   std::size_t size,
+                                   bool written) {
+#if defined(HAVE_POSIX_FADVISE)
+  if (!m_avoid_page_cache || !size)
+    return;
+
+  int64_t end = position + size;
+
+  if (!written) {
+    if ((-1 == m_uncached_read_start) || (position < m_uncached_read_start))
+      m_uncached_read_start = position;
+
+    if ((end - m_uncached_read_start) >= s_page_cache_chunk_size) {
+      posix_fadvise(m_fd, m_uncached_read_start, end - m_uncached_read_start, POSIX_FADV_DONTNEED);
+      m_uncached_read_start = end;
+    }
+
+    return;
+  }
 
-  return bwritten;
+  if (position != m_uncached_write_end) {
+    m_uncached_write_start       = position;
+    m_previous_write_chunk_start = -1;
+  }
+
+  m_uncached_write_end = end;
+
+  if ((m_uncached_write_end - m_uncached_write_start) < s_page_cache_chunk_size)
+    return;
+
+  posix_fadvise(m_fd, m_uncached_write_start, m_uncached_write_end - m_uncached_write_start, POSIX_FADV_DONTNEED);
+  if (-1 != m_previous_write_chunk_start)
+    posix_fadvise(m_fd, m_previous_write_chunk_start, m_uncached_write_start - m_previous_write_chunk_start, POSIX_FADV_DONTNEED);
+
+  m_previous_write_chunk_start = m_uncached_write_start;
+  m_uncached_write_start       = m_uncached_write_end;
+
+#else
+  (void)position;
+  (void)size;
+  (void)written;
+#endif
 }
 
 uint32
 mm_file_io_c::_read(void *buffer,
                     size_t size) {
-  int64_t bread = fread(buffer, 1, size, (FILE *)m_file);
+  flush_direct_buffer();
+  flush_buffer();
 
-  m_current_position += bread;
+  auto destination  = static_cast<unsigned char *>(buffer);
+  std::size_t total = 0;
 
-  return bread;
+  while (total < size) {
+    int64_t buffer_end = m_buffer_pos + m_buffer_fill;
+
+    if (m_buffer_fill && (m_current_position >= m_buffer_pos) && (m_current_position < buffer_end)) {
+      auto num_bytes = std::min<std::size_t>(size - total, buffer_end - m_current_position);
+      std::memcpy(destination + total, m_buffer->get_buffer() + (m_current_position - m_buffer_pos), num_bytes);
+
+      total              += num_bytes;
+      m_current_position += num_bytes;
+      continue;
+    }
+
+    if ((size - total) >= s_file_buffer_size) {
+      // Streams cannot go back to the buffered data afterwards.
+      if (!m_seekable)
+        m_buffer_fill = 0;
+
+      auto num_read       = read_at(destination + total, size - total, m_current_position);
+      total              += num_read;
+      m_current_position += num_read;
+      break;
+    }
+
+    if (!m_buffer)
+      m_buffer = memory_c::alloc(s_file_buffer_size);
+
+    m_buffer_pos  = m_current_position;
+    m_buffer_fill = read_at(m_buffer->get_buffer(), s_file_buffer_size, m_buffer_pos);
+
+    if (!m_buffer_fill)
+      break;
+  }
+
+  if (total < size)
+    m_eof = true;
+
+  return total;
 }
 
 void
 mm_file_io_c::close() {
-  if (m_file) {
-    fclose((FILE *)m_file);
-    m_file = nullptr;
+  if (-1 == m_fd)
+    return;
+
+  // Like fclose() before errors aren't reported here. Callers that
+  // care call flush() first.
+  try {
+    flush_buffer();
+    flush_direct_buffer();
+  } catch (mtx::mm_io::exception &) {
   }
+
+#if defined(HAVE_POSIX_FADVISE)
+  if (m_avoid_page_cache) {
+    if (-1 != m_uncached_write_end)
+      fdatasync(m_fd);
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_DONTNEED);
+  }
+#endif
+
+  if (-1 != m_direct_fd)
+    ::close(m_direct_fd);
+  ::close(m_fd);
+
+  m_fd        = -1;
+  m_direct_fd = -1;
 }
 
 bool
 mm_file_io_c::eof() {
-  return feof((FILE *)m_file) != 0;
+  return m_eof;
 }
 
 void
 mm_file_io_c::clear_eof() {
-  clearerr(static_cast<FILE *>(m_file));
+  m_eof = false;
+}
+
+void
+mm_file_io_c::flush() {
+  flush_buffer();
+  flush_direct_buffer();
 }
 
 int
 mm_file_io_c::truncate(int64_t pos) {
+  flush();
+
+  m_buffer_fill = 0;
   m_cached_size = -1;
-  return ftruncate(fileno((FILE *)m_file), pos);
+
+  return ftruncate(m_fd, pos);
+}
+
+/** \brief Reserve disk space for the file without changing its size
+
+   The space is allocated beyond the current end of file so that
+   \c get_size() and seeking relative to the end keep working as
+   before. Space that remains unused can be released by truncating the
+   file to its final size.
+
+   \return \c true if the file system supports preallocation and the
+     space could be reserved.
+*/
+bool
+mm_file_io_c::preallocate(int64_t size) {
+#if defined(HAVE_FALLOCATE)
+  return 0 == fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, size);
+#else
+  (void)size;
+  return false;
+#endif
 }
 
 /** \brief OS and kernel dependant setup
@@ -181,8 +586,9 @@ mm_file_io_c::cleanup() {
 
 mm_io_cptr
 mm_file_io_c::open(const std::string &path,
-                   const open_mode mode) {
-  return mm_io_cptr(new mm_file_io_c(path, mode));
+                   const open_mode mode,
+                   unsigned int flags) {
+  return mm_io_cptr(new mm_file_io_c(path, mode, flags));
 }
 
 /*
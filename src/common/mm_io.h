@@ -83,6 +83,9 @@ public:
   virtual int truncate(int64_t) {
     return 0;
   }
+  virtual bool preallocate(int64_t /* size */) {
+    return false;
+  }
 
   virtual std::string get_file_name() const = 0;
 
@@ -122,14 +125,47 @@ protected:
 class mm_file_io_c: public mm_io_c {
 protected:
   std::string m_file_name;
-  void *m_file;
 
 #if defined(SYS_WINDOWS)
+  void *m_file;
   bool m_eof;
+
+#else
+  int m_fd, m_direct_fd;
+  bool m_eof;
+
+  // Pipes, FIFOs and terminals don't support pread()/pwrite() or
+  // seeking. They're read and written sequentially.
+  bool m_seekable, m_writable;
+
+  // Reads and writes smaller than the buffer are collected in
+  // m_buffer. Bigger ones are passed to the kernel directly.
+  memory_cptr m_buffer;
+  int64_t m_buffer_pos;
+  std::size_t m_buffer_fill;
+  bool m_buffer_dirty;
+
+  // Aligned staging area for writing with O_DIRECT.
+  memory_cptr m_af_direct_buffer;
+  unsigned char *m_direct_buffer;
+  int64_t m_direct_pos;
+  std::size_t m_direct_fill;
+
+  // Ranges that are to be removed from the page cache.
+  int64_t m_uncached_read_start, m_uncached_write_start, m_uncached_write_end, m_previous_write_chunk_start;
+  bool m_avoid_page_cache;
 #endif
 
 public:
-  mm_file_io_c(const std::string &path, const open_mode mode = MODE_READ);
+  // Only meant for the files a program streams through once, not for
+  // temporary files. Ignored on Windows.
+  enum flags_e {
+    FLAG_AVOID_PAGE_CACHE = 0x01, // drop streamed data from the page cache
+    FLAG_DIRECT_OUTPUT    = 0x02, // write with O_DIRECT where available
+  };
+
+public:
+  mm_file_io_c(const std::string &path, const open_mode mode = MODE_READ, unsigned int flags = 0);
   virtual ~mm_file_io_c();
 
   static void prepare_path(const std::string &path);
@@ -143,20 +179,35 @@ public:
   virtual void close();
   virtual bool eof();
   virtual void clear_eof();
+#if !defined(SYS_WINDOWS)
+  virtual void flush();
+#endif
 
   virtual std::string get_file_name() const {
     return m_file_name;
   }
 
   virtual int truncate(int64_t pos);
+#if !defined(SYS_WINDOWS)
+  virtual bool preallocate(int64_t size);
+#endif
 
   static void setup();
   static void cleanup();
-  static mm_io_cptr open(const std::string &path, const open_mode mode = MODE_READ);
+  static mm_io_cptr open(const std::string &path, const open_mode mode = MODE_READ, unsigned int flags = 0);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+
+#if !defined(SYS_WINDOWS)
+  std::size_t read_at(unsigned char *buffer, std::size_t size, int64_t position);
+  void write_at(int fd, unsigned char const *buffer, std::size_t size, int64_t position);
+  void write_direct(unsigned char const *buffer, std::size_t size);
+  void flush_buffer();
+  void flush_direct_buffer();
+  void drop_from_page_cache(int64_t position, std::size_t size, bool written);
+#endif
 };
 
 using mm_file_io_cptr = std::shared_ptr<mm_file_io_c>;
@@ -188,6 +239,12 @@ public:
   virtual bool eof() {
     return m_proxy_io->eof();
   }
+  virtual bool preallocate(int64_t size) {
+    return m_proxy_io->preallocate(size);
+  }
+  virtual void flush() {
+    m_proxy_io->flush();
+  }
   virtual void close();
   virtual std::string get_file_name() const {
     return m_proxy_io->get_file_name();
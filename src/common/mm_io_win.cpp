@@ -35,7 +35,8 @@
 #include "common/strings/utf8.h"
 
 mm_file_io_c::mm_file_io_c(const std::string &path,
-                           const open_mode mode)
+                           const open_mode mode,
+                           unsigned int /* flags */)
   : m_file_name(path)
   , m_file(nullptr)
   , m_eof(false)
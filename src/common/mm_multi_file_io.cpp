@@ -33,7 +33,8 @@ mm_multi_file_io_c::file_t::file_t(const bfs::path &file_name,
 }
 
 mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
-                                       const std::string &display_file_name)
+                                       const std::string &display_file_name,
+                                       unsigned int flags)
   : m_display_file_name(display_file_name)
   , m_total_size(0)
   , m_current_pos(0)
@@ -41,7 +42,7 @@ mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
   , m_current_file(0)
 {
   for (auto &file_name : file_names) {
-    mm_file_io_cptr file(new mm_file_io_c(file_name.string()));
+    mm_file_io_cptr file(new mm_file_io_c(file_name.string(), MODE_READ, flags));
     m_files.push_back(mm_multi_file_io_c::file_t(file_name, m_total_size, file));
 
     m_total_size += file->get_size();
@@ -192,7 +193,8 @@ struct path_sorter_t {
 
 mm_io_cptr
 mm_multi_file_io_c::open_multi(const std::string &display_file_name,
-                               bool single_only) {
+                               bool single_only,
+                               unsigned int flags) {
   bfs::path first_file_name(bfs::system_complete(bfs::path(display_file_name)));
   std::string base_name = bfs::basename(first_file_name);
   std::string extension = balg::to_lower_copy(bfs::extension(first_file_name));
@@ -202,7 +204,7 @@ mm_multi_file_io_c::open_multi(const std::string &display_file_name,
   if (!boost::regex_match(base_name, matches, file_name_re) || single_only) {
     std::vector<bfs::path> file_names;
     file_names.push_back(first_file_name);
-    return mm_io_cptr(new mm_multi_file_io_c(file_names, display_file_name));
+    return mm_io_cptr(new mm_multi_file_io_c(file_names, display_file_name, flags));
   }
 
   int start_number = 1;
@@ -237,5 +239,5 @@ mm_multi_file_io_c::open_multi(const std::string &display_file_name,
   for (auto &path : paths)
     file_names.push_back(path.m_path);
 
-  return mm_io_cptr(new mm_multi_file_io_c(file_names, display_file_name));
+  return mm_io_cptr(new mm_multi_file_io_c(file_names, display_file_name, flags));
 }
@@ -42,7 +42,7 @@ protected:
   std::vector<mm_multi_file_io_c::file_t> m_files;
 
 public:
-  mm_multi_file_io_c(const std::vector<bfs::path> &file_names, const std::string &display_file_name);
+  mm_multi_file_io_c(const std::vector<bfs::path> &file_names, const std::string &display_file_name, unsigned int flags = 0);
   virtual ~mm_multi_file_io_c();
 
   virtual uint64 getFilePointer();
@@ -58,7 +58,7 @@ public:
   virtual void display_other_file_info();
   virtual void enable_buffering(bool enable);
 
-  static mm_io_cptr open_multi(const std::string &display_file_name, bool single_only = false);
+  static mm_io_cptr open_multi(const std::string &display_file_name, bool single_only = false, unsigned int flags = 0);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
@@ -0,0 +1,311 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/memory_accounting.h"
+#include "common/mm_io_x.h"
+#include "common/mm_read_ahead_io.h"
+#include "common/mm_read_buffer_io.h"
+
+std::size_t const mm_read_ahead_io_c::s_initial_read_size;
+std::size_t const mm_read_ahead_io_c::s_max_block_size;
+debugging_option_c mm_read_ahead_io_c::ms_debug{"read_ahead_io"};
+
+static auto &s_block_memory = mtx::memory_accounting::component("read-ahead buffers");
+
+mm_read_ahead_io_c::mm_read_ahead_io_c(mm_io_c *in,
+                                       std::size_t block_size,
+                                       std::size_t queue_depth,
+                                       bool delete_in)
+  : mm_proxy_io_c{in, delete_in}
+  , m_block_size{block_size}
+  , m_queue_depth{std::max<std::size_t>(queue_depth, 1)}
+  , m_size{in->get_size()}
+  , m_read_pos{in->getFilePointer()}
+  , m_read_size{std::min(s_initial_read_size, block_size)}
+{
+  m_current.m_offset = m_read_pos;
+  m_thread           = std::make_unique<std::thread>(&mm_read_ahead_io_c::run, this);
+}
+
+mm_read_ahead_io_c::~mm_read_ahead_io_c() {
+  close();
+
+  s_block_memory.remove(m_num_allocated_bytes);
+}
+
+/** \brief Wraps an input in a read-ahead proxy
+
+   \c buffer_size is the maximum number of bytes kept read ahead. It is
+   split into blocks of up to 1 MB. If it is 0 then the input is only
+   buffered and read synchronously.
+*/
+mm_io_c *
+mm_read_ahead_io_c::open(mm_io_c *in,
+                         std::size_t buffer_size,
+                         bool delete_in) {
+  static debugging_option_c s_synchronous_input{"synchronous_input"};
+
+  if (s_synchronous_input || !buffer_size)
+    return new mm_read_buffer_io_c{in, 1 << 17, delete_in};
+
+  auto block_size = std::min(buffer_size, s_max_block_size);
+
+  return new mm_read_ahead_io_c{in, block_size, buffer_size / block_size, delete_in};
+}
+
+void
+mm_read_ahead_io_c::close() {
+  stop_worker();
+  mm_proxy_io_c::close();
+}
+
+void
+mm_read_ahead_io_c::stop_worker() {
+  if (!m_thread)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop_requested = true;
+  }
+
+  m_space_available.notify_all();
+  m_thread->join();
+  m_thread.reset();
+}
+
+uint64
+mm_read_ahead_io_c::getFilePointer() {
+  return m_current.m_offset + m_cursor;
+}
+
+int64_t
+mm_read_ahead_io_c::get_size() {
+  return m_size;
+}
+
+void
+mm_read_ahead_io_c::setFilePointer(int64 offset,
+                                   seek_mode mode) {
+  int64_t new_pos
+    = seek_beginning == mode ? offset
+    : seek_end       == mode ? m_size                                 + offset // offsets from the end are negative already
+    :                          static_cast<int64_t>(getFilePointer()) + offset;
+
+  m_eof = false;
+
+  auto in_current = new_pos - static_cast<int64_t>(m_current.m_offset);
+  if ((0 <= in_current) && (in_current <= static_cast<int64_t>(m_current.m_fill))) {
+    m_cursor = in_current;
+    return;
+  }
+
+  if ((0 <= new_pos) && seek_within_queue(new_pos))
+    return;
+
+  restart_at(new_pos);
+}
+
+bool
+mm_read_ahead_io_c::seek_within_queue(uint64_t position) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+
+  auto itr = brng::find_if(m_blocks, [position](block_t const &block) {
+    return (block.m_offset <= position) && (position < (block.m_offset + block.m_fill));
+  });
+
+  if (itr == m_blocks.end())
+    return false;
+
+  recycle(m_current);
+  for (auto skipped = m_blocks.begin(); skipped != itr; ++skipped)
+    recycle(*skipped);
+
+  m_current = std::move(*itr);
+  m_cursor  = position - m_current.m_offset;
+  m_blocks.erase(m_blocks.begin(), itr + 1);
+
+  m_space_available.notify_one();
+
+  return true;
+}
+
+void
+mm_read_ahead_io_c::restart_at(int64_t position) {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  // Nothing else may touch the proxied input while a read is in flight.
+  m_paused = true;
+  m_block_available.wait(lock, [this]() { return !m_reading; });
+
+  auto previous_pos = m_read_pos;
+
+  try {
+    m_proxy_io->setFilePointer(position, seek_beginning);
+
+  } catch (...) {
+    m_paused = false;
+    m_space_available.notify_one();
+    throw;
+  }
+
+  recycle(m_current);
+  for (auto &block : m_blocks)
+    recycle(block);
+  m_blocks.clear();
+
+  m_read_pos         = m_proxy_io->getFilePointer();
+  m_current          = block_t{};
+  m_current.m_offset = m_read_pos;
+  m_cursor           = 0;
+  m_wanted_depth     = 0;
+  m_read_size        = std::min(s_initial_read_size, m_block_size);
+  m_worker_eof       = false;
+  m_exception        = nullptr;
+  m_paused           = false;
+
+  mxdebug_if(ms_debug, boost::format("restarting read-ahead at %1% (previously at %2%)\n") % m_read_pos % previous_pos);
+}
+
+void
+mm_read_ahead_io_c::recycle(block_t &block) {
+  if (block.m_data)
+    m_free_buffers.push_back(std::move(block.m_data));
+}
+
+bool
+mm_read_ahead_io_c::take_next_block() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  auto position = m_current.m_offset + m_current.m_fill;
+
+  recycle(m_current);
+  m_current          = block_t{};
+  m_current.m_offset = position;
+  m_cursor           = 0;
+
+  // Each block consumed sequentially doubles the number of blocks
+  // read ahead.
+  m_wanted_depth = std::min(std::max<std::size_t>(m_wanted_depth * 2, 1), m_queue_depth);
+  m_space_available.notify_one();
+
+  m_block_available.wait(lock, [this]() { return !m_blocks.empty() || m_worker_eof; });
+
+  if (m_blocks.empty()) {
+    if (m_exception) {
+      auto exception = m_exception;
+      m_exception    = nullptr;
+      std::rethrow_exception(exception);
+    }
+
+    return false;
+  }
+
+  m_current = std::move(m_blocks.front());
+  m_blocks.pop_front();
+
+  m_space_available.notify_one();
+
+  return true;
+}
+
+void
+mm_read_ahead_io_c::run() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  while (true) {
+    m_space_available.wait(lock, [this]() {
+      return m_stop_requested || (!m_paused && !m_worker_eof && (m_blocks.size() < m_wanted_depth));
+    });
+
+    if (m_stop_requested)
+      return;
+
+    auto block     = block_t{};
+    block.m_offset = m_read_pos;
+    auto size      = m_read_size;
+
+    if (m_free_buffers.empty()) {
+      block.m_data           = memory_c::alloc(m_block_size);
+      m_num_allocated_bytes += m_block_size;
+      s_block_memory.add(m_block_size);
+
+    } else {
+      block.m_data = std::move(m_free_buffers.back());
+      m_free_buffers.pop_back();
+    }
+
+    m_reading = true;
+    lock.unlock();
+
+    auto exception = std::exception_ptr{};
+
+    try {
+      block.m_fill = m_proxy_io->read(block.m_data->get_buffer(), size);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+
+    lock.lock();
+    m_reading = false;
+
+    mxdebug_if(ms_debug, boost::format("read at %1% for %2% returned %3%; queued blocks: %4%/%5%\n") % block.m_offset % size % block.m_fill % m_blocks.size() % m_wanted_depth);
+
+    m_read_pos  += block.m_fill;
+    m_read_size  = std::min(m_read_size * 2, m_block_size);
+
+    if (exception || (block.m_fill < size)) {
+      m_worker_eof = true;
+      m_exception  = exception;
+    }
+
+    if (block.m_fill)
+      m_blocks.push_back(std::move(block));
+    else
+      recycle(block);
+
+    m_block_available.notify_all();
+  }
+}
+
+uint32
+mm_read_ahead_io_c::_read(void *buffer,
+                          size_t size) {
+  auto dest      = static_cast<unsigned char *>(buffer);
+  auto remaining = size;
+
+  while (remaining) {
+    auto avail = std::min(remaining, m_current.m_fill - m_cursor);
+
+    if (avail) {
+      std::memcpy(dest, m_current.m_data->get_buffer() + m_cursor, avail);
+      dest      += avail;
+      remaining -= avail;
+      m_cursor  += avail;
+
+    } else if (!take_next_block()) {
+      m_eof = true;
+      break;
+    }
+  }
+
+  return size - remaining;
+}
+
+size_t
+mm_read_ahead_io_c::_write(const void *,
+                           size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x();
+}
@@ -0,0 +1,108 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_READ_AHEAD_IO_H
+#define MTX_COMMON_MM_READ_AHEAD_IO_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "common/mm_io.h"
+
+/** \brief Reads from the proxied input in a background thread
+
+   A worker thread keeps up to \c queue_depth blocks of \c block_size
+   bytes read ahead of the current position. The consumer takes over
+   completed blocks in order and serves all reads from them without
+   locking. Seeking to a position that is still buffered is free;
+   other seeks wait for the read currently in flight, reposition the
+   proxied input and restart the read-ahead.
+
+   After each seek the read-ahead starts with small reads and a
+   single block. Both are doubled with each block consumed
+   sequentially so that probing with scattered reads doesn't read
+   much more data than plain buffering would.
+
+   The proxied input must not be accessed by anyone else while it is
+   wrapped.
+
+   All blocks allocated are accounted for in the "read-ahead buffers"
+   memory accounting component until the proxy is destroyed.
+*/
+class mm_read_ahead_io_c: public mm_proxy_io_c {
+protected:
+  struct block_t {
+    memory_cptr m_data;
+    uint64_t m_offset{};
+    std::size_t m_fill{};
+  };
+
+  std::size_t const m_block_size, m_queue_depth;
+  int64_t m_size;
+
+  // Only used by the consuming thread.
+  block_t m_current;
+  std::size_t m_cursor{};
+  bool m_eof{};
+
+  // Shared with the worker thread; protected by m_mutex.
+  std::mutex m_mutex;
+  std::condition_variable m_block_available, m_space_available;
+  std::deque<block_t> m_blocks;
+  std::vector<memory_cptr> m_free_buffers;
+  uint64_t m_read_pos{};
+  std::size_t m_wanted_depth{}, m_read_size{};
+  int64_t m_num_allocated_bytes{};
+  bool m_worker_eof{}, m_reading{}, m_paused{}, m_stop_requested{};
+  std::exception_ptr m_exception;
+  std::unique_ptr<std::thread> m_thread;
+
+  static std::size_t const s_initial_read_size = 128  * 1024;
+  static std::size_t const s_max_block_size    = 1024 * 1024;
+  static debugging_option_c ms_debug;
+
+public:
+  mm_read_ahead_io_c(mm_io_c *in, std::size_t block_size = 1024 * 1024, std::size_t queue_depth = 8, bool delete_in = true);
+  virtual ~mm_read_ahead_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual int64_t get_size();
+  virtual bool eof() {
+    return m_eof;
+  }
+  virtual void clear_eof() {
+    m_eof = false;
+  }
+  virtual void close();
+
+  static mm_io_c *open(mm_io_c *in, std::size_t buffer_size = 8 * 1024 * 1024, bool delete_in = true);
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+
+  bool take_next_block();
+  bool seek_within_queue(uint64_t position);
+  void restart_at(int64_t position);
+  void recycle(block_t &block);
+  void stop_worker();
+  void run();
+};
+
+#endif  // MTX_COMMON_MM_READ_AHEAD_IO_H
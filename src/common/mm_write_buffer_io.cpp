@@ -36,8 +36,9 @@ mm_write_buffer_io_c::~mm_write_buffer_io_c() {
 
 mm_io_cptr
 mm_write_buffer_io_c::open(const std::string &file_name,
-                           size_t buffer_size) {
-  return mm_io_cptr(new mm_write_buffer_io_c(new mm_file_io_c(file_name, MODE_CREATE), buffer_size));
+                           size_t buffer_size,
+                           unsigned int flags) {
+  return mm_io_cptr(new mm_write_buffer_io_c(new mm_file_io_c(file_name, MODE_CREATE, flags), buffer_size));
 }
 
 uint64
@@ -72,6 +73,12 @@ mm_write_buffer_io_c::flush() {
   mm_proxy_io_c::flush();
 }
 
+int
+mm_write_buffer_io_c::truncate(int64_t pos) {
+  flush_buffer();
+  return m_proxy_io->truncate(pos);
+}
+
 void
 mm_write_buffer_io_c::close() {
   flush_buffer();
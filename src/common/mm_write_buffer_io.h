@@ -34,10 +34,11 @@ public:
   virtual uint64 getFilePointer();
   virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
   virtual void flush();
+  virtual int truncate(int64_t pos);
   virtual void close();
   virtual void discard_buffer();
 
-  static mm_io_cptr open(const std::string &file_name, size_t buffer_size);
+  static mm_io_cptr open(const std::string &file_name, size_t buffer_size, unsigned int flags = 0);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
@@ -102,4 +102,68 @@ create_nalu_with_size(memory_cptr const &src,
   return buffer;
 }
 
+/** \brief Filter NALUs and re-write their size fields in a single pass
+
+   \c data consists of NALUs that are each prefixed with a size field
+   of \c src_nalu_size_length bytes. All NALUs for which \c remove_nalu
+   returns \c true when called with their first byte are dropped. The
+   size fields of the remaining NALUs are written with \c
+   dst_nalu_size_length bytes.
+
+   The NALUs are compacted in place unless the size fields grow, in
+   which case a new buffer is allocated once.
+
+   Throws \c nalu_size_length_x if a NALU is too big for the new size
+   field length.
+*/
+memory_cptr
+remove_nalus_and_change_nalu_size_len(memory_cptr const &data,
+                                         std::size_t src_nalu_size_length,
+                                         std::size_t dst_nalu_size_length,
+                                         std::function<bool(unsigned char)> const &remove_nalu) {
+  auto src  = data->get_buffer();
+  auto size = data->get_size();
+
+  if (!src || !size || !src_nalu_size_length || !dst_nalu_size_length)
+    return data;
+
+  auto dst_data = data;
+
+  if (dst_nalu_size_length > src_nalu_size_length) {
+    auto num_nalus = std::size_t{};
+
+    for (auto pos = std::size_t{}; (pos + src_nalu_size_length) <= size; ++num_nalus)
+      pos += src_nalu_size_length + std::min<uint64_t>(get_uint_be(&src[pos], src_nalu_size_length), size - pos - src_nalu_size_length);
+
+    dst_data = memory_c::alloc(size + num_nalus * (dst_nalu_size_length - src_nalu_size_length));
+  }
+
+  auto dst     = dst_data->get_buffer();
+  auto src_pos = std::size_t{};
+  auto dst_pos = std::size_t{};
+
+  while ((src_pos + src_nalu_size_length) <= size) {
+    auto nalu_size  = std::min<uint64_t>(get_uint_be(&src[src_pos], src_nalu_size_length), size - src_pos - src_nalu_size_length);
+    src_pos        += src_nalu_size_length;
+
+    if (!nalu_size || !remove_nalu(src[src_pos])) {
+      write_nalu_size(&dst[dst_pos], nalu_size, dst_nalu_size_length);
+      std::memmove(&dst[dst_pos + dst_nalu_size_length], &src[src_pos], nalu_size);
+      dst_pos += dst_nalu_size_length + nalu_size;
+    }
+
+    src_pos += nalu_size;
+  }
+
+  // Keep incomplete trailing data if the size fields aren't changed.
+  if ((src_pos < size) && (src_nalu_size_length == dst_nalu_size_length)) {
+    std::memmove(&dst[dst_pos], &src[src_pos], size - src_pos);
+    dst_pos += size - src_pos;
+  }
+
+  dst_data->resize(dst_pos);
+
+  return dst_data;
+}
+
 }}
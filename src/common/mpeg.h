@@ -46,6 +46,7 @@ memory_cptr rbsp_to_nalu(memory_cptr const &buffer);
 
 void write_nalu_size(unsigned char *buffer, std::size_t size, std::size_t nalu_size_length, bool ignore_nalu_size_length_errors = false);
 memory_cptr create_nalu_with_size(memory_cptr const &src, std::size_t nalu_size_length, std::vector<memory_cptr> extra_data);
+memory_cptr remove_nalus_and_change_nalu_size_len(memory_cptr const &data, std::size_t src_nalu_size_length, std::size_t dst_nalu_size_length, std::function<bool(unsigned char)> const &remove_nalu);
 
 }}
 
@@ -23,6 +23,7 @@
 #include "common/endian.h"
 #include "common/frame_timing.h"
 #include "common/hacks.h"
+#include "common/memory_accounting.h"
 #include "common/mm_io.h"
 #include "common/mpeg.h"
 #include "common/mpeg4_p10.h"
@@ -33,6 +34,7 @@ namespace p10 {
 
 static auto s_debug_fix_bistream_timing_info = debugging_option_c{"fix_bitstream_timing_info"};
 static auto s_debug_remove_bistream_ar_info  = debugging_option_c{"remove_bitstream_ar_info"};
+static auto &s_frame_memory                  = mtx::memory_accounting::component("AVC/h.264 parser");
 
 avcc_c::avcc_c()
   : m_profile_idc{}
@@ -876,6 +878,8 @@ mpeg4::p10::avc_es_parser_c::avc_es_parser_c()
 }
 
 mpeg4::p10::avc_es_parser_c::~avc_es_parser_c() {
+  s_frame_memory.remove(m_num_queued_frame_bytes);
+
   mxdebug_if(debugging_c::requested("avc_statistics"),
              boost::format("AVC statistics: #frames: out %1% discarded %2% #timecodes: in %3% generated %4% discarded %5% num_fields: %6% num_frames: %7% num_sei_nalus: %8% num_idr_slices: %9%\n")
              % m_stats.num_frames_out   % m_stats.num_frames_discarded % m_stats.num_timecodes_in % m_stats.num_timecodes_generated % m_stats.num_timecodes_discarded
@@ -1011,6 +1015,8 @@ mpeg4::p10::avc_es_parser_c::flush() {
   if (m_have_incomplete_frame) {
     m_frames.push_back(m_incomplete_frame);
     m_have_incomplete_frame = false;
+
+    account_queued_frame(m_frames.back(), true);
   }
 
   cleanup();
@@ -1069,6 +1075,8 @@ mpeg4::p10::avc_es_parser_c::flush_incomplete_frame() {
   m_frames.push_back(m_incomplete_frame);
   m_incomplete_frame.clear();
   m_have_incomplete_frame = false;
+
+  account_queued_frame(m_frames.back(), true);
 }
 
 void
@@ -1546,6 +1554,9 @@ mpeg4::p10::avc_es_parser_c::cleanup() {
     m_stats.num_frames_discarded    += m_frames.size();
     m_stats.num_timecodes_discarded += m_provided_timecodes.size();
 
+    for (auto const &frame : m_frames)
+      account_queued_frame(frame, false);
+
     m_frames.clear();
     m_provided_timecodes.clear();
     m_provided_stream_positions.clear();
@@ -1643,6 +1654,22 @@ mpeg4::p10::avc_es_parser_c::cleanup() {
   m_frames.clear();
 }
 
+/** \brief Reports a frame entering or leaving the queues of frames
+   waiting for reordering or output
+
+   A frame's data isn't modified anymore once it has been queued.
+   Moving frames from \c m_frames to \c m_frames_out therefore doesn't
+   change the total.
+*/
+void
+mpeg4::p10::avc_es_parser_c::account_queued_frame(avc_frame_t const &frame,
+                                                  bool queued) {
+  auto num_bytes = static_cast<int64_t>(frame.m_data ? frame.m_data->get_size() : 0) * (queued ? 1 : -1);
+
+  s_frame_memory.add(num_bytes);
+  m_num_queued_frame_bytes += num_bytes;
+}
+
 memory_cptr
 mpeg4::p10::avc_es_parser_c::create_nalu_with_size(const memory_cptr &src,
                                                    bool add_extra_data) {
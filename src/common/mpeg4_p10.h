@@ -235,6 +235,7 @@ protected:
   int64_rational_c m_par;
 
   std::deque<avc_frame_t> m_frames, m_frames_out;
+  int64_t m_num_queued_frame_bytes{};
   std::deque<int64_t> m_provided_timecodes;
   std::deque<uint64_t> m_provided_stream_positions;
   int64_t m_max_timecode, m_previous_frame_start_in_display_order;
@@ -316,6 +317,8 @@ public:
     avc_frame_t frame(*m_frames_out.begin());
     m_frames_out.erase(m_frames_out.begin(), m_frames_out.begin() + 1);
 
+    account_queued_frame(frame, false);
+
     return frame;
   }
 
@@ -391,6 +394,7 @@ protected:
   void handle_sei_nalu(memory_cptr const &nalu);
   void handle_slice_nalu(memory_cptr const &nalu);
   void cleanup();
+  void account_queued_frame(avc_frame_t const &frame, bool queued);
   bool flush_decision(slice_info_t &si, slice_info_t &ref);
   void flush_incomplete_frame();
   void flush_unhandled_nalus();
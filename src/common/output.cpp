@@ -22,6 +22,7 @@
 #include "common/locale.h"
 #include "common/logger.h"
 #include "common/mm_io.h"
+#include "common/output_channel.h"
 #include "common/strings/utf8.h"
 
 bool g_suppress_info              = false;
@@ -35,6 +36,7 @@ std::shared_ptr<mm_io_c> g_mm_stdio   = std::shared_ptr<mm_io_c>(new mm_stdio_c)
 
 static mxmsg_handler_t s_mxmsg_info_handler, s_mxmsg_warning_handler, s_mxmsg_error_handler;
 static std::vector<std::string> s_warnings_emitted, s_errors_emitted;
+static thread_local captured_messages_t *tl_captured_messages = nullptr;
 
 static nlohmann::json
 to_json_array(std::vector<std::string> const &messages) {
@@ -75,6 +77,8 @@ redirect_warnings_and_errors_to_json() {
 
 void
 redirect_stdio(const mm_io_cptr &stdio) {
+  mtx::output::flush_channel();
+
   g_mm_stdio            = stdio;
   s_mm_stdio_redirected = true;
   g_mm_stdio->set_string_output_converter(g_cc_stdio);
@@ -98,14 +102,11 @@ set_mxmsg_handler(unsigned int level,
     assert(false);
 }
 
-void
-mxmsg(unsigned int level,
-      std::string message) {
+static void
+write_message(unsigned int level,
+              std::string message) {
   static bool s_saw_cr_after_nl = false;
 
-  if (g_suppress_info && (MXMSG_INFO == level))
-    return;
-
   if ('\n' == message[0]) {
     message.erase(0, 1);
     g_mm_stdio->puts("\n");
@@ -136,6 +137,48 @@ mxmsg(unsigned int level,
   g_mm_stdio->flush();
 }
 
+/** \brief Collects the messages the current thread issues instead of
+   outputting them
+
+   Used by threads that work on behalf of the main thread, e.g. parser
+   threads. Neither the message handlers nor the state they update are
+   thread-safe. The collected messages must be passed to
+   \c replay_captured_messages() by the main thread. Errors are not
+   captured. Passing \c nullptr stops capturing.
+*/
+void
+capture_messages_of_current_thread(captured_messages_t *messages) {
+  tl_captured_messages = messages;
+}
+
+void
+replay_captured_messages(captured_messages_t const &messages) {
+  for (auto const &message : messages)
+    if (MXMSG_INFO == message.first)
+      mxinfo(message.second);
+    else if (MXMSG_WARNING == message.first)
+      mxwarn(message.second);
+    else
+      mxmsg(message.first, message.second);
+}
+
+void
+mxmsg(unsigned int level,
+      std::string message) {
+  if (tl_captured_messages) {
+    tl_captured_messages->emplace_back(level, std::move(message));
+    return;
+  }
+
+  if (g_suppress_info && (MXMSG_INFO == level))
+    return;
+
+  if (mtx::output::use_channel())
+    mtx::output::post_to_channel([level, message = std::move(message)]() { write_message(level, message); });
+  else
+    write_message(level, std::move(message));
+}
+
 static void
 default_mxinfo(unsigned int,
                std::string const &info) {
@@ -144,7 +187,10 @@ default_mxinfo(unsigned int,
 
 void
 mxinfo(std::string const &info) {
-  if (s_mxmsg_info_handler)
+  if (tl_captured_messages)
+    tl_captured_messages->emplace_back(MXMSG_INFO, info);
+
+  else if (s_mxmsg_info_handler)
     s_mxmsg_info_handler(MXMSG_INFO, info);
 }
 
@@ -171,7 +217,10 @@ default_mxwarn(unsigned int,
 
 void
 mxwarn(std::string const &warning) {
-  if (s_mxmsg_warning_handler)
+  if (tl_captured_messages)
+    tl_captured_messages->emplace_back(MXMSG_WARNING, warning);
+
+  else if (s_mxmsg_warning_handler)
     s_mxmsg_warning_handler(MXMSG_WARNING, warning);
 }
 
@@ -43,6 +43,10 @@ void display_json_output(nlohmann::json json);
 void init_common_output(bool no_charset_detection);
 void set_cc_stdio(const std::string &charset);
 
+using captured_messages_t = std::vector<std::pair<unsigned int, std::string>>;
+void capture_messages_of_current_thread(captured_messages_t *messages);
+void replay_captured_messages(captured_messages_t const &messages);
+
 void mxmsg(unsigned int level, std::string message);
 inline void
 mxmsg(unsigned int level,
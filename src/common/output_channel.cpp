@@ -0,0 +1,192 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   asynchronous output of messages
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/output_channel.h"
+
+namespace mtx { namespace output {
+
+namespace {
+
+thread_local bool tl_is_channel_thread = false;
+
+channel_c &
+get_channel() {
+  // Intentionally never destroyed: events might still be posted
+  // during the global destruction.
+  static auto s_channel = new channel_c;
+  return *s_channel;
+}
+
+}
+
+channel_c::channel_c()
+  : m_head{new node_t}
+  , m_tail{m_head.load()}
+{
+}
+
+channel_c::~channel_c() {
+  stop();
+
+  while (m_tail) {
+    auto next = m_tail->m_next.load();
+    delete m_tail;
+    m_tail = next;
+  }
+}
+
+bool
+channel_c::is_own_thread() {
+  return tl_is_channel_thread;
+}
+
+void
+channel_c::start() {
+  if (m_running)
+    return;
+
+  m_stop_requested = false;
+  m_thread         = std::make_unique<std::thread>(&channel_c::run, this);
+  m_running        = true;
+}
+
+void
+channel_c::stop() {
+  if (!m_running || is_own_thread())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop_requested = true;
+  }
+
+  m_wake_up.notify_one();
+  m_thread->join();
+  m_thread.reset();
+  m_running = false;
+
+  // Events posted by other threads while the background thread was
+  // shutting down.
+  process_events();
+}
+
+void
+channel_c::flush() {
+  if (!m_running || is_own_thread())
+    return;
+
+  auto wanted = m_num_posted.load();
+
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_wake_up.notify_one();
+  m_done.wait(lock, [this, wanted]() { return m_num_done >= wanted; });
+}
+
+void
+channel_c::post(std::function<void()> event) {
+  auto node     = new node_t;
+  node->m_event = std::move(event);
+
+  ++m_num_posted;
+
+  auto previous = m_head.exchange(node);
+  previous->m_next.store(node);
+
+  if (m_idle) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_wake_up.notify_one();
+  }
+}
+
+bool
+channel_c::process_events() {
+  auto processed = false;
+
+  while (true) {
+    auto next = m_tail->m_next.load();
+    if (!next)
+      break;
+
+    // The node just taken out of the queue remains as the new tail.
+    delete m_tail;
+    m_tail     = next;
+    auto event = std::move(next->m_event);
+
+    event();
+
+    ++m_num_done;
+    processed = true;
+  }
+
+  if (processed) {
+    { std::lock_guard<std::mutex> lock{m_mutex}; }
+    m_done.notify_all();
+  }
+
+  return processed;
+}
+
+void
+channel_c::run() {
+  tl_is_channel_thread = true;
+
+  while (true) {
+    process_events();
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    if (m_stop_requested && (m_num_posted == m_num_done))
+      break;
+
+    // A producer that has already counted its event but not linked it
+    // into the queue yet will be picked up on the next iteration.
+    m_idle = true;
+    m_wake_up.wait_for(lock, std::chrono::milliseconds{100}, [this]() { return m_stop_requested || (m_num_posted != m_num_done); });
+    m_idle = false;
+  }
+}
+
+// ------------------------------------------------------------
+
+void
+start_channel() {
+  static debugging_option_c s_synchronous_output{"synchronous_output"};
+
+  if (!s_synchronous_output)
+    get_channel().start();
+}
+
+void
+stop_channel() {
+  get_channel().stop();
+}
+
+void
+flush_channel() {
+  get_channel().flush();
+}
+
+bool
+use_channel() {
+  auto &channel = get_channel();
+  return channel.is_running() && !channel.is_own_thread();
+}
+
+void
+post_to_channel(std::function<void()> event) {
+  get_channel().post(std::move(event));
+}
+
+}}
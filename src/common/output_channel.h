@@ -0,0 +1,82 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   asynchronous output of messages
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_OUTPUT_CHANNEL_H
+#define MTX_COMMON_OUTPUT_CHANNEL_H
+
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mtx { namespace output {
+
+/** \brief Queue of output events executed by a background thread
+
+   Any number of threads may post events. Posting is lock-free: it
+   only swaps a pointer. The mutex is only locked in order to wake up
+   the background thread if it's idle. The events are executed in the
+   order they've been posted.
+
+   Each event is a function that does the actual formatting and
+   writing. Therefore the cost of formatting messages is moved from
+   the posting thread to the background thread.
+*/
+class channel_c {
+protected:
+  struct node_t {
+    std::atomic<node_t *> m_next{};
+    std::function<void()> m_event;
+  };
+
+  std::atomic<node_t *> m_head;
+  node_t *m_tail;
+
+  std::atomic<uint64_t> m_num_posted{}, m_num_done{};
+  std::atomic<bool> m_running{}, m_idle{}, m_stop_requested{};
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake_up, m_done;
+  std::unique_ptr<std::thread> m_thread;
+
+public:
+  channel_c();
+  ~channel_c();
+
+  void start();
+  void stop();
+  void flush();
+  void post(std::function<void()> event);
+
+  bool is_running() const {
+    return m_running;
+  }
+  static bool is_own_thread();
+
+protected:
+  void run();
+  bool process_events();
+};
+
+void start_channel();
+void stop_channel();
+void flush_channel();
+bool use_channel();
+void post_to_channel(std::function<void()> event);
+
+}}
+
+#endif  // MTX_COMMON_OUTPUT_CHANNEL_H
@@ -0,0 +1,172 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for PCM audio
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/pcm.h"
+#include "common/simd.h"
+
+#if defined(MTX_SIMD_X86)
+# include <immintrin.h>
+#endif
+
+namespace mtx { namespace pcm {
+
+namespace {
+
+#if defined(MTX_SIMD_X86)
+/** \brief Removes channels from as many whole frames as fit into 16 bytes
+
+   The shuffle mask gathers the channels to keep from all frames in a
+   16-byte block. Each store writes 16 bytes even though fewer are
+   valid; the following store overwrites the excess. Therefore \c src
+   and \c dst must not overlap.
+
+   \return The number of input bytes that have been processed.
+*/
+MTX_SIMD_TARGET("ssse3")
+std::size_t
+remove_channels_ssse3(unsigned char const *src,
+                      unsigned char *dst,
+                      std::size_t num_bytes,
+                      std::size_t input_frame_size,
+                      std::size_t output_frame_size) {
+  auto frames_per_block = 16 / input_frame_size;
+  if (!frames_per_block)
+    return 0;
+
+  auto input_block_size  = frames_per_block * input_frame_size;
+  auto output_block_size = frames_per_block * output_frame_size;
+  auto output_size       = num_bytes / input_frame_size * output_frame_size;
+
+  alignas(16) char mask_bytes[16];
+  for (auto idx = 0u; idx < 16; ++idx)
+    mask_bytes[idx] = static_cast<char>(idx < output_block_size ? (idx / output_frame_size) * input_frame_size + (idx % output_frame_size) : 0x80);
+
+  auto mask       = _mm_load_si128(reinterpret_cast<__m128i const *>(mask_bytes));
+  auto input_idx  = std::size_t{};
+  auto output_idx = std::size_t{};
+
+  while (((input_idx + 16) <= num_bytes) && ((output_idx + 16) <= output_size)) {
+    auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&src[input_idx]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[output_idx]), _mm_shuffle_epi8(block, mask));
+
+    input_idx  += input_block_size;
+    output_idx += output_block_size;
+  }
+
+  return input_idx;
+}
+#endif  // MTX_SIMD_X86
+
+template<std::size_t output_frame_size>
+void
+copy_frames(unsigned char const *src,
+            unsigned char *dst,
+            std::size_t num_frames,
+            std::size_t input_frame_size) {
+  // A fixed size lets the compiler replace memmove() with a few
+  // register moves. Moving forward is safe even if src == dst as the
+  // output never overtakes the input.
+  for (auto frame = 0u; frame < num_frames; ++frame) {
+    std::memmove(dst, src, output_frame_size);
+    src += input_frame_size;
+    dst += output_frame_size;
+  }
+}
+
+}
+
+/** \brief Removes trailing channels from each frame
+
+   Keeps the first \c num_output_channels channels of each frame of
+   interleaved samples and drops the rest. Incomplete frames at the end
+   are dropped, too. \c src and \c dst may be identical, but they must
+   not overlap otherwise.
+
+   \return The number of bytes written to \c dst.
+*/
+std::size_t
+remove_channels(unsigned char const *src,
+                unsigned char *dst,
+                std::size_t num_bytes,
+                std::size_t bytes_per_channel,
+                std::size_t num_input_channels,
+                std::size_t num_output_channels) {
+  auto input_frame_size  = bytes_per_channel * num_input_channels;
+  auto output_frame_size = bytes_per_channel * num_output_channels;
+  auto num_frames        = num_bytes / input_frame_size;
+  auto output_size       = num_frames * output_frame_size;
+
+#if defined(MTX_SIMD_X86)
+  if ((src != dst) && (mtx::simd::level_e::ssse3 <= mtx::simd::get_level())) {
+    auto num_done        = remove_channels_ssse3(src, dst, num_bytes, input_frame_size, output_frame_size);
+    auto num_done_frames = num_done / input_frame_size;
+
+    src        += num_done;
+    dst        += num_done_frames * output_frame_size;
+    num_frames -= num_done_frames;
+  }
+#endif
+
+  switch (output_frame_size) {
+    // The frame sizes of Blu-ray PCM with an odd number of channels
+    case  2: copy_frames< 2>(src, dst, num_frames, input_frame_size); break;
+    case  3: copy_frames< 3>(src, dst, num_frames, input_frame_size); break;
+    case  6: copy_frames< 6>(src, dst, num_frames, input_frame_size); break;
+    case  9: copy_frames< 9>(src, dst, num_frames, input_frame_size); break;
+    case 10: copy_frames<10>(src, dst, num_frames, input_frame_size); break;
+    case 14: copy_frames<14>(src, dst, num_frames, input_frame_size); break;
+    case 15: copy_frames<15>(src, dst, num_frames, input_frame_size); break;
+    case 21: copy_frames<21>(src, dst, num_frames, input_frame_size); break;
+
+    default:
+      for (auto frame = 0u; frame < num_frames; ++frame)
+        std::memmove(&dst[frame * output_frame_size], &src[frame * input_frame_size], output_frame_size);
+  }
+
+  return output_size;
+}
+
+/** \brief Returns whether \c remove_channels() should write into a separate buffer
+
+   Only the SSSE3 kernel cannot work in place. If it won't be used for
+   data of this layout and size then removing the channels in place
+   avoids allocating and filling a new buffer.
+*/
+bool
+remove_channels_needs_separate_buffer(std::size_t num_bytes,
+                                      std::size_t bytes_per_channel,
+                                      std::size_t num_input_channels,
+                                      std::size_t num_output_channels) {
+#if defined(MTX_SIMD_X86)
+  auto input_frame_size  = bytes_per_channel * num_input_channels;
+  auto output_frame_size = bytes_per_channel * num_output_channels;
+
+  return (0 < input_frame_size)
+      && (16 >= input_frame_size)
+      && (16 <= num_bytes)
+      && (16 <= (num_bytes / input_frame_size * output_frame_size))
+      && (mtx::simd::level_e::ssse3 <= mtx::simd::get_level());
+
+#else
+  (void)num_bytes;
+  (void)bytes_per_channel;
+  (void)num_input_channels;
+  (void)num_output_channels;
+
+  return false;
+#endif
+}
+
+}}
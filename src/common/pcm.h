@@ -0,0 +1,26 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for PCM audio
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_PCM_H
+#define MTX_COMMON_PCM_H
+
+#include "common/common_pch.h"
+
+namespace mtx { namespace pcm {
+
+std::size_t remove_channels(unsigned char const *src, unsigned char *dst, std::size_t num_bytes, std::size_t bytes_per_channel, std::size_t num_input_channels, std::size_t num_output_channels);
+bool remove_channels_needs_separate_buffer(std::size_t num_bytes, std::size_t bytes_per_channel, std::size_t num_input_channels, std::size_t num_output_channels);
+
+}}
+
+#endif  // MTX_COMMON_PCM_H
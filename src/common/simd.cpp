@@ -0,0 +1,60 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time detection of SIMD instruction sets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/simd.h"
+
+namespace mtx { namespace simd {
+
+namespace {
+
+level_e
+detect_level() {
+  auto level = level_e::none;
+
+#if defined(MTX_SIMD_X86)
+  __builtin_cpu_init();
+
+  level = __builtin_cpu_supports("avx2")  ? level_e::avx2
+        : __builtin_cpu_supports("ssse3") ? level_e::ssse3
+        : __builtin_cpu_supports("sse2")  ? level_e::sse2
+        :                                   level_e::none;
+#endif
+
+  mxdebug_if(debugging_c::requested("simd"), boost::format("simd: detected level %1%\n") % static_cast<int>(level));
+
+  return level;
+}
+
+level_e s_max_level = level_e::avx2;
+
+}
+
+level_e
+get_level() {
+  static auto s_detected_level = detect_level();
+
+  return std::min(s_detected_level, s_max_level);
+}
+
+/** \brief Limits the instruction sets used
+
+   Meant for testing all code paths on the same machine.
+*/
+void
+set_max_level(level_e max_level) {
+  s_max_level = max_level;
+}
+
+}}
@@ -0,0 +1,41 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time detection of SIMD instruction sets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_SIMD_H
+#define MTX_COMMON_SIMD_H
+
+#include "common/common_pch.h"
+
+// Kernels for specific instruction sets are compiled with GCC's/clang's
+// target attribute so that no special compiler flags are needed. Which
+// kernel is used is decided at run time.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define MTX_SIMD_X86 1
+# define MTX_SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace mtx { namespace simd {
+
+enum class level_e {
+  none,
+  sse2,
+  ssse3,
+  avx2,
+};
+
+level_e get_level();
+void set_max_level(level_e max_level);
+
+}}
+
+#endif  // MTX_COMMON_SIMD_H
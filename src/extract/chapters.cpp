@@ -34,12 +34,11 @@
 using namespace libmatroska;
 
 void
-extract_chapters(const std::string &file_name,
+extract_chapters(kax_analyzer_c &analyzer,
+                 mm_io_c &out,
                  bool chapter_format_simple,
-                 kax_analyzer_c::parse_mode_e parse_mode,
                  boost::optional<std::string> const &language_to_extract) {
-  auto analyzer           = open_and_analyze(file_name, parse_mode);
-  ebml_master_cptr master = analyzer->read_all(EBML_INFO(KaxChapters));
+  ebml_master_cptr master = analyzer.read_all(EBML_INFO(KaxChapters));
   if (!master)
     return;
 
@@ -49,8 +48,8 @@ extract_chapters(const std::string &file_name,
   fix_chapter_country_codes(*chapters);
 
   if (!chapter_format_simple)
-    mtx::xml::ebml_chapters_converter_c::write_xml(*chapters, *g_mm_stdio);
+    mtx::xml::ebml_chapters_converter_c::write_xml(*chapters, out);
 
   else
-    write_chapters_simple(*chapters, *g_mm_stdio.get(), language_to_extract);
+    write_chapters_simple(*chapters, out, language_to_extract);
 }
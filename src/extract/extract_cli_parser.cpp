@@ -13,6 +13,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/command_line.h"
 #include "common/ebml.h"
 #include "common/iso639.h"
 #include "common/strings/formatting.h"
@@ -50,6 +51,7 @@ extract_cli_parser_c::init_parser() {
   add_information(YT("mkvextract cuesheet <inname> [options]"));
   add_information(YT("mkvextract timecodes_v2 <inname> [TID1:out1 [TID2:out2 ...]]"));
   add_information(YT("mkvextract cues <inname> [options] [TID1:out1 [TID2:out2 ...]]"));
+  add_information(YT("mkvextract <mode1> <inname> [options] [spec1] [<mode2> [options] [spec2] ...]"));
   add_information(YT("mkvextract <-h|-V>"));
 
   add_separator();
@@ -57,6 +59,8 @@ extract_cli_parser_c::init_parser() {
   add_information(YT("The first word tells mkvextract what to extract. The second must be the source file. "
                      "There are few global options that can be used with all modes. "
                      "All other options depend on the mode."));
+  add_information(YT("Several modes can be combined in a single invocation. Each mode name starts a new set of options and extraction specifications. "
+                     "All of them are satisfied by reading the source file only once."));
 
   add_section_header(YT("Global options"));
   OPT("f|parse-fully",    set_parse_fully,      YT("Parse the whole file instead of relying on the index."));
@@ -126,6 +130,14 @@ extract_cli_parser_c::init_parser() {
 
   add_information(YT("mkvextract cues \"a movie.mkv\" 0:cues_track0.txt"));
 
+  add_section_header(YT("Combining modes"));
+  add_information(YT("The modes 'tags', 'chapters' and 'cuesheet' accept an output file name as their extraction specification. "
+                     "Without one their output is written to the standard output which at most one mode may use."));
+
+  add_section_header(YT("Example"));
+
+  add_information(YT("mkvextract tracks \"a movie.mkv\" 0:video.h264 timecodes_v2 0:timecodes_track0.txt cues 0:cues_track0.txt chapters chapters.xml"));
+
   add_separator();
 
   add_hook(cli_parser_c::ht_unknown_option, std::bind(&extract_cli_parser_c::set_mode_or_extraction_spec, this));
@@ -135,10 +147,12 @@ extract_cli_parser_c::init_parser() {
 
 void
 extract_cli_parser_c::assert_mode(options_c::extraction_mode_e mode) {
-  if      ((options_c::em_tracks   == mode) && (m_options.m_extraction_mode != mode))
+  auto current_mode = m_options.m_modes.empty() ? options_c::em_unknown : m_options.get_current_mode().m_extraction_mode;
+
+  if      ((options_c::em_tracks   == mode) && (current_mode != mode))
     mxerror(boost::format(Y("'%1%' is only allowed when extracting tracks.\n"))   % m_current_arg);
 
-  else if ((options_c::em_chapters == mode) && (m_options.m_extraction_mode != mode))
+  else if ((options_c::em_chapters == mode) && (current_mode != mode))
     mxerror(boost::format(Y("'%1%' is only allowed when extracting chapters.\n")) % m_current_arg);
 }
 
@@ -181,7 +195,7 @@ extract_cli_parser_c::set_fullraw() {
 void
 extract_cli_parser_c::set_simple() {
   assert_mode(options_c::em_chapters);
-  m_options.m_simple_chapter_format = true;
+  m_options.get_current_mode().m_simple_chapter_format = true;
 }
 
 void
@@ -192,7 +206,7 @@ extract_cli_parser_c::set_simple_language() {
   if (0 > language_idx)
     mxerror(boost::format(Y("'%1%' is neither a valid ISO639-2 nor a valid ISO639-1 code. See 'mkvmerge --list-languages' for a list of all languages and their respective ISO639-2 codes.\n")) % m_next_arg);
 
-  m_options.m_simple_chapter_language.reset(g_iso639_languages[language_idx].iso639_2_code);
+  m_options.get_current_mode().m_simple_chapter_language.reset(g_iso639_languages[language_idx].iso639_2_code);
 }
 
 void
@@ -205,12 +219,15 @@ extract_cli_parser_c::set_mode_or_extraction_spec() {
   else if (2 == m_num_unknown_args)
     m_options.m_file_name = m_current_arg;
 
+  else if (options_c::em_unknown != find_extraction_mode(m_current_arg))
+    set_extraction_mode();
+
   else
     add_extraction_spec();
 }
 
-void
-extract_cli_parser_c::set_extraction_mode() {
+options_c::extraction_mode_e
+extract_cli_parser_c::find_extraction_mode(std::string const &name) {
   static struct {
     const char *name;
     options_c::extraction_mode_e extraction_mode;
@@ -227,27 +244,54 @@ extract_cli_parser_c::set_extraction_mode() {
 
   int i;
   for (i = 0; s_mode_map[i].name; ++i)
-    if (m_current_arg == s_mode_map[i].name) {
-      m_options.m_extraction_mode = s_mode_map[i].extraction_mode;
-      return;
-    }
+    if (name == s_mode_map[i].name)
+      return s_mode_map[i].extraction_mode;
 
-  mxerror(boost::format(Y("Unknown mode '%1%'.\n")) % m_current_arg);
+  return options_c::em_unknown;
 }
 
 void
-extract_cli_parser_c::add_extraction_spec() {
-  if (   (options_c::em_tracks       != m_options.m_extraction_mode)
-      && (options_c::em_cues         != m_options.m_extraction_mode)
-      && (options_c::em_timecodes_v2 != m_options.m_extraction_mode)
-      && (options_c::em_attachments  != m_options.m_extraction_mode))
+extract_cli_parser_c::set_extraction_mode() {
+  auto extraction_mode = find_extraction_mode(m_current_arg);
+
+  if (options_c::em_unknown == extraction_mode)
+    mxerror(boost::format(Y("Unknown mode '%1%'.\n")) % m_current_arg);
+
+  for (auto const &mode : m_options.m_modes)
+    if (mode.m_extraction_mode == extraction_mode)
+      mxerror(boost::format(Y("The mode '%1%' has already been specified.\n")) % m_current_arg);
+
+  m_options.m_modes.emplace_back(extraction_mode);
+  m_used_tids.clear();
+  set_default_values();
+}
+
+void
+extract_cli_parser_c::set_output_file_name() {
+  auto &mode = m_options.get_current_mode();
+
+  if (!mode.m_output_file_name.empty())
     mxerror(boost::format(Y("Unrecognized command line option '%1%'.\n")) % m_current_arg);
 
+  mode.m_output_file_name = m_current_arg;
+}
+
+void
+extract_cli_parser_c::add_extraction_spec() {
+  auto &mode = m_options.get_current_mode();
+
+  if (   (options_c::em_tags     == mode.m_extraction_mode)
+      || (options_c::em_chapters == mode.m_extraction_mode)
+      || (options_c::em_cuesheet == mode.m_extraction_mode)) {
+    set_output_file_name();
+    return;
+  }
+
   boost::regex s_track_id_re("^(\\d+)(:(.+))?$", boost::regex::perl);
 
   boost::smatch matches;
   if (!boost::regex_search(m_current_arg, matches, s_track_id_re)) {
-    if (options_c::em_attachments == m_options.m_extraction_mode)
+    if (options_c::em_attachments == mode.m_extraction_mode)
       mxerror(boost::format(Y("Invalid attachment ID/file name specification in argument '%1%'.\n")) % m_current_arg);
     else
       mxerror(boost::format(Y("Invalid track ID/file name specification in argument '%1%'.\n")) % m_current_arg);
@@ -266,7 +310,7 @@ extract_cli_parser_c::add_extraction_spec() {
     output_file_name = matches[3].str();
 
   if (output_file_name.empty()) {
-    if (options_c::em_attachments == m_options.m_extraction_mode)
+    if (options_c::em_attachments == mode.m_extraction_mode)
       mxinfo(Y("No destination file name specified, will use attachment name.\n"));
     else
       mxerror(boost::format(Y("Missing destination file name in argument '%1%'.\n")) % m_current_arg);
@@ -277,7 +321,7 @@ extract_cli_parser_c::add_extraction_spec() {
   track.extract_cuesheet       = m_extract_cuesheet;
   track.extract_blockadd_level = m_extract_blockadd_level;
   track.target_mode            = m_target_mode;
-  m_options.m_tracks.push_back(track);
+  mode.m_tracks.push_back(track);
 
   set_default_values();
 }
@@ -288,5 +332,20 @@ extract_cli_parser_c::run() {
 
   parse_args();
 
+  if (m_options.m_modes.empty())
+    usage(2);
+
+  for (auto const &mode : m_options.m_modes)
+    if (   mode.m_tracks.empty()
+        && (   (options_c::em_tracks       == mode.m_extraction_mode)
+            || (options_c::em_timecodes_v2 == mode.m_extraction_mode)
+            || (options_c::em_attachments  == mode.m_extraction_mode)
+            || (options_c::em_cues         == mode.m_extraction_mode)))
+      mxerror(Y("Nothing to do.\n"));
+
+  auto num_stdout_modes = boost::count_if(m_options.m_modes, [](options_c::mode_options_c const &mode) { return mode.writes_to_stdout(); });
+  if (1 < num_stdout_modes)
+    mxerror(Y("Only one of the modes 'tags', 'chapters' and 'cuesheet' can write to the standard output. Please specify output file names for the others.\n"));
+
   return m_options;
 }
@@ -52,7 +52,10 @@ protected:
   void set_simple_language();
   void set_mode_or_extraction_spec();
   void set_extraction_mode();
+  void set_output_file_name();
   void add_extraction_spec();
+
+  static options_c::extraction_mode_e find_extraction_mode(std::string const &name);
 };
 
 #endif // MTX_EXTRACT_EXTRACT_CLI_PARSER_H
@@ -19,6 +19,7 @@
 #include "common/command_line.h"
 #include "common/mm_io.h"
 #include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
 #include "common/strings/parsing.h"
 #include "common/translation.h"
 #include "common/version.h"
@@ -104,36 +105,71 @@ setup(char **argv) {
   version_info = get_version_info("mkvextract", vif_full);
 }
 
-int
-main(int argc,
-     char **argv) {
-  setup(argv);
+static mm_io_cptr
+open_output_file(options_c::mode_options_c const &mode) {
+  if (mode.m_output_file_name.empty())
+    return g_mm_stdio;
 
-  options_c options = extract_cli_parser_c(command_line_utf8(argc, argv)).run();
+  try {
+    return mm_write_buffer_io_c::open(mode.m_output_file_name, 128 * 1024);
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % mode.m_output_file_name % ex);
+  }
+
+  return mm_io_cptr{};
+}
+
+// All modes that only need level 1 elements share one analyzer
+// instance. Track and timecode extraction are handled together during
+// a single sequential pass over all clusters afterwards.
+static void
+run_extraction(options_c &options) {
+  // Track and timecode extraction fall back to scanning the file if
+  // it cannot be analyzed. All other modes cannot work without the
+  // analyzer.
+  auto exit_on_error = options.needs_level1_elements();
+  auto analyzer      = open_and_analyze(options.m_file_name, options.m_parse_mode, exit_on_error);
+
+  if (!analyzer && exit_on_error)
+    show_error(Y("This file could not be opened or parsed.\n"));
+
+  std::vector<track_spec_t> track_specs, timecode_specs;
+
+  for (auto &mode : options.m_modes) {
+    if (options_c::em_tracks == mode.m_extraction_mode)
+      track_specs = mode.m_tracks;
 
-  if (options_c::em_tracks == options.m_extraction_mode)
-    extract_tracks(options.m_file_name, options.m_tracks, options.m_parse_mode);
+    else if (options_c::em_timecodes_v2 == mode.m_extraction_mode)
+      timecode_specs = mode.m_tracks;
 
-  else if (options_c::em_tags == options.m_extraction_mode)
-    extract_tags(options.m_file_name, options.m_parse_mode);
+    else if (options_c::em_tags == mode.m_extraction_mode)
+      extract_tags(*analyzer, *open_output_file(mode));
 
-  else if (options_c::em_attachments == options.m_extraction_mode)
-    extract_attachments(options.m_file_name, options.m_tracks, options.m_parse_mode);
+    else if (options_c::em_attachments == mode.m_extraction_mode)
+      extract_attachments(*analyzer, mode.m_tracks);
 
-  else if (options_c::em_chapters == options.m_extraction_mode)
-    extract_chapters(options.m_file_name, options.m_simple_chapter_format, options.m_parse_mode, options.m_simple_chapter_language);
+    else if (options_c::em_chapters == mode.m_extraction_mode)
+      extract_chapters(*analyzer, *open_output_file(mode), mode.m_simple_chapter_format, mode.m_simple_chapter_language);
+
+    else if (options_c::em_cues == mode.m_extraction_mode)
+      extract_cues(*analyzer, mode.m_tracks);
+
+    else if (options_c::em_cuesheet == mode.m_extraction_mode)
+      extract_cuesheet(*analyzer, options.m_file_name, *open_output_file(mode));
+  }
 
-  else if (options_c::em_cues == options.m_extraction_mode)
-    extract_cues(options.m_file_name, options.m_tracks, options.m_parse_mode);
+  if (options.needs_cluster_pass())
+    extract_tracks(options.m_file_name, analyzer, track_specs, timecode_specs);
+}
 
-  else if (options_c::em_cuesheet == options.m_extraction_mode)
-    extract_cuesheet(options.m_file_name, options.m_parse_mode);
+int
+main(int argc,
+     char **argv) {
+  setup(argv);
 
-  else if (options_c::em_timecodes_v2 == options.m_extraction_mode)
-    extract_timecodes(options.m_file_name, options.m_tracks, 2);
+  options_c options = extract_cli_parser_c(command_line_utf8(argc, argv)).run();
 
-  else
-    usage(2);
+  run_extraction(options);
 
   mxexit();
 }
@@ -15,7 +15,9 @@
 
 #include "common/common_pch.h"
 
+#include <matroska/KaxBlock.h>
 #include <matroska/KaxChapters.h>
+#include <matroska/KaxCluster.h>
 #include <matroska/KaxTags.h>
 #include <matroska/KaxTracks.h>
 
@@ -49,14 +51,18 @@ show_error(const boost::format &format) {
 
 void find_and_verify_track_uids(KaxTracks &tracks, std::vector<track_spec_t> &tspecs);
 
-bool extract_tracks(const std::string &file_name, std::vector<track_spec_t> &tspecs, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_tags(const std::string &file_name, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_chapters(const std::string &file_name, bool chapter_format_simple, kax_analyzer_c::parse_mode_e parse_mode, boost::optional<std::string> const &language_to_extract);
-void extract_attachments(const std::string &file_name, std::vector<track_spec_t> &tracks, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_cuesheet(const std::string &file_name, kax_analyzer_c::parse_mode_e parse_mode);
+bool extract_tracks(const std::string &file_name, kax_analyzer_cptr const &analyzer, std::vector<track_spec_t> &tspecs, std::vector<track_spec_t> &timecode_tspecs);
+void extract_tags(kax_analyzer_c &analyzer, mm_io_c &out);
+void extract_chapters(kax_analyzer_c &analyzer, mm_io_c &out, bool chapter_format_simple, boost::optional<std::string> const &language_to_extract);
+void extract_attachments(kax_analyzer_c &analyzer, std::vector<track_spec_t> &tracks);
+void extract_cuesheet(kax_analyzer_c &analyzer, const std::string &file_name, mm_io_c &out);
 void write_cuesheet(std::string file_name, KaxChapters &chapters, KaxTags &tags, int64_t tuid, mm_io_c &out);
-void extract_timecodes(const std::string &file_name, std::vector<track_spec_t> &tspecs, int version);
-void extract_cues(std::string const &file_name, std::vector<track_spec_t> const &tracks, kax_analyzer_c::parse_mode_e parse_mode);
+void extract_cues(kax_analyzer_c &analyzer, std::vector<track_spec_t> const &tracks);
+
+void create_timecode_files(KaxTracks &kax_tracks, std::vector<track_spec_t> &tracks, int version);
+void handle_timecodes_for_blockgroup(KaxBlockGroup &blockgroup, KaxCluster &cluster, int64_t tc_scale);
+void handle_timecodes_for_simpleblock(KaxSimpleBlock &simpleblock, KaxCluster &cluster);
+void close_timecode_files();
 
 kax_analyzer_cptr open_and_analyze(std::string const &file_name, kax_analyzer_c::parse_mode_e parse_mode, bool exit_on_error = true);
 
@@ -16,8 +16,45 @@
 #include "extract/options.h"
 
 options_c::options_c()
-  : m_simple_chapter_format(false)
-  , m_parse_mode(kax_analyzer_c::parse_mode_fast)
-  , m_extraction_mode(options_c::em_unknown)
+  : m_parse_mode(kax_analyzer_c::parse_mode_fast)
 {
 }
+
+options_c::mode_options_c &
+options_c::get_current_mode() {
+  assert(!m_modes.empty());
+  return m_modes.back();
+}
+
+bool
+options_c::needs_cluster_pass()
+  const {
+  return boost::range::find_if(m_modes, [](mode_options_c const &mode) { return mode.is_cluster_mode(); }) != m_modes.end();
+}
+
+bool
+options_c::needs_level1_elements()
+  const {
+  return boost::range::find_if(m_modes, [](mode_options_c const &mode) { return !mode.is_cluster_mode(); }) != m_modes.end();
+}
+
+options_c::mode_options_c::mode_options_c(extraction_mode_e extraction_mode)
+  : m_extraction_mode{extraction_mode}
+  , m_simple_chapter_format{}
+{
+}
+
+bool
+options_c::mode_options_c::is_cluster_mode()
+  const {
+  return (em_tracks == m_extraction_mode) || (em_timecodes_v2 == m_extraction_mode);
+}
+
+bool
+options_c::mode_options_c::writes_to_stdout()
+  const {
+  return m_output_file_name.empty()
+    && (   (em_tags     == m_extraction_mode)
+        || (em_chapters == m_extraction_mode)
+        || (em_cuesheet == m_extraction_mode));
+}
@@ -26,16 +26,31 @@ public:
     em_cues,
   };
 
+  class mode_options_c {
+  public:
+    extraction_mode_e m_extraction_mode;
+    std::vector<track_spec_t> m_tracks;
+    bool m_simple_chapter_format;
+    boost::optional<std::string> m_simple_chapter_language;
+    std::string m_output_file_name;
+
+  public:
+    mode_options_c(extraction_mode_e extraction_mode);
+
+    bool is_cluster_mode() const;
+    bool writes_to_stdout() const;
+  };
+
   std::string m_file_name;
-  bool m_simple_chapter_format;
-  boost::optional<std::string> m_simple_chapter_language;
   kax_analyzer_c::parse_mode_e m_parse_mode;
-  extraction_mode_e m_extraction_mode;
-
-  std::vector<track_spec_t> m_tracks;
+  std::vector<mode_options_c> m_modes;
 
 public:
   options_c();
+
+  mode_options_c &get_current_mode();
+  bool needs_cluster_pass() const;
+  bool needs_level1_elements() const;
 };
 
 #endif // MTX_EXTRACT_OPTIONS_H
@@ -33,15 +33,14 @@
 using namespace libmatroska;
 
 void
-extract_tags(const std::string &file_name,
-             kax_analyzer_c::parse_mode_e parse_mode) {
-  auto analyzer      = open_and_analyze(file_name, parse_mode);
-  ebml_master_cptr m = analyzer->read_all(EBML_INFO(KaxTags));
+extract_tags(kax_analyzer_c &analyzer,
+             mm_io_c &out) {
+  ebml_master_cptr m = analyzer.read_all(EBML_INFO(KaxTags));
   if (!m)
     return;
 
   KaxTags *tags = dynamic_cast<KaxTags *>(m.get());
   assert(tags);
 
-  mtx::xml::ebml_tags_converter_c::write_xml(*tags, *g_mm_stdio);
+  mtx::xml::ebml_tags_converter_c::write_xml(*tags, out);
 }
@@ -344,9 +344,10 @@ handle_segment_info(EbmlMaster *info,
 
 bool
 extract_tracks(const std::string &file_name,
+               kax_analyzer_cptr const &analyzer,
                std::vector<track_spec_t> &tspecs,
-               kax_analyzer_c::parse_mode_e parse_mode) {
-  if (tspecs.empty())
+               std::vector<track_spec_t> &timecode_tspecs) {
+  if (tspecs.empty() && timecode_tspecs.empty())
     mxerror(Y("Nothing to do.\n"));
 
   // open input file
@@ -364,8 +365,13 @@ extract_tracks(const std::string &file_name,
   uint64_t tc_scale = TIMECODE_SCALE;
   bool segment_info_found = false, tracks_found = false;
 
-  // open input file
-  auto analyzer = open_and_analyze(file_name, parse_mode, false);
+  auto setup_tracks = [&tspecs, &timecode_tspecs](KaxTracks &tracks) {
+    find_and_verify_track_uids(tracks, tspecs);
+    find_and_verify_track_uids(tracks, timecode_tspecs);
+    create_extractors(tracks, tspecs);
+    create_timecode_files(tracks, timecode_tspecs, 2);
+  };
+
   if (analyzer) {
     auto af_master    = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxInfo)) };
     auto segment_info = dynamic_cast<KaxInfo *>(af_master.get());
@@ -378,8 +384,7 @@ extract_tracks(const std::string &file_name,
     auto tracks = dynamic_cast<KaxTracks *>(af_master.get());
     if (tracks) {
       tracks_found = true;
-      find_and_verify_track_uids(*tracks, tspecs);
-      create_extractors(*tracks, tspecs);
+      setup_tracks(*tracks);
     }
   }
 
@@ -430,8 +435,7 @@ extract_tracks(const std::string &file_name,
 
       } else if (Is<KaxTracks>(l1) && !tracks_found) {
         tracks_found = true;
-        find_and_verify_track_uids(*dynamic_cast<KaxTracks *>(l1), tspecs);
-        create_extractors(*dynamic_cast<KaxTracks *>(l1), tspecs);
+        setup_tracks(*static_cast<KaxTracks *>(l1));
 
       } else if (Is<KaxCluster>(l1)) {
         show_element(l1, 1, Y("Cluster"));
@@ -463,10 +467,12 @@ extract_tracks(const std::string &file_name,
 
           if (Is<KaxBlockGroup>(el)) {
             show_element(el, 2, Y("Block group"));
+            handle_timecodes_for_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
             max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
 
           } else if (Is<KaxSimpleBlock>(el)) {
             show_element(el, 2, Y("SimpleBlock"));
+            handle_timecodes_for_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
             max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
           }
 
@@ -514,6 +520,7 @@ extract_tracks(const std::string &file_name,
     // lullaby. Just close your eyes, listen to her sweet voice, singing,
     // singing, fading... fad... ing...
     close_extractors();
+    close_timecode_files();
 
     if (0 == verbose) {
       if (g_gui_mode)
@@ -524,6 +531,7 @@ extract_tracks(const std::string &file_name,
 
     return true;
   } catch (...) {
+    close_timecode_files();
     show_error(Y("Caught exception"));
 
     return false;
@@ -46,6 +46,15 @@
 
 #define AVI_MAX_AUDIO_CHUNK_SIZE (10 * 1024 * 1024)
 
+// Chunks are read sequentially in blocks of up to this size as long as
+// the gaps between them aren't bigger than AVI_MAX_CHUNK_GAP.
+#define AVI_READ_BLOCK_SIZE      (8 * 1024 * 1024)
+#define AVI_MAX_CHUNK_GAP        (256 * 1024)
+// Chunks for other streams that have been read but not processed yet
+// must not take up more memory than this. Chunks further away are
+// read directly instead.
+#define AVI_MAX_CACHED_BYTES     (64 * 1024 * 1024)
+
 #define GAB2_TAG                 FOURCC('G', 'A', 'B', '2')
 #define GAB2_ID_LANGUAGE         0x0000
 #define GAB2_ID_LANGUAGE_UNICODE 0x0002
@@ -483,6 +492,9 @@ avi_reader_c::add_audio_demuxer(int aid) {
 
   demuxer.m_ptzr = add_packetizer(packetizer);
 
+  AVI_set_audio_track(m_avi, aid);
+  demuxer.m_next_chunk = AVI_get_audio_position_index(m_avi);
+
   m_audio_demuxers.push_back(demuxer);
 
   int i, maxchunks = AVI_audio_chunks(m_avi);
@@ -669,9 +681,11 @@ avi_reader_c::read_video() {
   int dropped_frames_here   = 0;
 
   do {
-    size  = AVI_frame_size(m_avi, m_video_frames_read);
-    chunk = memory_c::alloc(size);
-    num_read = AVI_read_frame(m_avi, reinterpret_cast<char *>(chunk->get_buffer()), &key);
+    auto &entry = m_avi->video_index[m_video_frames_read];
+    size        = entry.len;
+    key         = 0x10 == entry.key ? 1 : 0;
+    chunk       = size ? read_chunk(0, m_video_frames_read, entry.pos, size) : memory_c::alloc(0);
+    num_read    = chunk ? size : -1;
 
     ++m_video_frames_read;
 
@@ -694,8 +708,6 @@ avi_reader_c::read_video() {
     if (0 != AVI_frame_size(m_avi, i))
       break;
 
-    int dummy_key;
-    AVI_read_frame(m_avi, nullptr, &dummy_key);
     ++dropped_frames_here;
     ++m_video_frames_read;
   }
@@ -737,38 +749,160 @@ avi_reader_c::read_video() {
 
 file_status_e
 avi_reader_c::read_audio(avi_demuxer_t &demuxer) {
-  AVI_set_audio_track(m_avi, demuxer.m_aid);
+  auto &track  = m_avi->track[demuxer.m_aid];
+  auto stream  = static_cast<unsigned int>(&demuxer - &m_audio_demuxers[0]) + 1;
 
   while (true) {
-    int size = AVI_audio_size(m_avi, AVI_get_audio_position_index(m_avi));
-
-    // -1 indicates the last chunk.
-    if (-1 == size)
+    if (demuxer.m_next_chunk >= track.audio_chunks)
       return flush_packetizer(demuxer.m_ptzr);
 
+    auto &entry = track.audio_index[demuxer.m_next_chunk];
+
     // Sanity check. Ignore chunks with obvious wrong size information
     // (> 10 MB). Also skip 0-sized blocks. Those are officially
     // skipped.
-    if (!size || (size > AVI_MAX_AUDIO_CHUNK_SIZE)) {
-      AVI_set_audio_position_index(m_avi, AVI_get_audio_position_index(m_avi) + 1);
+    if (!entry.len || (entry.len > AVI_MAX_AUDIO_CHUNK_SIZE)) {
+      ++demuxer.m_next_chunk;
       continue;
     }
 
-    auto chunk = memory_c::alloc(size);
-    size       = AVI_read_audio_chunk(m_avi, reinterpret_cast<char *>(chunk->get_buffer()));
+    auto chunk = read_chunk(stream, demuxer.m_next_chunk, entry.pos, entry.len);
 
-    if (0 > size)
+    if (!chunk)
       return flush_packetizer(demuxer.m_ptzr);
 
-    if (!size)
-      continue;
+    ++demuxer.m_next_chunk;
 
     PTZR(demuxer.m_ptzr)->process(new packet_t(chunk));
 
-    m_bytes_processed += size;
+    m_bytes_processed += chunk->get_size();
+
+    return demuxer.m_next_chunk < track.audio_chunks ? FILE_STATUS_MOREDATA : flush_packetizer(demuxer.m_ptzr);
+  }
+}
+
+void
+avi_reader_c::index_chunks() {
+  m_chunks_indexed = true;
+  m_chunk_cache.resize(1 + m_audio_demuxers.size());
+
+  if (-1 != m_vptzr)
+    for (auto idx = 0l; idx < m_avi->video_frames; ++idx)
+      if (m_avi->video_index[idx].len)
+        m_chunks.push_back({ m_avi->video_index[idx].pos, static_cast<uint32_t>(m_avi->video_index[idx].len), 0, idx });
+
+  for (auto demuxer_idx = 0u; demuxer_idx < m_audio_demuxers.size(); ++demuxer_idx) {
+    auto &track = m_avi->track[m_audio_demuxers[demuxer_idx].m_aid];
 
-    return AVI_get_audio_position_index(m_avi) < AVI_max_audio_chunk(m_avi) ? FILE_STATUS_MOREDATA : flush_packetizer(demuxer.m_ptzr);
+    for (auto idx = 0l; idx < track.audio_chunks; ++idx)
+      if (track.audio_index[idx].len && (track.audio_index[idx].len <= AVI_MAX_AUDIO_CHUNK_SIZE))
+        m_chunks.push_back({ track.audio_index[idx].pos, static_cast<uint32_t>(track.audio_index[idx].len), demuxer_idx + 1, idx });
   }
+
+  std::stable_sort(m_chunks.begin(), m_chunks.end(), [](avi_chunk_t const &a, avi_chunk_t const &b) { return a.m_pos < b.m_pos; });
+
+  mxdebug_if(m_debug_chunks, boost::format("avi_reader: indexed %1% chunks of %2% streams\n") % m_chunks.size() % m_chunk_cache.size());
+}
+
+long
+avi_reader_c::get_next_chunk_idx(unsigned int stream)
+  const {
+  return !stream ? static_cast<long>(m_video_frames_read) : m_audio_demuxers[stream - 1].m_next_chunk;
+}
+
+// Reads all chunks in file order up to and including the one ending at
+// 'min_end_pos'. Runs of chunks that are close to each other are read
+// with a single read call. Chunks that haven't been processed by their
+// stream yet are kept in memory.
+void
+avi_reader_c::read_chunks_sequentially(int64_t min_end_pos) {
+  while ((m_next_chunk < m_chunks.size()) && (m_chunks[m_next_chunk].m_pos < min_end_pos)) {
+    auto first     = m_next_chunk;
+    auto start_pos = m_chunks[first].m_pos;
+    auto end_pos   = start_pos + m_chunks[first].m_len;
+    auto last      = first + 1;
+
+    while (last < m_chunks.size()) {
+      auto &next = m_chunks[last];
+
+      if (   (next.m_pos < end_pos)
+          || ((next.m_pos - end_pos) > AVI_MAX_CHUNK_GAP)
+          || (((next.m_pos + next.m_len - start_pos) > AVI_READ_BLOCK_SIZE) && (end_pos >= min_end_pos)))
+        break;
+
+      end_pos = next.m_pos + next.m_len;
+      ++last;
+    }
+
+    auto block    = memory_c::alloc(end_pos - start_pos);
+    auto num_read = int64_t{};
+
+    try {
+      m_in->setFilePointer(start_pos);
+      num_read = m_in->read(block, end_pos - start_pos);
+    } catch (mtx::mm_io::exception &) {
+    }
+
+    mxdebug_if(m_debug_chunks, boost::format("avi_reader: sequential read of chunks %1%-%2% at %3% size %4% read %5%\n") % first % (last - 1) % start_pos % (end_pos - start_pos) % num_read);
+
+    for (auto idx = first; idx < last; ++idx) {
+      auto &chunk = m_chunks[idx];
+
+      if (   (chunk.m_idx < get_next_chunk_idx(chunk.m_stream))
+          || ((chunk.m_pos + chunk.m_len - start_pos) > num_read))
+        continue;
+
+      m_chunk_cache[chunk.m_stream][chunk.m_idx]  = memory_c::clone(block->get_buffer() + chunk.m_pos - start_pos, chunk.m_len);
+      m_num_cached_bytes                         += chunk.m_len;
+    }
+
+    m_next_chunk = last;
+  }
+}
+
+memory_cptr
+avi_reader_c::read_chunk(unsigned int stream,
+                         long idx,
+                         int64_t pos,
+                         uint32_t len) {
+  if (!m_chunks_indexed)
+    index_chunks();
+
+  auto &cache = m_chunk_cache[stream];
+  auto itr    = cache.find(idx);
+
+  // Read everything from the current sequential position up to the
+  // wanted chunk unless that would buffer too much data for the other
+  // streams.
+  if (   (cache.end() == itr)
+      && (m_next_chunk < m_chunks.size())
+      && (pos >= m_chunks[m_next_chunk].m_pos)
+      && ((m_num_cached_bytes + (pos + len - m_chunks[m_next_chunk].m_pos)) <= AVI_MAX_CACHED_BYTES)) {
+    read_chunks_sequentially(pos + len);
+    itr = cache.find(idx);
+  }
+
+  if (cache.end() != itr) {
+    auto data           = itr->second;
+    m_num_cached_bytes -= data->get_size();
+    cache.erase(itr);
+
+    return data;
+  }
+
+  mxdebug_if(m_debug_chunks, boost::format("avi_reader: direct read of chunk %1% of stream %2% at %3% size %4%\n") % idx % stream % pos % len);
+
+  try {
+    auto data = memory_c::alloc(len);
+
+    m_in->setFilePointer(pos);
+    if (m_in->read(data, len) == len)
+      return data;
+
+  } catch (mtx::mm_io::exception &) {
+  }
+
+  return memory_cptr{};
 }
 
 file_status_e
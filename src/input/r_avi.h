@@ -31,9 +31,17 @@ struct avi_demuxer_t {
   int m_ptzr{-1};
   int m_channels{}, m_bits_per_sample{}, m_samples_per_second{}, m_aid{};
   int64_t m_bytes_processed{};
+  long m_next_chunk{};
   codec_c m_codec;
 };
 
+struct avi_chunk_t {
+  int64_t m_pos;
+  uint32_t m_len;
+  unsigned int m_stream;        // 0 = video, 1 + n = m_audio_demuxers[n]
+  long m_idx;                   // index into the stream's own index
+};
+
 struct avi_subs_demuxer_t {
   enum {
     TYPE_UNKNOWN,
@@ -71,6 +79,16 @@ private:
   uint64_t m_bytes_to_process{}, m_bytes_processed{};
   bool m_video_track_ok{};
 
+  // Chunks of all demuxed streams sorted by their position in the
+  // file. They're read in large sequential blocks and kept in memory
+  // until the stream's packetizer asks for them.
+  std::vector<avi_chunk_t> m_chunks;
+  std::vector<std::unordered_map<long, memory_cptr> > m_chunk_cache;
+  size_t m_next_chunk{};
+  uint64_t m_num_cached_bytes{};
+  bool m_chunks_indexed{};
+  debugging_option_c m_debug_chunks{"avi_reader|avi_reader_chunks"};
+
 public:
   avi_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~avi_reader_c();
@@ -95,6 +113,11 @@ protected:
   virtual file_status_e read_audio(avi_demuxer_t &demuxer);
   virtual file_status_e read_subtitles(avi_subs_demuxer_t &demuxer);
 
+  virtual void index_chunks();
+  virtual void read_chunks_sequentially(int64_t min_end_pos);
+  virtual memory_cptr read_chunk(unsigned int stream, long idx, int64_t pos, uint32_t len);
+  long get_next_chunk_idx(unsigned int stream) const;
+
   virtual generic_packetizer_c *create_aac_packetizer(int aid, avi_demuxer_t &demuxer);
   virtual generic_packetizer_c *create_dts_packetizer(int aid);
   virtual generic_packetizer_c *create_vorbis_packetizer(int aid);
@@ -24,7 +24,7 @@
 #include "merge/file_status.h"
 #include "merge/output_control.h"
 
-#define BUFFER_SIZE 4096
+#define READ_SIZE (128 * 1024)
 
 #if defined(HAVE_FLAC_FORMAT_H)
 
@@ -63,26 +63,6 @@ flac_reader_c::read_headers() {
     return;
 
   show_demuxer_info();
-
-  try {
-    uint32_t block_size = 0;
-
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++)
-      block_size += current_block->len;
-
-    m_header = memory_c::alloc(block_size);
-
-    block_size         = 0;
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++) {
-      m_in->setFilePointer(current_block->filepos);
-      if (m_in->read(m_header->get_buffer() + block_size, current_block->len) != current_block->len)
-        mxerror(Y("flac_reader: Could not read a header packet.\n"));
-      block_size += current_block->len;
-    }
-
-  } catch (mtx::exception &) {
-    mxerror(Y("flac_reader: could not initialize the FLAC packetizer.\n"));
-  }
 }
 
 flac_reader_c::~flac_reader_c() {
@@ -99,22 +79,16 @@ flac_reader_c::create_packetizer(int64_t) {
 
 bool
 flac_reader_c::parse_file(bool for_identification_only) {
-  FLAC__StreamDecoderState state;
-  flac_block_t block;
-  uint64_t u, old_pos;
-  int result, progress, old_progress;
-  bool ok;
+  uint64_t u;
+  int result;
 
   m_in->setFilePointer(0);
   metadata_parsed = false;
 
-  if (!for_identification_only)
-    mxinfo(Y("+-> Parsing the FLAC file. This can take a LONG time.\n"));
-
   init_flac_decoder();
   result = FLAC__stream_decoder_process_until_end_of_metadata(m_flac_decoder.get());
 
-  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%, num blocks: %3%\n") % result % metadata_parsed % blocks.size());
+  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%\n") % result % metadata_parsed);
 
   if (!metadata_parsed)
     mxerror_fn(m_ti.m_fname, Y("No metadata block found. This file is broken.\n"));
@@ -122,77 +96,175 @@ flac_reader_c::parse_file(bool for_identification_only) {
   if (for_identification_only)
     return true;
 
-  FLAC__stream_decoder_get_decode_position(m_flac_decoder.get(), &u);
+  // The frames are not pre-parsed. They're split from the raw data in
+  // read() instead. Only the header packets are needed at this point.
+  if (!FLAC__stream_decoder_get_decode_position(m_flac_decoder.get(), &u) || (4 >= u))
+    mxerror(Y("flac_reader: Could not read all header packets.\n"));
+
+  mxverb(2, boost::format("flac_reader: headers: block at 4 with size %1%\n") % (u - 4));
+
+  try {
+    m_header = memory_c::alloc(u - 4);
 
-  block.type    = FLAC_BLOCK_TYPE_HEADERS;
-  block.filepos = 0;
-  block.len     = u;
-  old_pos       = u;
+    m_in->setFilePointer(4);
+    if (m_in->read(m_header, u - 4) != (u - 4))
+      mxerror(Y("flac_reader: Could not read a header packet.\n"));
 
-  blocks.push_back(block);
+  } catch (mtx::exception &) {
+    mxerror(Y("flac_reader: could not initialize the FLAC packetizer.\n"));
+  }
 
-  mxverb(2, boost::format("flac_reader: headers: block at %1% with size %2%\n") % block.filepos % block.len);
+  m_flac_decoder.reset();
 
-  old_progress = -5;
-  ok = FLAC__stream_decoder_skip_single_frame(m_flac_decoder.get());
-  while (ok) {
-    state = FLAC__stream_decoder_get_state(m_flac_decoder.get());
+  return metadata_parsed;
+}
 
-    progress = m_in->getFilePointer() * 100 / m_size;
-    if ((progress - old_progress) >= 5) {
-      mxinfo(boost::format(Y("+-> Pre-parsing FLAC file: %1%%%%2%")) % progress % "\r");
-      old_progress = progress;
-    }
+// Returns false if the end of the file had already been reached before.
+bool
+flac_reader_c::fill_buffer() {
+  if (m_eof)
+    return false;
 
-    if (FLAC__stream_decoder_get_decode_position(m_flac_decoder.get(), &u) && (u != old_pos)) {
-      block.type    = FLAC_BLOCK_TYPE_DATA;
-      block.filepos = old_pos;
-      block.len     = u - old_pos;
-      old_pos       = u;
-      blocks.push_back(block);
+  auto chunk    = memory_c::alloc(READ_SIZE);
+  auto num_read = m_in->read(chunk, READ_SIZE);
 
-      mxverb(2, boost::format("flac_reader: skip/decode frame, block at %1% with size %2%\n") % block.filepos % block.len);
-    }
+  if (num_read)
+    m_buffer.add(chunk->get_buffer(), num_read);
+
+  if (num_read < READ_SIZE)
+    m_eof = true;
 
-    if (state > FLAC__STREAM_DECODER_READ_FRAME)
+  return true;
+}
+
+// Drops everything before the next valid frame header. Returns false
+// if more data is needed for finding one.
+bool
+flac_reader_c::sync_to_frame_header() {
+  auto buffer = m_buffer.get_buffer();
+  auto size   = m_buffer.get_size();
+  auto pos    = size_t{};
+
+  while (((pos + FLAC_FRAME_HEADER_MAX_SIZE) <= size) || (m_eof && (pos < size))) {
+    m_frame_header_size = 0xff == buffer[pos] ? mtx::flac::get_frame_header_size(&buffer[pos], size - pos) : 0;
+    if (m_frame_header_size)
       break;
+    ++pos;
+  }
 
-    ok = FLAC__stream_decoder_skip_single_frame(m_flac_decoder.get());
+  if (pos) {
+    mxverb(2, boost::format("flac_reader: skipping %1% bytes of garbage\n") % pos);
+    m_num_bytes_skipped += pos;
+    m_buffer.remove(pos);
   }
 
-  if (100 != old_progress)
-    mxinfo(Y("+-> Pre-parsing FLAC file: 100%\n"));
-  else
-    mxinfo("\n");
+  if (!m_frame_header_size)
+    return false;
 
-  if ((blocks.size() == 0) || (blocks[0].type != FLAC_BLOCK_TYPE_HEADERS))
-    mxerror(Y("flac_reader: Could not read all header packets.\n"));
+  // No frame can be smaller than the minimum frame size from
+  // STREAMINFO; there's no need to look for the next header before it.
+  m_scan_pos = std::max<size_t>(m_frame_header_size + 2, stream_info.min_framesize);
+  m_crc_pos  = 0;
+  m_frame_crc.set_initial_value(0);
 
-  m_in->setFilePointer(0);
-  blocks[0].len     -= 4;
-  blocks[0].filepos  = 4;
+  return true;
+}
 
-  return metadata_parsed;
+// Looks for the start of the next frame after the one at the start of
+// m_buffer. A candidate is only accepted if its header is valid and
+// the current frame's CRC-16 matches. Returns the current frame's size
+// or 0 if more data is needed.
+size_t
+flac_reader_c::find_frame_size() {
+  auto buffer = m_buffer.get_buffer();
+  auto size   = m_buffer.get_size();
+
+  for (; ((m_scan_pos + FLAC_FRAME_HEADER_MAX_SIZE) <= size) || (m_eof && ((m_scan_pos + 2) <= size)); ++m_scan_pos) {
+    if ((0xff != buffer[m_scan_pos]) || (0xf8 != (buffer[m_scan_pos + 1] & 0xfe)) || !mtx::flac::get_frame_header_size(&buffer[m_scan_pos], size - m_scan_pos))
+      continue;
+
+    // The CRC-16 over the whole frame including the CRC itself must
+    // be 0. It is calculated incrementally as the candidates are only
+    // ever further away from the frame's start.
+    m_frame_crc.add(&buffer[m_crc_pos], m_scan_pos - m_crc_pos);
+    m_crc_pos = m_scan_pos;
+
+    if (!m_frame_crc.get_result_as_uint())
+      return m_scan_pos;
+  }
+
+  if (!m_eof || !size)
+    return 0;
+
+  // The last frame ends at the last position at which its CRC-16 is
+  // valid. Anything following it (e.g. an ID3v1 tag) is dropped.
+  auto frame_size = size_t{};
+
+  for (; m_crc_pos < size; ++m_crc_pos) {
+    m_frame_crc.add(&buffer[m_crc_pos], 1);
+    if (((m_crc_pos + 1) >= (m_frame_header_size + 2)) && !m_frame_crc.get_result_as_uint())
+      frame_size = m_crc_pos + 1;
+  }
+
+  if (!frame_size) {
+    m_num_bytes_skipped += size;
+    m_frame_header_size  = 0;
+    m_buffer.clear();
+  }
+
+  return frame_size;
 }
 
 file_status_e
 flac_reader_c::read(generic_packetizer_c *,
                     bool) {
-  if (current_block == blocks.end())
-    return flush_packetizers();
+  auto frame_size = size_t{};
+
+  while (!frame_size) {
+    if (!m_frame_header_size && !sync_to_frame_header()) {
+      if (!fill_buffer())
+        break;
+      continue;
+    }
+
+    frame_size = find_frame_size();
+    if (frame_size)
+      break;
+
+    // A frame cannot be bigger than the maximum frame size from
+    // STREAMINFO. The frame header found is bogus then; re-sync
+    // right after it.
+    if (m_frame_header_size && stream_info.max_framesize && (m_scan_pos > (stream_info.max_framesize + FLAC_FRAME_HEADER_MAX_SIZE))) {
+      mxverb(2, boost::format("flac_reader: no valid frame end found within the maximum frame size; re-syncing\n"));
+      m_frame_header_size = 0;
+      m_buffer.remove(1);
+      ++m_num_bytes_skipped;
+      continue;
+    }
+
+    if (!fill_buffer())
+      break;
+  }
+
+  if (!frame_size) {
+    if (m_num_bytes_skipped)
+      mxwarn_fn(m_ti.m_fname, boost::format(Y("%1% bytes of data that did not belong to any FLAC frame were skipped.\n")) % m_num_bytes_skipped);
 
-  memory_cptr buf = memory_c::alloc(current_block->len);
-  m_in->setFilePointer(current_block->filepos);
-  if (m_in->read(buf, current_block->len) != current_block->len)
     return flush_packetizers();
+  }
+
+  auto buf          = memory_c::clone(m_buffer.get_buffer(), frame_size);
+  auto samples_here = mtx::flac::get_num_samples(buf->get_buffer(), frame_size, stream_info);
+
+  mxverb(2, boost::format("flac_reader: frame with size %1% and %2% samples\n") % frame_size % samples_here);
 
-  unsigned int samples_here = mtx::flac::get_num_samples(buf->get_buffer(), current_block->len, stream_info);
   PTZR0->process(new packet_t(buf, samples * 1000000000 / sample_rate));
 
-  samples += samples_here;
-  current_block++;
+  samples             += std::max(samples_here, 0);
+  m_frame_header_size  = 0;
+  m_buffer.remove(frame_size);
 
-  return (current_block == blocks.end()) ? flush_packetizers() : FILE_STATUS_MOREDATA;
+  return FILE_STATUS_MOREDATA;
 }
 
 FLAC__StreamDecoderReadStatus
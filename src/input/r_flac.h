@@ -24,27 +24,27 @@
 #include <FLAC/export.h>
 #include <FLAC/stream_decoder.h>
 
+#include "common/byte_buffer.h"
+#include "common/checksums/crc.h"
 #include "common/flac.h"
 #include "output/p_flac.h"
 
-#define FLAC_BLOCK_TYPE_HEADERS 0
-#define FLAC_BLOCK_TYPE_DATA    1
-
-struct flac_block_t {
-  int64_t filepos;
-  unsigned int type, len;
-};
-
 class flac_reader_c: public generic_reader_c, public mtx::flac::decoder_c {
 private:
   memory_cptr m_header;
   int sample_rate{}, channels{}, bits_per_sample{};
   bool metadata_parsed{};
   uint64_t samples{};
-  std::vector<flac_block_t> blocks;
-  std::vector<flac_block_t>::iterator current_block;
   FLAC__StreamMetadata_StreamInfo stream_info;
 
+  // Frames are split from the raw data while reading. m_buffer always
+  // starts with the current frame once its header has been found.
+  byte_buffer_c m_buffer;
+  size_t m_frame_header_size{}, m_scan_pos{}, m_crc_pos{};
+  mtx::checksum::crc16_ansi_c m_frame_crc;
+  uint64_t m_num_bytes_skipped{};
+  bool m_eof{};
+
 public:
   flac_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~flac_reader_c();
@@ -73,6 +73,9 @@ public:
 
 protected:
   virtual bool parse_file(bool for_identification_only);
+  virtual bool fill_buffer();
+  virtual bool sync_to_frame_header();
+  virtual size_t find_frame_size();
 };
 
 #else  // HAVE_FLAC_FORMAT_H
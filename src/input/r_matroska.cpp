@@ -1540,11 +1540,10 @@ kax_reader_c::init_passthrough_packetizer(kax_track_t *t,
 
   mxinfo_tid(m_ti.m_fname, t->tnum, boost::format(Y("Using the generic output module for track type '%1%'.\n")) % MAP_TRACK_TYPE_STRING(t->type));
 
-  ptzr                      = new passthrough_packetizer_c(this, nti);
-  t->ptzr                   = add_packetizer(ptzr);
-  t->ptzr_ptr               = ptzr;
-  t->passthrough            = true;
-  m_ptzr_to_track_map[ptzr] = t;
+  ptzr           = new passthrough_packetizer_c(this, nti);
+  t->ptzr        = add_packetizer(ptzr);
+  t->ptzr_ptr    = ptzr;
+  t->passthrough = true;
 
   ptzr->set_track_type(MAP_TRACK_TYPE(t->type));
   ptzr->set_codec_id(t->codec_id);
@@ -2007,7 +2006,6 @@ kax_reader_c::create_packetizer(int64_t tid) {
   }
 
   set_packetizer_headers(t);
-  m_ptzr_to_track_map[ m_reader_packetizers[t->ptzr] ] = t;
 }
 
 void
@@ -2148,14 +2146,8 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (m_tracks.empty() || (FILE_STATUS_DONE == m_file_status))
     return FILE_STATUS_DONE;
 
-  if (!force) {
-    auto num_queued_bytes = get_queued_bytes();
-    if (20 * 1024 * 1024 < num_queued_bytes) {
-      kax_track_t *requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-      if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || (512 * 1024 * 1024 < num_queued_bytes))
-        return FILE_STATUS_HOLDING;
-    }
-  }
+  if (!force && queue_limit_reached(get_queued_bytes(), requested_ptzr))
+    return FILE_STATUS_HOLDING;
 
   try {
     KaxCluster *cluster = m_in_file->read_next_cluster();
@@ -210,7 +210,6 @@ private:
   };
 
   std::vector<kax_track_cptr> m_tracks;
-  std::map<generic_packetizer_c *, kax_track_t *> m_ptzr_to_track_map;
 
   int64_t m_tc_scale;
 
@@ -20,6 +20,7 @@
 #include "common/error.h"
 #include "common/id_info.h"
 #include "common/math.h"
+#include "common/mm_read_ahead_io.h"
 #include "common/mp3.h"
 #include "common/mpeg1_2.h"
 #include "common/mpeg4_p2.h"
@@ -27,6 +28,7 @@
 #include "common/truehd.h"
 #include "input/r_mpeg_ps.h"
 #include "merge/file_status.h"
+#include "merge/output_control.h"
 #include "mpegparser/M2VParser.h"
 #include "output/p_ac3.h"
 #include "output/p_avc.h"
@@ -64,6 +66,7 @@ mpeg_ps_reader_c::mpeg_ps_reader_c(const track_info_c &ti,
   , m_probe_range{}
   , m_debug_timecodes{"mpeg_ps|mpeg_ps_timecodes"}
 {
+  m_max_queued_bytes_av = 64 * 1024 * 1024;
 }
 
 void
@@ -73,7 +76,9 @@ mpeg_ps_reader_c::read_headers() {
 
     if (!m_ti.m_disable_multi_file && boost::regex_search(bfs::path{m_ti.m_fname}.filename().string(), boost::regex{"^vts_\\d+_\\d+", boost::regex::icase | boost::regex::perl})) {
       m_in.reset();               // Close the source file first before opening it a second time.
-      m_in = mm_multi_file_io_c::open_multi(m_ti.m_fname, false);
+
+      auto multi_in = mm_multi_file_io_c::open_multi(m_ti.m_fname, false, get_source_file_flags());
+      m_in          = mm_io_cptr(mm_read_ahead_io_c::open(multi_in.get(), get_read_ahead_size(), false), [multi_in](mm_io_c *io) { delete io; });
     }
 
     m_size          = m_in->get_size();
@@ -1230,8 +1235,6 @@ mpeg_ps_reader_c::create_packetizer(int64_t id) {
 
   if (-1 != track->timecode_offset)
     PTZR(track->ptzr)->m_ti.m_tcsync.displacement += track->timecode_offset;
-
-  m_ptzr_to_track_map[ PTZR(track->ptzr) ] = track;
 }
 
 void
@@ -1253,12 +1256,8 @@ mpeg_ps_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (file_done)
     return flush_packetizers();
 
-  auto num_queued_bytes = get_queued_bytes();
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
-    mpeg_ps_track_ptr requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-    if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || (64 * 1024 * 1024 < num_queued_bytes))
-      return FILE_STATUS_HOLDING;
-  }
+  if (!force && queue_limit_reached(get_queued_bytes(), requested_ptzr))
+    return FILE_STATUS_HOLDING;
 
   try {
     mpeg_ps_id_t new_id;
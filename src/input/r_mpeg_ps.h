@@ -202,7 +202,6 @@ private:
   bool file_done;
 
   std::vector<mpeg_ps_track_ptr> tracks;
-  std::map<generic_packetizer_c *, mpeg_ps_track_ptr> m_ptzr_to_track_map;
 
   uint64_t m_probe_range;
 
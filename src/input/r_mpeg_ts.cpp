@@ -2051,16 +2051,11 @@ reader_c::read(generic_packetizer_c *requested_ptzr,
   if (!requested_ptzr_track)
     return flush_packetizers();
 
-  m_current_file        = requested_ptzr_track->m_file_num;
-  auto &f               = file();
-  auto num_queued_bytes = f.get_queued_bytes();
-
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
-    if (   !requested_ptzr_track
-        || !mtx::included_in(requested_ptzr_track->type, pid_type_e::audio, pid_type_e::video)
-        || (512 * 1024 * 1024 < num_queued_bytes))
-      return FILE_STATUS_HOLDING;
-  }
+  m_current_file = requested_ptzr_track->m_file_num;
+  auto &f        = file();
+
+  if (!force && queue_limit_reached(f.get_queued_bytes(), requested_ptzr))
+    return FILE_STATUS_HOLDING;
 
   f.m_packet_sent_to_packetizer = false;
 
@@ -28,6 +28,7 @@
 #include "common/id_info.h"
 #include "common/iso639.h"
 #include "common/ivf.h"
+#include "common/memory_accounting.h"
 #include "common/mpeg4_p2.h"
 #include "common/ogmstreams.h"
 #include "input/r_ogm.h"
@@ -680,10 +681,10 @@ ogm_reader_c::read_headers_internal() {
 */
 file_status_e
 ogm_reader_c::read(generic_packetizer_c *,
-                   bool) {
+                   bool force) {
   // Some tracks may contain huge gaps. We don't want to suck in the complete
   // file.
-  if (get_queued_bytes() > 20 * 1024 * 1024)
+  if ((get_queued_bytes() > m_max_queued_bytes) || (!force && mtx::memory_accounting::limit_reached()))
     return FILE_STATUS_HOLDING;
 
   ogg_page og;
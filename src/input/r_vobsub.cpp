@@ -19,6 +19,7 @@
 #include "common/iso639.h"
 #include "common/endian.h"
 #include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/spu.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
@@ -67,6 +68,9 @@ vobsub_reader_c::vobsub_reader_c(const track_info_c &ti,
                                  const mm_io_cptr &in)
   : generic_reader_c(ti, in)
   , delay(0)
+  , m_scan_pos(0)
+  , m_scan_done(false)
+  , m_mpeg_version_warning_printed(false)
 {
 }
 
@@ -85,7 +89,7 @@ vobsub_reader_c::read_headers() {
   sub_name += ".sub";
 
   try {
-    m_sub_file = mm_file_io_cptr(new mm_file_io_c(sub_name));
+    m_sub_file = mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(sub_name), 1 << 17));
   } catch (...) {
     throw mtx::input::extended_x(boost::format(Y("%1%: Could not open the sub file")) % get_format_name());
   }
@@ -152,6 +156,16 @@ vobsub_reader_c::create_packetizer(int64_t tid) {
 
   num_indices += track->entries.size();
 
+  // SPUs of all tracks whose entries are stored in file order are
+  // assembled during a single scan over the .sub file. Others are
+  // extracted entry by entry.
+  track->in_file_order = track->entries.end() == std::adjacent_find(track->entries.begin(), track->entries.end(), [](vobsub_entry_c const &a, vobsub_entry_c const &b) {
+    return a.position >= b.position;
+  });
+
+  if (track->in_file_order)
+    m_assembling_tracks.push_back(track);
+
   m_ti.m_language = "";
   show_packetizer_info(tid, PTZR(track->ptzr));
 }
@@ -619,6 +633,284 @@ vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
   return deliver();
 }
 
+void
+vobsub_reader_c::deliver_assembled_spu(int64_t track_id) {
+  vobsub_track_c *track = tracks[track_id];
+
+  while (track->spus.empty() && !m_scan_done)
+    scan_next_start_code();
+
+  track->packet_num++;
+
+  // Entries located after the end of the file.
+  if (track->spus.empty())
+    return;
+
+  auto spu = track->spus.front();
+  track->spus.pop_front();
+
+  if (!spu)
+    return;
+
+  // deliver_packet() takes over the buffer.
+  spu->lock();
+  deliver_packet(spu->get_buffer(), spu->get_size(), track->entries[track->idx].timestamp, track->entries[track->idx].duration, PTZR(track->ptzr));
+}
+
+void
+vobsub_reader_c::scan_next_start_code() {
+  const unsigned char wanted[] = { 0, 0, 1 };
+  unsigned char buf[4];
+  uint32_t len;
+  int c;
+
+  if (m_sub_file->getFilePointer() != m_scan_pos)
+    m_sub_file->setFilePointer(m_scan_pos);
+
+  auto position = m_scan_pos;
+  update_assembly_ranges(position);
+
+  if (m_sub_file->read(buf, 4) != 4)
+    return finish_scan();
+
+  while (memcmp(buf, wanted, sizeof(wanted)) != 0) {
+    c = m_sub_file->getch();
+    if (0 > c)
+      return finish_scan();
+    memmove(buf, buf + 1, 3);
+    buf[3] = c;
+  }
+
+  switch (buf[3]) {
+    case 0xb9:                  // System End Code
+      finish_started_spus(position);
+      break;
+
+    case 0xba:                  // Packet start code
+      c = m_sub_file->getch();
+      if (0 > c)
+        return finish_scan();
+
+      if (((c & 0xc0) != 0x40) && ((c & 0xf0) != 0x20) && !m_mpeg_version_warning_printed) {
+        mxwarn_fn(m_ti.m_fname,
+                  boost::format(Y("Unsupported MPEG mpeg_version: 0x%|1$02x| in the packet at position %2%, assuming MPEG2. No further warnings will be printed for this file.\n"))
+                  % c % position);
+        m_mpeg_version_warning_printed = true;
+      }
+
+      if (!m_sub_file->setFilePointer2((c & 0xc0) == 0x40 ? 9 : 7, seek_current))
+        return finish_scan();
+      break;
+
+    case 0xbd:                  // packet
+      scan_spu_packet(position);
+      if (m_scan_done)
+        return;
+      break;
+
+    case 0xbe:                  // Padding
+      if (m_sub_file->read(buf, 2) != 2)
+        return finish_scan();
+      len = buf[0] << 8 | buf[1];
+      if ((0 < len) && !m_sub_file->setFilePointer2(len, seek_current))
+        return finish_scan();
+      break;
+
+    default:
+      if ((0xc0 <= buf[3]) && (buf[3] < 0xf0)) {
+        // MPEG audio or video
+        if (m_sub_file->read(buf, 2) != 2)
+          return finish_scan();
+        len = (buf[0] << 8) | buf[1];
+        if ((0 < len) && !m_sub_file->setFilePointer2(len, seek_current))
+          return finish_scan();
+
+      } else {
+        mxwarn_fn(m_ti.m_fname, boost::format(Y("Unknown header 0x%|1$02x|%|2$02x|%|3$02x|%|4$02x|\n")) % buf[0] % buf[1] % buf[2] % buf[3]);
+        finish_started_spus(position);
+      }
+  }
+
+  m_scan_pos = m_sub_file->getFilePointer();
+}
+
+void
+vobsub_reader_c::scan_spu_packet(uint64_t position) {
+  unsigned char buf[5];
+  int c;
+
+  if (m_sub_file->read(buf, 2) != 2)
+    return finish_scan();
+
+  uint32_t len       = buf[0] << 8 | buf[1];
+  uint64_t pes_start = m_sub_file->getFilePointer();
+  c                  = m_sub_file->getch();
+
+  if (0 > c)
+    return finish_scan();
+  if ((c & 0xC0) == 0x40) { // skip STD scale & size
+    if (m_sub_file->getch() < 0)
+      return finish_scan();
+    c = m_sub_file->getch();
+    if (0 > c)
+      return finish_scan();
+  }
+
+  if ((c & 0xf0) == 0x20) // System-1 stream timestamp
+    abort();
+  else if ((c & 0xf0) == 0x30)
+    abort();
+  else if ((c & 0xc0) != 0x80) // not a System-2 (.VOB) stream
+    return;
+
+  c = m_sub_file->getch();
+  if (0 > c)
+    return finish_scan();
+
+  uint32_t pts_flags = c;
+  c                  = m_sub_file->getch();
+  if (0 > c)
+    return finish_scan();
+
+  uint32_t hdrlen  = c;
+  uint64_t dataidx = m_sub_file->getFilePointer() + hdrlen;
+  if (dataidx > pes_start + len) {
+    mxwarn_fn(m_ti.m_fname, boost::format(Y("Invalid header length: %1% (total length: %2%, idx: %3%, dataidx: %4%)\n")) % hdrlen % len % (pes_start - position) % (dataidx - position));
+    return finish_started_spus(position);
+  }
+
+  int64_t pts = 0;
+  if ((pts_flags & 0xc0) == 0x80) {
+    if (m_sub_file->read(buf, 5) != 5)
+      return finish_scan();
+    if (!(((buf[0] & 0xf0) == 0x20) && (buf[0] & 1) && (buf[2] & 1) && (buf[4] & 1)))
+      mxwarn_fn(m_ti.m_fname, boost::format(Y("PTS error: 0x%|1$02x| %|2$02x|%|3$02x| %|4$02x|%|5$02x|\n")) % buf[0] % buf[1] % buf[2] % buf[3] % buf[4]);
+    else
+      pts = ((int64_t)((buf[0] & 0x0e) << 29 | buf[1] << 22 | (buf[2] & 0xfe) << 14 | buf[3] << 7 | (buf[4] >> 1))) * 100000 / 9;
+  }
+
+  m_sub_file->setFilePointer2(dataidx, seek_beginning);
+  auto packet_aid = m_sub_file->getch();
+  if (0 > packet_aid) {
+    mxwarn_fn(m_ti.m_fname, boost::format(Y("Bogus aid %1%\n")) % packet_aid);
+    return finish_scan();
+  }
+
+  uint32_t packet_size = len - (m_sub_file->getFilePointer() - pes_start);
+
+  mxverb(3, boost::format("vobsub_reader: sub packet data: aid: %1%, pts: %2%, packet_size: %3%\n") % packet_aid % format_timestamp(pts, 3) % packet_size);
+
+  add_to_assembled_spus(position, packet_aid, packet_size);
+}
+
+void
+vobsub_reader_c::add_to_assembled_spus(uint64_t position,
+                                       int aid,
+                                       uint32_t packet_size) {
+  unsigned char const *payload = nullptr;
+
+  for (auto track : m_assembling_tracks) {
+    if (   (track->assembly_idx >= track->entries.size())
+        || (static_cast<uint64_t>(track->entries[track->assembly_idx].position) > position))
+      continue;
+
+    if (-1 == track->aid)
+      track->aid = aid;
+    else if (track->aid != aid)
+      continue;
+
+    auto extra_size     = hack_engaged(ENGAGE_VOBSUB_SUBPIC_STOP_CMDS) ? 6 : 0;
+    track->assembly_buf = saferealloc(track->assembly_buf, track->assembly_size + packet_size + extra_size);
+    auto data           = track->assembly_buf + track->assembly_size;
+
+    // Space for the stop display command and padding
+    memset(data + packet_size, 0xff, extra_size);
+
+    // The payload is only read once even if several tracks share the
+    // same aid. It stays valid after its SPU has been finished.
+    if (payload)
+      memcpy(data, payload, packet_size);
+
+    else if (m_sub_file->read(data, packet_size) != packet_size) {
+      mxwarn(Y("vobsub_reader: sub file read failure"));
+      return finish_scan();
+
+    } else
+      payload = data;
+
+    track->assembly_size += packet_size;
+    track->spu_size      += packet_size;
+
+    if (!track->assembly_spu_len_valid && (2 <= track->assembly_size)) {
+      track->assembly_spu_len       = get_uint16_be(track->assembly_buf);
+      track->assembly_spu_len_valid = true;
+    }
+
+    if (track->assembly_spu_len_valid && (track->assembly_size >= track->assembly_spu_len))
+      finish_spu(*track, m_sub_file->getFilePointer());
+  }
+
+  if (!payload) {
+    mxverb(3, boost::format("vobsub_reader: skipping sub packet with aid %1% with size %2% at %3%\n") % aid % packet_size % m_sub_file->getFilePointer());
+    m_sub_file->skip(packet_size);
+  }
+}
+
+void
+vobsub_reader_c::update_assembly_ranges(uint64_t position) {
+  for (auto track : m_assembling_tracks)
+    while (track->assembly_idx < track->entries.size()) {
+      auto next_idx = track->assembly_idx + 1;
+      auto end_pos  = next_idx < track->entries.size() ? static_cast<uint64_t>(track->entries[next_idx].position) : static_cast<uint64_t>(m_sub_file->get_size());
+
+      if (position < end_pos)
+        break;
+
+      finish_spu(*track, position);
+    }
+}
+
+void
+vobsub_reader_c::finish_started_spus(uint64_t position) {
+  for (auto track : m_assembling_tracks)
+    if (   (track->assembly_idx < track->entries.size())
+        && (static_cast<uint64_t>(track->entries[track->assembly_idx].position) <= position))
+      finish_spu(*track, position);
+}
+
+void
+vobsub_reader_c::finish_spu(vobsub_track_c &track,
+                            uint64_t position) {
+  if (!track.assembly_buf)
+    track.spus.push_back(memory_cptr{});
+
+  else {
+    if (track.assembly_size != track.assembly_spu_len)
+      mxverb(3,
+             boost::format("r_vobsub.cpp: stddeliver spu_len different from dst_size; spu_len %1% dst_size %2% curpos %3%\n")
+             % track.assembly_spu_len % track.assembly_size % position);
+    if (2 < track.assembly_size)
+      put_uint16_be(track.assembly_buf, track.assembly_size);
+
+    auto consumed   = position - std::min<uint64_t>(position, track.entries[track.assembly_idx].position);
+    track.overhead += consumed - std::min<uint64_t>(consumed, track.assembly_size);
+
+    track.spus.push_back(memory_cptr{new memory_c(track.assembly_buf, track.assembly_size, true)});
+  }
+
+  track.assembly_buf           = nullptr;
+  track.assembly_size          = 0;
+  track.assembly_spu_len       = 0;
+  track.assembly_spu_len_valid = false;
+  ++track.assembly_idx;
+}
+
+void
+vobsub_reader_c::finish_scan() {
+  finish_started_spus(m_sub_file->get_size());
+  m_scan_done = true;
+}
+
 file_status_e
 vobsub_reader_c::read(generic_packetizer_c *ptzr,
                       bool) {
@@ -637,7 +929,10 @@ vobsub_reader_c::read(generic_packetizer_c *ptzr,
   if (track->idx >= track->entries.size())
     return flush_packetizers();
 
-  extract_one_spu_packet(id);
+  if (track->in_file_order)
+    deliver_assembled_spu(id);
+  else
+    extract_one_spu_packet(id);
   track->idx++;
   indices_processed++;
 
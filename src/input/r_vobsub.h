@@ -39,6 +39,16 @@ public:
   bool mpeg_version_warning_printed;
   int64_t packet_num, spu_size, overhead;
 
+  // State of the SPU currently being assembled while the .sub file is
+  // scanned in file order. Completed SPUs (or null pointers for
+  // entries without data) are queued in 'spus' in index order.
+  bool in_file_order;
+  unsigned int assembly_idx;
+  unsigned char *assembly_buf;
+  uint32_t assembly_size, assembly_spu_len;
+  bool assembly_spu_len_valid;
+  std::deque<memory_cptr> spus;
+
 public:
   vobsub_track_c(const std::string &new_language):
     language(new_language),
@@ -48,19 +58,31 @@ public:
     mpeg_version_warning_printed(false),
     packet_num(0),
     spu_size(0),
-    overhead(0) {
+    overhead(0),
+    in_file_order(false),
+    assembly_idx(0),
+    assembly_buf(nullptr),
+    assembly_size(0),
+    assembly_spu_len(0),
+    assembly_spu_len_valid(false) {
+  }
+
+  ~vobsub_track_c() {
+    safefree(assembly_buf);
   }
 };
 
 class vobsub_reader_c: public generic_reader_c {
 private:
   mm_text_io_cptr m_idx_file;
-  mm_file_io_cptr m_sub_file;
+  mm_io_cptr m_sub_file;
   int version;
   int64_t num_indices, indices_processed, delay;
   std::string idx_data;
 
-  std::vector<vobsub_track_c *> tracks;
+  std::vector<vobsub_track_c *> tracks, m_assembling_tracks;
+  uint64_t m_scan_pos;
+  bool m_scan_done, m_mpeg_version_warning_printed;
 
 private:
   static const std::string id_string;
@@ -92,6 +114,15 @@ protected:
   virtual int deliver_packet(unsigned char *buf, int size, int64_t timecode, int64_t default_duration, generic_packetizer_c *ptzr);
 
   virtual int extract_one_spu_packet(int64_t track_id);
+  virtual void deliver_assembled_spu(int64_t track_id);
+
+  virtual void scan_next_start_code();
+  virtual void scan_spu_packet(uint64_t position);
+  virtual void add_to_assembled_spus(uint64_t position, int aid, uint32_t packet_size);
+  virtual void update_assembly_ranges(uint64_t position);
+  virtual void finish_started_spus(uint64_t position);
+  virtual void finish_spu(vobsub_track_c &track, uint64_t position);
+  virtual void finish_scan();
 };
 
 #endif  // MTX_R_VOBSUB_H
@@ -17,6 +17,7 @@
 #include "common/ebml.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/memory_accounting.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
 #include "common/translation.h"
@@ -34,7 +35,10 @@
 #include <matroska/KaxCuesData.h>
 #include <matroska/KaxSeekHead.h>
 
+static auto &s_cluster_memory = mtx::memory_accounting::component("cluster");
+
 cluster_helper_c::impl_t::~impl_t() {
+  s_cluster_memory.remove(cluster_content_size);
 }
 
 cluster_helper_c::cluster_helper_c()
@@ -262,6 +266,7 @@ cluster_helper_c::add_packet(packet_cptr packet) {
 
   m->packets.push_back(packet);
   m->cluster_content_size += packet->data->get_size();
+  s_cluster_memory.add(packet->data->get_size());
 
   if (packet->assigned_timecode > m->max_timecode_in_cluster)
     m->max_timecode_in_cluster = packet->assigned_timecode;
@@ -284,6 +289,8 @@ cluster_helper_c::get_timecode() {
 
 void
 cluster_helper_c::prepare_new_cluster() {
+  s_cluster_memory.remove(m->cluster_content_size);
+
   m->cluster.reset(new kax_cluster_c);
   m->cluster_content_size = 0;
   m->packets.clear();
@@ -549,9 +556,15 @@ cluster_helper_c::render() {
       m->cluster->set_min_timecode(min_cl_timecode - timecode_offset);
       m->cluster->set_max_timecode(max_cl_timecode - timecode_offset);
 
+      if (g_streaming_output)
+        finish_streaming_headers();
+
       m->cluster->Render(*m->out, cues);
       m->bytes_in_file += m->cluster->ElementSize();
 
+      if (g_streaming_output)
+        m->out->flush();
+
       if (g_kax_sh_cues)
         g_kax_sh_cues->IndexThis(*m->cluster, *g_kax_segment);
 
@@ -679,9 +692,22 @@ cluster_helper_c::split_mode_produces_many_files()
   return false;
 }
 
+int64_t
+cluster_helper_c::get_current_split_size()
+  const {
+  if (   (m->split_points.end() == m->current_split_point)
+      || (split_point_c::size   != m->current_split_point->m_type))
+    return 0;
+
+  return m->current_split_point->m_point;
+}
+
 void
 cluster_helper_c::discard_queued_packets() {
+  s_cluster_memory.remove(m->cluster_content_size);
+
   m->packets.clear();
+  m->cluster_content_size = 0;
 }
 
 void
@@ -692,6 +718,12 @@ cluster_helper_c::dump_split_points()
              % boost::accumulate(m->split_points, std::string(""), [](std::string const &accu, split_point_c const &point) { return accu + " " + point.str(); }));
 }
 
+std::vector<split_point_c> const &
+cluster_helper_c::get_split_points()
+  const {
+  return m->split_points;
+}
+
 void
 cluster_helper_c::create_tags_for_track_statistics(KaxTags &tags,
                                                    std::string const &writing_app,
@@ -65,8 +65,10 @@ public:
 
   void add_split_point(split_point_c const &split_point);
   void dump_split_points() const;
+  std::vector<split_point_c> const &get_split_points() const;
   bool splitting() const;
   bool split_mode_produces_many_files() const;
+  int64_t get_current_split_size() const;
 
   bool discarding() const;
 
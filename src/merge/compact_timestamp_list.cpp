@@ -0,0 +1,92 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a memory-efficient list of timestamps
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/compact_timestamp_list.h"
+
+void
+compact_timestamp_list_c::add(int64_t timestamp) {
+  if (!(m_writer.m_num_entries % s_checkpoint_interval))
+    m_checkpoints.push_back(m_writer);
+
+  // All calculations are done with unsigned integers so that
+  // overflows wrap around identically when decoding.
+  auto delta        = static_cast<uint64_t>(timestamp) - m_writer.m_value;
+  auto change       = delta - m_writer.m_delta;
+  auto zigzag       = (change << 1) ^ (0 - (change >> 63));
+
+  do {
+    auto byte       = static_cast<unsigned char>(zigzag & 0x7f);
+    zigzag        >>= 7;
+    m_data.push_back(byte | (zigzag ? 0x80 : 0x00));
+  } while (zigzag);
+
+  m_writer.m_value  = timestamp;
+  m_writer.m_delta  = delta;
+  m_writer.m_offset = m_data.size();
+  ++m_writer.m_num_entries;
+}
+
+void
+compact_timestamp_list_c::decode_next(state_t &state)
+  const {
+  uint64_t zigzag = 0;
+  auto shift      = 0u;
+  auto data       = &m_data[state.m_offset];
+
+  while (true) {
+    auto byte  = *data++;
+    zigzag    |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    shift     += 7;
+
+    if (!(byte & 0x80))
+      break;
+  }
+
+  state.m_delta  += (zigzag >> 1) ^ (0 - (zigzag & 1));
+  state.m_value  += state.m_delta;
+  state.m_offset  = data - m_data.data();
+  ++state.m_num_entries;
+}
+
+int64_t
+compact_timestamp_list_c::get(std::size_t idx) {
+  assert(idx < size());
+
+  if (m_reader.m_num_entries == (idx + 1))
+    return m_reader.m_value;
+
+  if (   (m_reader.m_num_entries > idx)
+      || ((idx - m_reader.m_num_entries) >= s_checkpoint_interval))
+    m_reader = m_checkpoints[idx / s_checkpoint_interval];
+
+  while (m_reader.m_num_entries <= idx)
+    decode_next(m_reader);
+
+  return m_reader.m_value;
+}
+
+int64_t
+compact_timestamp_list_c::back()
+  const {
+  assert(!empty());
+
+  return m_writer.m_value;
+}
+
+std::size_t
+compact_timestamp_list_c::get_memory_usage()
+  const {
+  return m_data.capacity() + m_checkpoints.capacity() * sizeof(state_t);
+}
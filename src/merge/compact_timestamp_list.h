@@ -0,0 +1,71 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   class definition for a memory-efficient list of timestamps
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_COMPACT_TIMESTAMP_LIST_H
+#define MTX_MERGE_COMPACT_TIMESTAMP_LIST_H
+
+#include "common/common_pch.h"
+
+/** \brief A list of timestamps stored as variable-length deltas
+
+   External timestamp files for variable frame rate content can
+   contain millions of entries. Most of the time the difference
+   between two consecutive timestamps is constant or changes only
+   slightly. Therefore only the change of that difference is stored
+   for each entry, encoded as a variable-length integer. That usually
+   requires one or two bytes per entry instead of eight.
+
+   An absolute checkpoint is stored every \c s_checkpoint_interval
+   entries. Random access decodes at most that many entries starting
+   at the closest checkpoint. Sequential access continues from the
+   previously accessed entry and is therefore O(1).
+
+   The timestamps don't have to be sorted (e.g. for timestamp files
+   in format v4).
+*/
+class compact_timestamp_list_c {
+public:
+  static std::size_t const s_checkpoint_interval = 64;
+
+protected:
+  // m_value and m_delta belong to the entry at index m_num_entries -
+  // 1; m_offset is the position of the following entry in m_data.
+  struct state_t {
+    std::size_t m_offset{}, m_num_entries{};
+    uint64_t m_value{}, m_delta{};
+  };
+
+  std::vector<unsigned char> m_data;
+  std::vector<state_t> m_checkpoints;
+  state_t m_writer, m_reader;
+
+public:
+  void add(int64_t timestamp);
+  int64_t get(std::size_t idx);
+  int64_t back() const;
+
+  std::size_t size() const {
+    return m_writer.m_num_entries;
+  }
+
+  bool empty() const {
+    return !m_writer.m_num_entries;
+  }
+
+  std::size_t get_memory_usage() const;
+
+protected:
+  void decode_next(state_t &state) const;
+};
+
+#endif  // MTX_MERGE_COMPACT_TIMESTAMP_LIST_H
@@ -13,11 +13,15 @@
 
 #include "common/common_pch.h"
 
+#include <numeric>
+#include <queue>
+
 #include "common/debugging.h"
 #include "common/ebml.h"
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/strings/parsing.h"
 #include "merge/cluster_helper.h"
 #include "merge/cues.h"
 #include "merge/generic_packetizer.h"
@@ -26,13 +30,66 @@
 
 cues_cptr cues_c::s_cues;
 
+// Number of cue points read from the temporary file in one go per
+// sorted run during the final merge.
+#define CUES_MERGE_BUFFER_SIZE 16384
+
+static bool
+cue_point_less(cue_point_t const &a,
+               cue_point_t const &b) {
+  if (a.timecode < b.timecode)
+    return true;
+  if (a.timecode > b.timecode)
+    return false;
+
+  return a.track_num < b.track_num;
+}
+
+template<typename T>
+bool
+id_timecode_less(T const &a,
+                 T const &b) {
+  return (a.id < b.id) || ((a.id == b.id) && (a.timecode < b.timecode));
+}
+
+// Advances 'itr' over all entries sorted before <id, timecode> and
+// returns the first entry matching it, or nullptr if there's none. A
+// matching entry is consumed so that the next lookup for the same key
+// returns the following one.
+template<typename I>
+typename I::value_type const *
+consume_next_match(I &itr,
+                   I const &end,
+                   uint64_t id,
+                   uint64_t timecode) {
+  while ((itr != end) && ((itr->id < id) || ((itr->id == id) && (itr->timecode < timecode))))
+    ++itr;
+
+  if ((itr == end) || (itr->id != id) || (itr->timecode != timecode))
+    return nullptr;
+
+  return &*itr++;
+}
+
 cues_c::cues_c()
-  : m_num_cue_points_postprocessed{}
+  : m_max_points_in_memory{1024 * 1024}
+  , m_num_cue_points_postprocessed{}
   , m_no_cue_duration{hack_engaged(ENGAGE_NO_CUE_DURATION)}
   , m_no_cue_relative_position{hack_engaged(ENGAGE_NO_CUE_RELATIVE_POSITION)}
   , m_debug_cue_duration{         "cues|cues_cue_duration"}
   , m_debug_cue_relative_position{"cues|cues_cue_relative_position"}
+  , m_debug_spill{                "cues|cues_spill"}
 {
+  std::string arg;
+  if (debugging_c::requested("cues_spill_threshold", &arg)) {
+    auto threshold = uint64_t{};
+    if (parse_number(arg, threshold) && threshold)
+      m_max_points_in_memory = threshold;
+  }
+}
+
+cues_c::~cues_c() {
+  remove_spill_file();
 }
 
 void
@@ -40,7 +97,7 @@ cues_c::set_duration_for_id_timecode(uint64_t id,
                                      uint64_t timecode,
                                      uint64_t duration) {
   if (!m_no_cue_duration)
-    m_id_timecode_duration_multimap.insert({ id_timecode_t{id, timecode}, duration });
+    m_id_timecode_durations.push_back({ id, timecode, duration });
 }
 
 void
@@ -75,13 +132,9 @@ cues_c::add(KaxCuePoint &point) {
 void
 cues_c::write(mm_io_c &out,
               KaxSeekHead &seek_head) {
-  if (!m_points.size() || !g_cue_writing_requested)
+  if ((m_points.empty() && m_spilled_runs.empty()) || !g_cue_writing_requested)
     return;
 
-  // auto start = mtx::sys::get_current_time_millis();
-  sort();
-  // auto end_sort = mtx::sys::get_current_time_millis();
-
   // Need to write the (empty) cues element so that its position will
   // be set for indexing in g_kax_sh_main. Necessary because there's
   // no API function to force the position to a certain value; nor is
@@ -100,7 +153,7 @@ cues_c::write(mm_io_c &out,
   auto total_size = calculate_total_size();
   write_ebml_element_head(out, EBML_ID(KaxCues), total_size);
 
-  for (auto &point : m_points) {
+  for_each_sorted_point([this, &out](cue_point_t const &point) {
     KaxCuePoint kc_point;
 
     GetChild<KaxCueTime>(kc_point).SetValue(point.timecode / g_timecode_scale);
@@ -120,130 +173,231 @@ cues_c::write(mm_io_c &out,
       GetChild<KaxCueDuration>(positions).SetValue(RND_TIMECODE_SCALE(point.duration) / g_timecode_scale);
 
     kc_point.Render(out);
-  }
+  });
 
   m_points.clear();
   m_codec_state_position_map.clear();
   m_num_cue_points_postprocessed = 0;
 
-  // auto end_all = mtx::sys::get_current_time_millis();
-  // mxinfo(boost::format("dur sort %1% write %2% total %3%\n") % (end_sort - start) % (end_all - end_sort) % (end_all - start));
+  remove_spill_file();
 }
 
 void
 cues_c::sort() {
-  brng::sort(m_points, [](cue_point_t const &a, cue_point_t const &b) -> bool {
-      if (a.timecode < b.timecode)
-        return true;
-      if (a.timecode > b.timecode)
-        return false;
+  brng::sort(m_points, cue_point_less);
+}
 
-      if (a.track_num < b.track_num)
-        return true;
+void
+cues_c::spill_points() {
+  if (m_points.empty())
+    return;
 
-      return false;
-    });
+  if (!m_spill_file) {
+    m_spill_file_name = (bfs::temp_directory_path() / bfs::unique_path("mkvmerge-cues-%%%%-%%%%-%%%%-%%%%.tmp")).string();
+
+    try {
+      m_spill_file = std::make_shared<mm_file_io_c>(m_spill_file_name, MODE_CREATE);
+    } catch (mtx::mm_io::exception &ex) {
+      mxerror(boost::format(Y("The temporary file '%1%' for storing the cues could not be created: %2%\n")) % m_spill_file_name % ex);
+    }
+  }
+
+  sort();
+
+  auto file_position = m_spill_file->get_size();
+  auto num_bytes     = m_points.size() * sizeof(cue_point_t);
+
+  m_spill_file->setFilePointer(file_position);
+  if (m_spill_file->write(m_points.data(), num_bytes) != num_bytes)
+    mxerror(boost::format(Y("Could not write to the temporary file '%1%' for storing the cues.\n")) % m_spill_file_name);
+
+  m_spilled_runs.push_back({ file_position, m_points.size(), m_position_adjustments.size() });
+
+  mxdebug_if(m_debug_spill, boost::format("cues_c::spill_points: run %1% with %2% points at %3%\n") % (m_spilled_runs.size() - 1) % m_points.size() % file_position);
+
+  m_points.clear();
+  m_points.shrink_to_fit();
+  m_num_cue_points_postprocessed = 0;
 }
 
-std::multimap<id_timecode_t, uint64_t>
-cues_c::calculate_block_positions(KaxCluster &cluster)
-  const {
+void
+cues_c::remove_spill_file() {
+  m_spilled_runs.clear();
+  m_position_adjustments.clear();
 
-  std::multimap<id_timecode_t, uint64_t> positions;
+  if (!m_spill_file)
+    return;
 
-  for (auto child : cluster) {
-    auto simple_block = dynamic_cast<KaxSimpleBlock *>(child);
-    if (simple_block) {
-      simple_block->SetParent(cluster);
-      positions.insert({ id_timecode_t{ simple_block->TrackNum(), simple_block->GlobalTimecode()}, simple_block->GetElementPosition() });
-      continue;
-    }
+  m_spill_file.reset();
 
-    auto block_group = dynamic_cast<KaxBlockGroup *>(child);
-    if (!block_group)
-      continue;
+  boost::system::error_code ec;
+  bfs::remove(bfs::path{m_spill_file_name}, ec);
+}
 
-    auto block = FindChild<KaxBlock>(block_group);
-    if (!block)
-      continue;
+void
+cues_c::for_each_sorted_point(std::function<void(cue_point_t const &)> const &worker) {
+  sort();
 
-    block->SetParent(cluster);
-    positions.insert({ id_timecode_t{ block->TrackNum(), block->GlobalTimecode()}, block_group->GetElementPosition() });
+  if (m_spilled_runs.empty()) {
+    for (auto const &point : m_points)
+      worker(point);
+    return;
   }
 
-  return positions;
+  // k-way merge of the sorted runs in the temporary file and the
+  // sorted points still held in memory. Each run is read back in
+  // small chunks so that memory usage stays bounded.
+  struct run_reader_t {
+    cue_point_t const *current, *end;
+    std::vector<cue_point_t> buffer;
+    uint64_t file_position, num_points_left;
+    size_t first_position_adjustment;
+  };
+
+  auto readers = std::vector<run_reader_t>{};
+
+  auto refill = [this](run_reader_t &reader) -> bool {
+    if (!reader.num_points_left)
+      return false;
+
+    auto num_points = std::min<uint64_t>(reader.num_points_left, CUES_MERGE_BUFFER_SIZE);
+    auto num_bytes  = num_points * sizeof(cue_point_t);
+
+    reader.buffer.resize(num_points);
+    m_spill_file->setFilePointer(reader.file_position);
+    if (m_spill_file->read(reader.buffer.data(), num_bytes) != num_bytes)
+      mxerror(boost::format(Y("Could not read from the temporary file '%1%' for storing the cues.\n")) % m_spill_file_name);
+
+    // Position adjustments that happened after the run was written
+    // must be applied in the same order they were made.
+    for (auto &point : reader.buffer)
+      for (auto idx = reader.first_position_adjustment, num_adjustments = m_position_adjustments.size(); idx < num_adjustments; ++idx)
+        if (point.cluster_position >= m_position_adjustments[idx].first)
+          point.cluster_position += m_position_adjustments[idx].second;
+
+    reader.file_position   += num_bytes;
+    reader.num_points_left -= num_points;
+    reader.current          = reader.buffer.data();
+    reader.end              = reader.current + num_points;
+
+    return true;
+  };
+
+  readers.reserve(m_spilled_runs.size() + 1);
+
+  for (auto const &run : m_spilled_runs) {
+    readers.push_back({ nullptr, nullptr, {}, run.file_position, run.num_points, run.first_position_adjustment });
+    refill(readers.back());
+  }
+
+  if (!m_points.empty())
+    readers.push_back({ m_points.data(), m_points.data() + m_points.size(), {}, 0, 0, 0 });
+
+  auto greater = [&readers](size_t a, size_t b) { return cue_point_less(*readers[b].current, *readers[a].current); };
+  auto heap    = std::priority_queue<size_t, std::vector<size_t>, decltype(greater)>{greater};
+
+  for (auto idx = 0u; idx < readers.size(); ++idx)
+    if (readers[idx].current != readers[idx].end)
+      heap.push(idx);
+
+  while (!heap.empty()) {
+    auto idx     = heap.top();
+    auto &reader = readers[idx];
+
+    heap.pop();
+
+    worker(*reader.current);
+
+    ++reader.current;
+    if ((reader.current != reader.end) || refill(reader))
+      heap.push(idx);
+  }
 }
 
 void
 cues_c::postprocess_cues(KaxCues &cues,
-                         KaxCluster &cluster) {
+                         kax_cluster_c &cluster) {
+  // All points currently held in memory have been post-processed
+  // already. Move them to the temporary file if there are too many.
+  if (m_points.size() >= m_max_points_in_memory)
+    spill_points();
+
   add(cues);
 
   if (m_no_cue_duration && m_no_cue_relative_position)
     return;
 
+  // The n-th cue point for a given track number & timecode belongs to
+  // the n-th block and the n-th duration with the same track number &
+  // timecode. Sort all three by track number & timecode while keeping
+  // their relative order and match them in a single pass.
   auto cluster_data_start_pos = cluster.GetElementPosition() + cluster.HeadSize();
-  auto block_positions        = calculate_block_positions(cluster);
-  std::map<id_timecode_t, size_t> nblocks_processed; //# blocks processed so far with given track #/timecode
+  auto block_positions        = cluster.get_block_positions();
+  auto point_indexes          = std::vector<size_t>(m_points.size() - m_num_cue_points_postprocessed);
 
-  for (auto point = m_points.begin() + m_num_cue_points_postprocessed, end = m_points.end(); point != end; ++point) {
-    nblocks_processed[id_timecode_t{ point->track_num, point->timecode }]++;
+  std::iota(point_indexes.begin(), point_indexes.end(), m_num_cue_points_postprocessed);
+  std::stable_sort(point_indexes.begin(), point_indexes.end(), [this](size_t a, size_t b) {
+    return (m_points[a].track_num < m_points[b].track_num) || ((m_points[a].track_num == m_points[b].track_num) && (m_points[a].timecode < m_points[b].timecode));
+  });
 
-    // Set CueRelativePosition for all cues.
-    if (!m_no_cue_relative_position) {
-      auto pair          = block_positions.equal_range({ point->track_num, point->timecode });
-      auto position_itr  = pair.first;
-      auto pos_end       = pair.second;
-      auto num_processed = nblocks_processed[id_timecode_t{ point->track_num, point->timecode }];
+  if (!m_no_cue_relative_position)
+    std::stable_sort(block_positions.begin(), block_positions.end(), id_timecode_less<id_timecode_position_t>);
+
+  if (!m_no_cue_duration)
+    std::stable_sort(m_id_timecode_durations.begin(), m_id_timecode_durations.end(), id_timecode_less<id_timecode_duration_t>);
 
-      for (auto i = 0u; ((i + 1) < num_processed) && (position_itr != pos_end); ++i)
-        position_itr++;
+  auto position_itr = block_positions.cbegin(),        position_end = block_positions.cend();
+  auto duration_itr = m_id_timecode_durations.cbegin(), duration_end = m_id_timecode_durations.cend();
 
-      auto relative_position = block_positions.end() != position_itr ? std::max(position_itr->second, cluster_data_start_pos) - cluster_data_start_pos : 0ull;
+  for (auto idx : point_indexes) {
+    auto &point = m_points[idx];
+
+    // Set CueRelativePosition for all cues.
+    if (!m_no_cue_relative_position) {
+      auto block_position    = consume_next_match(position_itr, position_end, point.track_num, point.timecode);
+      auto relative_position = block_position ? std::max(block_position->position, cluster_data_start_pos) - cluster_data_start_pos : 0ull;
 
       assert(relative_position <= static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
 
-      point->relative_position = relative_position;
+      point.relative_position = relative_position;
 
       mxdebug_if(m_debug_cue_relative_position,
                  boost::format("cue_relative_position: looking for <%1%:%2%>: cluster_data_start_pos %3% position %4%\n")
-                 % point->track_num % point->timecode % cluster_data_start_pos % relative_position);
+                 % point.track_num % point.timecode % cluster_data_start_pos % relative_position);
     }
 
     // Set CueDuration if the packetizer wants them.
     if (m_no_cue_duration)
       continue;
 
-    auto pair          = m_id_timecode_duration_multimap.equal_range({ point->track_num, point->timecode });
-    auto duration_itr  = pair.first;
-    auto dur_end       = pair.second;
-    auto num_processed = nblocks_processed[id_timecode_t{ point->track_num, point->timecode }];
-
-    for (auto i = 0u; ((i + 1) < num_processed) && (duration_itr != dur_end); ++i)
-      duration_itr++;
-
-    auto ptzr         = g_packetizers_by_track_num[point->track_num];
+    auto duration = consume_next_match(duration_itr, duration_end, point.track_num, point.timecode);
+    auto ptzr     = g_packetizers_by_track_num[point.track_num];
 
     if (!ptzr || !ptzr->wants_cue_duration())
       continue;
 
-    if (m_id_timecode_duration_multimap.end() != duration_itr)
-      point->duration = duration_itr->second;
+    if (duration)
+      point.duration = duration->duration;
 
     mxdebug_if(m_debug_cue_duration,
                boost::format("cue_duration: looking for <%1%:%2%>: %3%\n")
-               % point->track_num % point->timecode % (duration_itr == m_id_timecode_duration_multimap.end() ? static_cast<int64_t>(-1) : duration_itr->second));
+               % point.track_num % point.timecode % (!duration ? static_cast<int64_t>(-1) : static_cast<int64_t>(duration->duration)));
   }
 
   m_num_cue_points_postprocessed = m_points.size();
 
-  m_id_timecode_duration_multimap.clear();
+  m_id_timecode_durations.clear();
 }
 
 uint64_t
-cues_c::calculate_total_size()
-  const {
-  return boost::accumulate(m_points, 0ull, [this](uint64_t sum, cue_point_t const &point) { return sum + calculate_point_size(point); });
+cues_c::calculate_total_size() {
+  auto total_size = uint64_t{};
+
+  for_each_sorted_point([this, &total_size](cue_point_t const &point) {
+    total_size += calculate_point_size(point);
+  });
+
+  return total_size;
 }
 
 uint64_t
@@ -282,7 +436,7 @@ cues_c::adjust_positions(uint64_t old_position,
                          uint64_t delta) {
   auto s_debug_rerender_track_headers = debugging_option_c{"rerender|rerender_track_headers"};
 
-  if (!delta || (m_points.empty() && m_codec_state_position_map.empty()))
+  if (!delta || (m_points.empty() && m_spilled_runs.empty() && m_codec_state_position_map.empty()))
     return;
 
   mxdebug_if(s_debug_rerender_track_headers,
@@ -293,6 +447,11 @@ cues_c::adjust_positions(uint64_t old_position,
     if (point.cluster_position >= old_position)
       point.cluster_position += delta;
 
+  // Points already written to the temporary file are adjusted when
+  // they're read back during the final merge.
+  if (!m_spilled_runs.empty())
+    m_position_adjustments.emplace_back(old_position, delta);
+
   for (auto &element : m_codec_state_position_map)
     if (element.second >= old_position)
       element.second += delta;
@@ -21,6 +21,7 @@
 #include <matroska/KaxSeekHead.h>
 
 #include "common/mm_io.h"
+#include "merge/libmatroska_extensions.h"
 
 using id_timecode_t = std::pair<uint64_t, uint64_t>;
 
@@ -29,29 +30,47 @@ struct cue_point_t {
   uint32_t track_num, relative_position;
 };
 
+struct id_timecode_duration_t {
+  uint64_t id, timecode, duration;
+};
+
+struct cue_point_run_t {
+  uint64_t file_position, num_points;
+  size_t first_position_adjustment;
+};
+
 class cues_c;
 using cues_cptr = std::shared_ptr<cues_c>;
 
 class cues_c {
 protected:
   std::vector<cue_point_t> m_points;
-  std::multimap<id_timecode_t, uint64_t> m_id_timecode_duration_multimap;
+  std::vector<id_timecode_duration_t> m_id_timecode_durations;
   std::map<id_timecode_t, uint64_t> m_codec_state_position_map;
 
+  // Sorted runs of cue points that have been moved out of m_points
+  // into a temporary file in order to bound memory usage.
+  std::vector<cue_point_run_t> m_spilled_runs;
+  std::vector<std::pair<uint64_t, uint64_t> > m_position_adjustments;
+  mm_io_cptr m_spill_file;
+  std::string m_spill_file_name;
+  size_t m_max_points_in_memory;
+
   size_t m_num_cue_points_postprocessed;
   bool m_no_cue_duration, m_no_cue_relative_position;
-  debugging_option_c m_debug_cue_duration, m_debug_cue_relative_position;
+  debugging_option_c m_debug_cue_duration, m_debug_cue_relative_position, m_debug_spill;
 
 protected:
   static cues_cptr s_cues;
 
 public:
   cues_c();
+  ~cues_c();
 
   void add(KaxCues &cues);
   void add(KaxCuePoint &point);
   void write(mm_io_c &out, KaxSeekHead &seek_head);
-  void postprocess_cues(KaxCues &cues, KaxCluster &cluster);
+  void postprocess_cues(KaxCues &cues, kax_cluster_c &cluster);
   void set_duration_for_id_timecode(uint64_t id, uint64_t timecode, uint64_t duration);
   void adjust_positions(uint64_t old_position, uint64_t delta);
 
@@ -60,8 +79,10 @@ public:
 
 protected:
   void sort();
-  std::multimap<id_timecode_t, uint64_t> calculate_block_positions(KaxCluster &cluster) const;
-  uint64_t calculate_total_size() const;
+  void spill_points();
+  void remove_spill_file();
+  void for_each_sorted_point(std::function<void(cue_point_t const &)> const &worker);
+  uint64_t calculate_total_size();
   uint64_t calculate_point_size(cue_point_t const &point) const;
   uint64_t calculate_bytes_for_uint(uint64_t value) const;
 };
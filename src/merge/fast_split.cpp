@@ -0,0 +1,952 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   splitting Matroska files without re-packetizing their content
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include <ebml/EbmlCrc32.h>
+#include <ebml/EbmlStream.h>
+#include <ebml/EbmlVersion.h>
+#include <ebml/EbmlVoid.h>
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+#include <matroska/KaxCuesData.h>
+#include <matroska/KaxInfoData.h>
+#include <matroska/KaxSeekHead.h>
+#include <matroska/KaxSegment.h>
+#include <matroska/KaxTag.h>
+#include <matroska/KaxTrackEntryData.h>
+#include <matroska/KaxVersion.h>
+
+#include "common/chapters/chapters.h"
+#include "common/checksums/base.h"
+#include "common/command_line.h"
+#include "common/date_time.h"
+#include "common/ebml.h"
+#include "common/fs_sys_helpers.h"
+#include "common/hacks.h"
+#include "common/iso639.h"
+#include "common/kax_analyzer.h"
+#include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
+#include "common/strings/formatting.h"
+#include "common/tags/tags.h"
+#include "common/version.h"
+#include "merge/fast_split.h"
+#include "merge/output_control.h"
+
+#define FAST_SPLIT_SEEK_HEAD_SIZE       4096
+#define FAST_SPLIT_WRITE_BUFFER_SIZE    (1024 * 1024)
+#define FAST_SPLIT_ELEMENT_HEAD_SIZE    12
+
+namespace {
+
+class invalid_cluster_x: public mtx::exception {
+protected:
+  std::string m_message;
+
+public:
+  invalid_cluster_x(std::string const &message)
+    : m_message{message}
+  {
+  }
+  virtual ~invalid_cluster_x() throw() { }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+struct element_head_t {
+  uint32_t m_id{};
+  uint64_t m_size{};
+  unsigned int m_head_size{}, m_size_length{};
+  bool m_size_unknown{};
+};
+
+bool
+parse_element_head(unsigned char const *buffer,
+                   std::size_t available,
+                   element_head_t &head) {
+  if (!available)
+    return false;
+
+  auto id_length = 1u;
+  while ((id_length <= 4) && !(buffer[0] & (0x100 >> id_length)))
+    ++id_length;
+
+  if ((4 < id_length) || (available < (id_length + 1)))
+    return false;
+
+  auto size_length = 1u;
+  while ((size_length <= 8) && !(buffer[id_length] & (0x100 >> size_length)))
+    ++size_length;
+
+  if ((8 < size_length) || (available < (id_length + size_length)))
+    return false;
+
+  head.m_id = 0;
+  for (auto idx = 0u; idx < id_length; ++idx)
+    head.m_id = (head.m_id << 8) | buffer[idx];
+
+  head.m_size = buffer[id_length] & (0xff >> size_length);
+  for (auto idx = 1u; idx < size_length; ++idx)
+    head.m_size = (head.m_size << 8) | buffer[id_length + idx];
+
+  head.m_size_unknown = head.m_size == ((1ull << (7 * size_length)) - 1);
+  head.m_head_size    = id_length + size_length;
+  head.m_size_length  = size_length;
+
+  return true;
+}
+
+bool
+read_element_head(mm_io_c &in,
+                  uint64_t position,
+                  element_head_t &head) {
+  unsigned char buffer[FAST_SPLIT_ELEMENT_HEAD_SIZE];
+
+  in.setFilePointer(position);
+  auto num_read = in.read(buffer, FAST_SPLIT_ELEMENT_HEAD_SIZE);
+
+  return parse_element_head(buffer, num_read, head);
+}
+
+void
+overwrite_with_void(unsigned char *buffer,
+                    uint64_t total_size) {
+  std::memset(buffer, 0, total_size);
+
+  buffer[0] = EBML_ID_VALUE(EBML_ID(EbmlVoid));
+
+  if ((total_size - 2) < 0x7f) {
+    buffer[1] = 0x80 | (total_size - 2);
+    return;
+  }
+
+  buffer[1] = 0x01;
+  put_uint_be(&buffer[2], total_size - 9, 7);
+}
+
+/** \brief Rebases a cluster's timecode in place
+
+   The new timecode is written with the same number of bytes as the
+   old one. Elements whose values would become invalid (\c Position and
+   \c PrevSize) are replaced by \c EbmlVoid elements of the same size.
+   The cluster therefore keeps its size, and all positions inside it
+   remain valid.
+
+   \return the cluster's new timecode
+*/
+int64_t
+rebase_cluster(unsigned char *buffer,
+               uint64_t size,
+               int64_t offset) {
+  auto position = 0ull;
+  auto timecode = int64_t{-1};
+
+  while (position < size) {
+    element_head_t head;
+    if (!parse_element_head(&buffer[position], size - position, head) || head.m_size_unknown || ((position + head.m_head_size + head.m_size) > size))
+      throw invalid_cluster_x{Y("The cluster's child elements could not be parsed.")};
+
+    auto data = &buffer[position + head.m_head_size];
+
+    if (head.m_id == EBML_ID_VALUE(EBML_ID(KaxClusterTimecode))) {
+      if (!head.m_size || (8 < head.m_size))
+        throw invalid_cluster_x{Y("The cluster's timecode could not be parsed.")};
+
+      timecode = std::max<int64_t>(get_uint_be(data, head.m_size) - offset, 0);
+      put_uint_be(data, timecode, head.m_size);
+
+    } else if (   (head.m_id == EBML_ID_VALUE(EBML_ID(KaxClusterPosition)))
+               || (head.m_id == EBML_ID_VALUE(EBML_ID(KaxClusterPrevSize))))
+      overwrite_with_void(&buffer[position], head.m_head_size + head.m_size);
+
+    position += head.m_head_size + head.m_size;
+  }
+
+  if (-1 == timecode)
+    throw invalid_cluster_x{Y("The cluster doesn't contain a timecode.")};
+
+  return timecode;
+}
+
+/** \brief Updates the CRC-32 element of a modified cluster
+
+   A \c CRC-32 element must be the first child. Its checksum covers all
+   following children and is recalculated after the cluster has been
+   rebased or its blocks have been filtered.
+*/
+void
+update_cluster_crc32(unsigned char *buffer,
+                     uint64_t size) {
+  element_head_t head;
+  if (!parse_element_head(buffer, size, head) || (head.m_id != EBML_ID_VALUE(EBML_ID(EbmlCrc32))))
+    return;
+
+  auto crc_end = head.m_head_size + head.m_size;
+  if ((4 != head.m_size) || (crc_end > size))
+    throw invalid_cluster_x{Y("The cluster's CRC-32 element could not be parsed.")};
+
+  auto crc = 0xffffffff ^ mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::crc32_ieee_le, &buffer[crc_end], size - crc_end, 0xffffffff);
+  put_uint32_le(&buffer[head.m_head_size], crc);
+}
+
+/** \brief Changes the track number at the start of a block's data
+
+   The new number is written with the same number of bytes as the old
+   one. Therefore the block keeps its size.
+
+   \return \c false if the block's track isn't copied
+*/
+bool
+renumber_block(unsigned char *buffer,
+               uint64_t size,
+               std::unordered_map<uint64_t, uint64_t> const &track_numbers) {
+  if (!size)
+    throw invalid_cluster_x{Y("A block's track number could not be parsed.")};
+
+  auto length = 1u;
+  while ((length <= 8) && !(buffer[0] & (0x100 >> length)))
+    ++length;
+
+  if ((8 < length) || (size < length))
+    throw invalid_cluster_x{Y("A block's track number could not be parsed.")};
+
+  auto number = get_uint_be(buffer, length) & ((1ull << (7 * length)) - 1);
+  auto itr    = track_numbers.find(number);
+
+  if (itr == track_numbers.end())
+    return false;
+
+  put_uint_be(buffer, itr->second | (1ull << (7 * length)), length);
+
+  return true;
+}
+
+/** \brief Removes the positions of tracks that aren't copied from a cue point
+
+   The remaining positions are renumbered. Their relative positions and
+   block numbers become invalid once blocks are removed from the
+   clusters and are therefore removed, too.
+
+   \return \c false if no positions remain
+*/
+bool
+select_cue_track_positions(KaxCuePoint &point,
+                           std::unordered_map<uint64_t, uint64_t> const &track_numbers) {
+  for (auto idx = point.ListSize(); 0 < idx; --idx) {
+    auto positions = dynamic_cast<KaxCueTrackPositions *>(point[idx - 1]);
+    if (!positions)
+      continue;
+
+    auto &track = GetChild<KaxCueTrack>(*positions);
+    auto itr    = track_numbers.find(track.GetValue());
+
+    if (itr == track_numbers.end()) {
+      delete positions;
+      point.Remove(idx - 1);
+      continue;
+    }
+
+    track.SetValue(itr->second);
+    DeleteChildren<KaxCueRelativePosition>(positions);
+    DeleteChildren<KaxCueBlockNumber>(positions);
+  }
+
+  return !!FindChild<KaxCueTrackPositions>(point);
+}
+
+/** \brief Removes the blocks of tracks that aren't copied
+
+   Blocks of tracks contained in \c track_numbers are renumbered; all
+   other \c SimpleBlock and \c BlockGroup elements are removed by
+   moving the following elements to the front. The cluster is modified
+   in place.
+
+   \return the cluster's new size
+*/
+uint64_t
+filter_blocks(unsigned char *buffer,
+              uint64_t size,
+              std::unordered_map<uint64_t, uint64_t> const &track_numbers) {
+  auto position     = 0ull;
+  auto new_position = 0ull;
+
+  while (position < size) {
+    element_head_t head;
+    if (!parse_element_head(&buffer[position], size - position, head) || head.m_size_unknown || ((position + head.m_head_size + head.m_size) > size))
+      throw invalid_cluster_x{Y("The cluster's child elements could not be parsed.")};
+
+    auto data = &buffer[position + head.m_head_size];
+    auto keep = true;
+
+    if (head.m_id == EBML_ID_VALUE(EBML_ID(KaxSimpleBlock)))
+      keep = renumber_block(data, head.m_size, track_numbers);
+
+    else if (head.m_id == EBML_ID_VALUE(EBML_ID(KaxBlockGroup))) {
+      auto group_position = 0ull;
+      keep                = false;
+
+      while (group_position < head.m_size) {
+        element_head_t child_head;
+        if (!parse_element_head(&data[group_position], head.m_size - group_position, child_head) || child_head.m_size_unknown || ((group_position + child_head.m_head_size + child_head.m_size) > head.m_size))
+          throw invalid_cluster_x{Y("The block group's child elements could not be parsed.")};
+
+        if (child_head.m_id == EBML_ID_VALUE(EBML_ID(KaxBlock)))
+          keep = renumber_block(&data[group_position + child_head.m_head_size], child_head.m_size, track_numbers);
+
+        group_position += child_head.m_head_size + child_head.m_size;
+      }
+    }
+
+    auto element_size = head.m_head_size + head.m_size;
+
+    if (keep) {
+      if (new_position != position)
+        std::memmove(&buffer[new_position], &buffer[position], element_size);
+      new_position += element_size;
+    }
+
+    position += element_size;
+  }
+
+  return new_position;
+}
+
+}
+
+fast_splitter_c::fast_splitter_c(std::string const &file_name,
+                                 track_info_c const &ti,
+                                 std::vector<split_point_c> const &split_points,
+                                 int max_num_files)
+  : m_file_name{file_name}
+  , m_split_points{split_points}
+  , m_max_num_files{max_num_files}
+  , m_ti(ti)
+{
+}
+
+void
+fast_splitter_c::run() {
+  read_source();
+  select_tracks();
+  select_tags();
+  collect_boundaries();
+  create_parts();
+  prepare_headers();
+  write_parts();
+}
+
+void
+fast_splitter_c::read_source() {
+  auto analyzer = std::make_shared<kax_analyzer_c>(m_file_name);
+
+  try {
+    if (!analyzer->set_parse_mode(kax_analyzer_c::parse_mode_fast).set_open_mode(MODE_READ).set_throw_on_error(true).process())
+      throw mtx::kax_analyzer_x{Y("The file could not be analyzed.")};
+
+  } catch (mtx::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % m_file_name % ex.error());
+  }
+
+  m_info        = std::dynamic_pointer_cast<KaxInfo>(analyzer->read_all(EBML_INFO(KaxInfo)));
+  m_tracks      = std::dynamic_pointer_cast<KaxTracks>(analyzer->read_all(EBML_INFO(KaxTracks)));
+  m_cues        = std::dynamic_pointer_cast<KaxCues>(analyzer->read_all(EBML_INFO(KaxCues)));
+  m_chapters    = std::dynamic_pointer_cast<KaxChapters>(analyzer->read_all(EBML_INFO(KaxChapters)));
+  m_tags        = std::dynamic_pointer_cast<KaxTags>(analyzer->read_all(EBML_INFO(KaxTags)));
+  m_attachments = std::dynamic_pointer_cast<KaxAttachments>(analyzer->read_all(EBML_INFO(KaxAttachments)));
+
+  if (!m_info || !m_tracks)
+    mxerror(boost::format(Y("The file '%1%' does not contain segment information or track headers.\n")) % m_file_name);
+
+  if (!m_cues && !m_split_points.empty())
+    mxerror(boost::format(Y("The file '%1%' does not contain cues. '--fast-split' requires them for finding the split points.\n")) % m_file_name);
+
+  if (!m_cues)
+    m_cues = std::make_shared<KaxCues>();
+
+  if (m_ti.m_no_chapters)
+    m_chapters.reset();
+
+  if (m_ti.m_attach_mode_list.none())
+    m_attachments.reset();
+
+  m_timecode_scale         = FindChildValue<KaxTimecodeScale>(*m_info, TIMECODE_SCALE);
+  m_segment_data_start_pos = analyzer->get_segment_data_start_pos();
+  m_segment_end            = analyzer->get_segment_end();
+
+  auto duration = FindChild<KaxDuration>(*m_info);
+  if (duration)
+    m_source_duration.reset(std::llround(duration->GetValue()));
+
+  m_first_cluster_pos = m_segment_end;
+  analyzer->with_elements(EBML_ID(KaxCluster), [this](kax_analyzer_data_c const &data) {
+    m_first_cluster_pos = std::min(m_first_cluster_pos, data.m_pos);
+  });
+
+  mm_file_io_c file{m_file_name, MODE_READ};
+  EbmlStream stream{file};
+  m_head = std::shared_ptr<EbmlHead>{static_cast<EbmlHead *>(stream.FindNextID(EBML_INFO(EbmlHead), 0xFFFFFFFFL))};
+  if (!m_head)
+    mxerror(boost::format(Y("The file '%1%' does not contain an EBML head.\n")) % m_file_name);
+
+  auto upper_lvl_el = 0;
+  EbmlElement *element_found{};
+  m_head->Read(stream, EBML_CLASS_CONTEXT(EbmlHead), upper_lvl_el, element_found, true);
+  delete element_found;
+}
+
+void
+fast_splitter_c::select_tracks() {
+  auto &tracks       = *m_tracks;
+  auto track_id      = int64_t{};
+  auto track_numbers = std::vector<uint64_t>{};
+  auto idx           = 0u;
+
+  // Track IDs are assigned in the same way the Matroska reader does:
+  // sequentially in the order of the track entries.
+  while (idx < tracks.ListSize()) {
+    auto entry = dynamic_cast<KaxTrackEntry *>(tracks[idx]);
+    if (!entry) {
+      ++idx;
+      continue;
+    }
+
+    auto type     = FindChildValue<KaxTrackType>(entry);
+    auto language = FindChildValue<KaxTrackLanguage, std::string>(entry, "eng");
+    auto index    = map_to_iso639_2_code(language);
+    language      = 0 <= index ? g_iso639_languages[index].iso639_2_code : std::string{};
+
+    auto selector = track_video    == type ? &m_ti.m_vtracks
+                  : track_audio    == type ? &m_ti.m_atracks
+                  : track_subtitle == type ? &m_ti.m_stracks
+                  : track_buttons  == type ? &m_ti.m_btracks
+                  :                          nullptr;
+
+    if (selector && !selector->selected(track_id, language)) {
+      mxdebug_if(m_debug, boost::format("fast_split: removing track ID %1% number %2%\n") % track_id % FindChildValue<KaxTrackNumber>(entry));
+
+      delete entry;
+      tracks.Remove(idx);
+      m_filter_blocks = true;
+
+    } else {
+      track_numbers.push_back(FindChildValue<KaxTrackNumber>(entry));
+      if (m_ti.m_track_tags.selected(track_id))
+        m_track_uids_with_tags.insert(FindChildValue<KaxTrackUID>(entry));
+      ++idx;
+    }
+
+    ++track_id;
+  }
+
+  if (track_numbers.empty())
+    mxerror(Y("No streams to output were found. Aborting.\n"));
+
+  if (!m_filter_blocks)
+    return;
+
+  // The kept tracks are numbered in the order of their old numbers.
+  // That way no new number is bigger than the old one and fits into
+  // the space the old one occupies in each block.
+  brng::sort(track_numbers);
+  for (auto number_idx = 0u; number_idx < track_numbers.size(); ++number_idx)
+    m_track_numbers[track_numbers[number_idx]] = number_idx + 1;
+
+  for (auto const &child : tracks)
+    if (Is<KaxTrackEntry>(child)) {
+      auto &number = GetChild<KaxTrackNumber>(*static_cast<KaxTrackEntry *>(child));
+      number.SetValue(m_track_numbers[number.GetValue()]);
+    }
+}
+
+void
+fast_splitter_c::select_tags() {
+  if (!m_tags)
+    return;
+
+  auto &tags = *m_tags;
+
+  for (auto idx = tags.ListSize(); 0 < idx; --idx) {
+    auto tag = dynamic_cast<KaxTag *>(tags[idx - 1]);
+    if (!tag)
+      continue;
+
+    auto track_uid = mtx::tags::get_tuid(*tag);
+    auto keep      = -1 == track_uid ? !m_ti.m_no_global_tags : mtx::includes(m_track_uids_with_tags, static_cast<uint64_t>(track_uid));
+
+    if (!keep) {
+      delete tag;
+      tags.Remove(idx - 1);
+    }
+  }
+
+  // The statistics describe the source file as a whole, not the parts.
+  mtx::tags::remove_track_statistics(&tags, boost::none);
+
+  if (!tags.ListSize())
+    m_tags.reset();
+}
+
+void
+fast_splitter_c::collect_boundaries() {
+  std::map<uint64_t, int64_t> cue_times_by_position;
+
+  for (auto const &child : *m_cues) {
+    auto point     = dynamic_cast<KaxCuePoint *>(child);
+    auto positions = point ? FindChild<KaxCueTrackPositions>(point) : nullptr;
+    auto kposition = positions ? FindChild<KaxCueClusterPosition>(positions) : nullptr;
+
+    if (!kposition)
+      continue;
+
+    auto position = kposition->GetValue() + m_segment_data_start_pos;
+    auto cue_time = static_cast<int64_t>(FindChildValue<KaxCueTime>(point));
+    auto itr      = cue_times_by_position.find(position);
+
+    if ((position < m_first_cluster_pos) || (position >= m_segment_end))
+      continue;
+
+    if (itr == cue_times_by_position.end())
+      cue_times_by_position[position] = cue_time;
+    else
+      itr->second = std::min(itr->second, cue_time);
+  }
+
+  for (auto const &pair : cue_times_by_position)
+    m_boundaries.push_back(boundary_t{ pair.first, pair.second });
+
+  mxdebug_if(m_debug, boost::format("fast_split: %1% possible split positions found\n") % m_boundaries.size());
+}
+
+uint64_t
+fast_splitter_c::find_boundary(int64_t timecode)
+  const {
+  // Split points are given in nanoseconds; cue times are in units of
+  // the timecode scale.
+  auto itr = brng::find_if(m_boundaries, [this, timecode](boundary_t const &boundary) {
+    return (boundary.m_cue_time * static_cast<int64_t>(m_timecode_scale)) >= timecode;
+  });
+
+  return itr == m_boundaries.end() ? m_segment_end : itr->m_position;
+}
+
+int64_t
+fast_splitter_c::read_cluster_timecode(mm_io_c &in,
+                                       uint64_t position)
+  const {
+  element_head_t head;
+  if (!read_element_head(in, position, head) || head.m_size_unknown || (head.m_id != EBML_ID_VALUE(EBML_ID(KaxCluster))))
+    mxerror(boost::format(Y("The cues of the file '%1%' do not point to a cluster at position %2%.\n")) % m_file_name % position);
+
+  auto content = memory_c::alloc(head.m_size);
+  in.setFilePointer(position + head.m_head_size);
+  if (in.read(content, head.m_size) != head.m_size)
+    mxerror(boost::format(Y("The cluster at position %1% in the file '%2%' is truncated.\n")) % position % m_file_name);
+
+  try {
+    return rebase_cluster(content->get_buffer(), head.m_size, 0);
+  } catch (mtx::exception &ex) {
+    mxerror(boost::format(Y("The cluster at position %1% in the file '%2%' could not be parsed: %3%\n")) % position % m_file_name % ex.error());
+  }
+
+  return 0;
+}
+
+void
+fast_splitter_c::create_parts() {
+  auto split_points = m_split_points;
+  if (!split_points.empty() && (split_point_c::timecode == split_points.front().m_type))
+    brng::sort(split_points);
+
+  auto current_pos = m_first_cluster_pos;
+  auto discarding  = false;
+
+  m_parts.emplace_back(new part_t);
+
+  auto add_range = [this, &current_pos, &discarding](uint64_t end_pos) {
+    if (!discarding && (end_pos > current_pos)) {
+      auto range        = range_t{};
+      range.m_start_pos = current_pos;
+      range.m_end_pos   = end_pos;
+      m_parts.back()->m_ranges.push_back(range);
+    }
+
+    current_pos = std::max(current_pos, end_pos);
+  };
+
+  for (auto const &split_point : split_points) {
+    add_range(find_boundary(split_point.m_point));
+
+    discarding = split_point.m_discard;
+    if (split_point.m_discard || !split_point.m_create_new_file || m_parts.back()->m_ranges.empty())
+      continue;
+
+    if (static_cast<int>(m_parts.size()) >= m_max_num_files) {
+      // Splitting by timecodes puts the remaining content into the
+      // last file while splitting by parts doesn't output it at all.
+      discarding = split_point_c::parts == split_point.m_type;
+      break;
+    }
+
+    m_parts.emplace_back(new part_t);
+  }
+
+  add_range(m_segment_end);
+
+  brng::remove_erase_if(m_parts, [](std::unique_ptr<part_t> const &part) { return part->m_ranges.empty(); });
+
+  if (m_parts.empty())
+    mxerror(Y("No data remains to be written after applying the split points.\n"));
+
+  mm_file_io_c in{m_file_name, MODE_READ};
+  auto file_num = 0;
+
+  for (auto &part : m_parts) {
+    auto part_duration = int64_t{};
+
+    for (auto &range : part->m_ranges) {
+      range.m_start_tc = read_cluster_timecode(in, range.m_start_pos);
+      range.m_end_tc   = range.m_end_pos < m_segment_end ? read_cluster_timecode(in, range.m_end_pos)
+                       : m_source_duration               ? std::max(*m_source_duration, range.m_start_tc)
+                       :                                   -1;
+      range.m_offset   = range.m_start_tc - part_duration;
+      part_duration   += std::max<int64_t>(range.m_end_tc - range.m_start_tc, 0);
+
+      m_bytes_to_copy += range.m_end_pos - range.m_start_pos;
+
+      mxdebug_if(m_debug,
+                 boost::format("fast_split: part %1% range: bytes %2%-%3% timecodes %4%-%5% offset %6%\n")
+                 % (file_num + 1) % range.m_start_pos % range.m_end_pos % range.m_start_tc % range.m_end_tc % range.m_offset);
+    }
+
+    g_file_num        = ++file_num;
+    part->m_file_name = m_split_points.empty() ? g_outfile : create_output_name();
+  }
+}
+
+KaxChapters *
+fast_splitter_c::create_chapters_for(part_t const &part)
+  const {
+  if (!m_chapters)
+    return nullptr;
+
+  auto chapters = std::make_unique<KaxChapters>();
+  auto scale    = static_cast<int64_t>(m_timecode_scale);
+
+  for (auto const &range : part.m_ranges) {
+    auto range_chapters = clone(m_chapters);
+    auto end            = range.m_end_tc < 0 ? std::numeric_limits<int64_t>::max() : range.m_end_tc * scale;
+
+    if (select_chapters_in_timeframe(range_chapters.get(), range.m_start_tc * scale, end, range.m_offset * scale))
+      move_children(*range_chapters, *chapters);
+  }
+
+  if (!chapters->ListSize())
+    return nullptr;
+
+  merge_chapter_entries(*chapters);
+
+  return chapters.release();
+}
+
+KaxCues *
+fast_splitter_c::create_cues_for(part_t const &part)
+  const {
+  auto cues = std::make_unique<KaxCues>();
+
+  for (auto const &child : *m_cues) {
+    auto point     = dynamic_cast<KaxCuePoint *>(child);
+    auto positions = point ? FindChild<KaxCueTrackPositions>(point) : nullptr;
+    if (!positions)
+      continue;
+
+    auto position = FindChildValue<KaxCueClusterPosition>(positions) + m_segment_data_start_pos;
+    auto range    = brng::find_if(part.m_ranges, [position](range_t const &r) { return (r.m_start_pos <= position) && (position < r.m_end_pos); });
+    if (range == part.m_ranges.end())
+      continue;
+
+    auto new_point = static_cast<KaxCuePoint *>(point->Clone());
+    auto &cue_time = GetChild<KaxCueTime>(*new_point);
+    cue_time.SetValue(std::max<int64_t>(static_cast<int64_t>(cue_time.GetValue()) - range->m_offset, 0));
+
+    // Codec states and references point to positions and blocks that
+    // might not be part of the output.
+    for (auto const &point_child : *new_point)
+      if (Is<KaxCueTrackPositions>(point_child)) {
+        DeleteChildren<KaxCueCodecState>(static_cast<EbmlMaster *>(point_child));
+        DeleteChildren<KaxCueReference>(static_cast<EbmlMaster *>(point_child));
+      }
+
+    if (m_filter_blocks && !select_cue_track_positions(*new_point, m_track_numbers)) {
+      delete new_point;
+      continue;
+    }
+
+    cues->PushElement(*new_point);
+  }
+
+  return cues.release();
+}
+
+void
+fast_splitter_c::prepare_headers() {
+  auto no_variable_data = hack_engaged(ENGAGE_NO_VARIABLE_DATA);
+  auto muxing_app       = no_variable_data ? std::string{"no_variable_data"} : std::string("libebml v") + EbmlCodeVersion + std::string(" + libmatroska v") + KaxCodeVersion;
+  auto writing_app      = no_variable_data ? std::string{"no_variable_data"} : get_version_info("mkvmerge", static_cast<version_info_flags_e>(vif_full | vif_untranslated));
+  auto writing_date     = no_variable_data ? 0 : mtx::date_time::to_time_t(boost::posix_time::second_clock::universal_time());
+
+  for (auto &part : m_parts) {
+    part->m_head   = clone(m_head);
+    part->m_tracks = clone(m_tracks);
+    part->m_info   = clone(m_info);
+
+    auto &info = *part->m_info;
+    DeleteChildren<KaxSegmentUID>(info);
+    DeleteChildren<KaxPrevUID>(info);
+    DeleteChildren<KaxNextUID>(info);
+    DeleteChildren<KaxSegmentFilename>(info);
+    DeleteChildren<KaxPrevFilename>(info);
+    DeleteChildren<KaxNextFilename>(info);
+    DeleteChildren<KaxDuration>(info);
+
+    auto duration = int64_t{};
+    auto known    = boost::accumulate(part->m_ranges, true, [&duration](bool accu, range_t const &range) {
+      duration += range.m_end_tc - range.m_start_tc;
+      return accu && (0 <= range.m_end_tc);
+    });
+
+    if (known)
+      GetChild<KaxDuration>(info).SetValue(duration);
+
+    bitvalue_c segment_uid(128);
+    if (no_variable_data)
+      segment_uid.zero_content();
+    else
+      segment_uid.generate_random();
+
+    GetChild<KaxSegmentUID>(info).CopyBuffer(segment_uid.data(), 128 / 8);
+    GetChild<KaxMuxingApp >(info).SetValueUTF8(muxing_app);
+    GetChild<KaxWritingApp>(info).SetValueUTF8(writing_app);
+    GetChild<KaxDateUTC   >(info).SetEpochDate(writing_date);
+
+    if (g_segment_title_set)
+      GetChild<KaxTitle>(info).SetValueUTF8(g_segment_title);
+
+    part->m_chapters.reset(create_chapters_for(*part));
+    part->m_cues.reset(create_cues_for(*part));
+
+    if (m_tags)
+      part->m_tags = clone(m_tags);
+
+    if (m_attachments)
+      part->m_attachments = clone(m_attachments);
+  }
+}
+
+void
+fast_splitter_c::write_part(part_t &part) {
+  try {
+    mm_file_io_c in{m_file_name, MODE_READ};
+    auto out = mm_write_buffer_io_c::open(part.m_file_name, FAST_SPLIT_WRITE_BUFFER_SIZE);
+
+    part.m_head->Render(*out, true);
+
+    KaxSegment segment;
+    segment.WriteHead(*out, 8);
+
+    auto data_start_pos = out->getFilePointer();
+
+    EbmlVoid seek_head_void;
+    seek_head_void.SetSize(FAST_SPLIT_SEEK_HEAD_SIZE);
+    seek_head_void.Render(*out);
+
+    KaxSeekHead seek_head;
+    auto render_and_index = [&out, &segment, &seek_head](EbmlElement *element) {
+      if (!element)
+        return;
+
+      element->Render(*out, true);
+      seek_head.IndexThis(*element, segment);
+    };
+
+    render_and_index(part.m_info.get());
+    render_and_index(part.m_tracks.get());
+    render_and_index(part.m_chapters.get());
+    render_and_index(part.m_tags.get());
+    render_and_index(part.m_attachments.get());
+
+    // Copy the clusters and remember where they were placed so that
+    // the cue points can be updated afterwards.
+    std::unordered_map<uint64_t, uint64_t> cluster_positions;
+    auto buffer = memory_c::alloc(FAST_SPLIT_WRITE_BUFFER_SIZE);
+
+    for (auto const &range : part.m_ranges) {
+      auto position = range.m_start_pos;
+
+      while (position < range.m_end_pos) {
+        element_head_t head;
+        if (!read_element_head(in, position, head))
+          throw invalid_cluster_x{(boost::format(Y("The element at position %1% could not be read.")) % position).str()};
+
+        if (head.m_size_unknown)
+          throw invalid_cluster_x{(boost::format(Y("The element at position %1% has an unknown size.")) % position).str()};
+
+        auto element_size = head.m_head_size + head.m_size;
+
+        if (head.m_id == EBML_ID_VALUE(EBML_ID(KaxCluster))) {
+          if (buffer->get_size() < element_size)
+            buffer->resize(element_size);
+
+          in.setFilePointer(position);
+          if (in.read(buffer->get_buffer(), element_size) != element_size)
+            throw invalid_cluster_x{(boost::format(Y("The cluster at position %1% is truncated.")) % position).str()};
+
+          rebase_cluster(buffer->get_buffer() + head.m_head_size, head.m_size, range.m_offset);
+
+          auto new_size         = head.m_size;
+          auto new_element_size = element_size;
+
+          if (m_filter_blocks) {
+            // The cluster only shrinks. Its new size therefore fits into
+            // the space the old one occupies in the head.
+            new_size         = filter_blocks(buffer->get_buffer() + head.m_head_size, head.m_size, m_track_numbers);
+            new_element_size = head.m_head_size + new_size;
+
+            put_uint_be(buffer->get_buffer() + head.m_head_size - head.m_size_length, new_size | (1ull << (7 * head.m_size_length)), head.m_size_length);
+          }
+
+          update_cluster_crc32(buffer->get_buffer() + head.m_head_size, new_size);
+
+          cluster_positions[position - m_segment_data_start_pos] = out->getFilePointer() - data_start_pos;
+          out->write(buffer->get_buffer(), new_element_size);
+        }
+
+        position       += element_size;
+        m_bytes_copied += element_size;
+      }
+    }
+
+    auto &cues = *part.m_cues;
+    for (auto point_idx = cues.ListSize(); 0 < point_idx; --point_idx) {
+      auto &point = *static_cast<EbmlMaster *>(cues[point_idx - 1]);
+
+      for (auto positions_idx = point.ListSize(); 0 < positions_idx; --positions_idx) {
+        auto positions = dynamic_cast<KaxCueTrackPositions *>(point[positions_idx - 1]);
+        if (!positions)
+          continue;
+
+        auto &cluster_position = GetChild<KaxCueClusterPosition>(*positions);
+        auto new_position      = cluster_positions.find(cluster_position.GetValue());
+
+        if (new_position != cluster_positions.end())
+          cluster_position.SetValue(new_position->second);
+
+        else {
+          delete positions;
+          point.Remove(positions_idx - 1);
+        }
+      }
+
+      if (!FindChild<KaxCueTrackPositions>(point)) {
+        delete &point;
+        cues.Remove(point_idx - 1);
+      }
+    }
+
+    if (cues.ListSize())
+      render_and_index(&cues);
+
+    seek_head_void.ReplaceWith(seek_head, *out, true, true);
+
+    if (segment.ForceSize(out->getFilePointer() - segment.GetElementPosition() - segment.HeadSize()))
+      segment.OverwriteHead(*out);
+
+  } catch (mtx::exception &ex) {
+    part.m_error = (boost::format(Y("The file '%1%' could not be written: %2%")) % part.m_file_name % ex.error()).str();
+
+  } catch (std::exception &ex) {
+    part.m_error = (boost::format(Y("The file '%1%' could not be written: %2%")) % part.m_file_name % ex.what()).str();
+
+  } catch (...) {
+    part.m_error = (boost::format(Y("The file '%1%' could not be written: %2%")) % part.m_file_name % Y("unknown error")).str();
+  }
+
+  ++m_num_parts_done;
+}
+
+void
+fast_splitter_c::display_progress(bool is_100percent) {
+  auto percentage = is_100percent || !m_bytes_to_copy ? 100 : static_cast<int>(m_bytes_copied * 100 / m_bytes_to_copy);
+
+  if (progress_format_e::json == g_progress_format) {
+    // Everything copied is written right away.
+    auto sample            = progress_report_c::sample_t{};
+    sample.m_time_ms       = mtx::sys::get_current_time_millis();
+    sample.m_percentage    = percentage;
+    sample.m_bytes_read    = m_bytes_copied;
+    sample.m_bytes_total   = m_bytes_to_copy;
+    sample.m_bytes_written = m_bytes_copied;
+
+    m_progress_report.display(sample);
+
+  } else if (g_gui_mode)
+    mxinfo(boost::format("#GUI#progress %1%%%\n") % percentage);
+  else
+    mxinfo(boost::format(Y("Progress: %1%%%%2%")) % percentage % (is_100percent ? "\n" : "\r"));
+}
+
+void
+fast_splitter_c::write_parts() {
+  auto num_threads = std::max<std::size_t>(std::min<std::size_t>(std::thread::hardware_concurrency(), m_parts.size()), 1);
+
+  for (auto const &part : m_parts)
+    mxinfo(boost::format(Y("The file '%1%' has been opened for writing.\n")) % part->m_file_name);
+
+  mxdebug_if(m_debug, boost::format("fast_split: writing %1% parts with %2% threads\n") % m_parts.size() % num_threads);
+
+  // Each thread takes the next part that hasn't been started yet. Only
+  // the main thread produces output.
+  std::atomic<std::size_t> next_part{};
+  std::vector<std::thread> threads;
+
+  for (auto idx = 0u; idx < num_threads; ++idx)
+    threads.emplace_back([this, &next_part]() {
+      for (auto part_idx = next_part++; part_idx < m_parts.size(); part_idx = next_part++)
+        write_part(*m_parts[part_idx]);
+    });
+
+  auto previous_percentage = -1;
+
+  while (m_num_parts_done < m_parts.size()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    auto percentage = m_bytes_to_copy ? static_cast<int>(m_bytes_copied * 100 / m_bytes_to_copy) : 0;
+    if ((percentage != previous_percentage) || (progress_format_e::json == g_progress_format))
+      display_progress(false);
+    previous_percentage = percentage;
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  display_progress(true);
+
+  for (auto const &part : m_parts)
+    if (!part->m_error.empty())
+      mxerror(boost::format("%1%\n") % part->m_error);
+}
@@ -0,0 +1,131 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   splitting Matroska files without re-packetizing their content
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_FAST_SPLIT_H
+#define MTX_MERGE_FAST_SPLIT_H
+
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <unordered_set>
+
+#include <ebml/EbmlHead.h>
+#include <matroska/KaxAttachments.h>
+#include <matroska/KaxChapters.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxInfo.h>
+#include <matroska/KaxTags.h>
+#include <matroska/KaxTracks.h>
+
+#include "common/bitvalue.h"
+#include "common/split_point.h"
+#include "merge/progress_report.h"
+#include "merge/track_info.h"
+
+/** \brief Splits a Matroska file by copying whole clusters
+
+   Used for \c --split \c timecodes: and \c --split \c parts: if the
+   only source is a Matroska file with cues. The cue points determine
+   where each part may start. Each part is a list of byte ranges of
+   clusters in the source file. The clusters are copied verbatim;
+   only their timecodes are rebased. As the parts don't depend on each
+   other they're written concurrently.
+
+   Also used for \c --fast-remux which copies the file into a single
+   destination file. The track selection options (\c --audio-tracks,
+   \c --no-video etc.) are honored by dropping the blocks of removed
+   tracks from each cluster and renumbering the remaining ones. The
+   blocks themselves are copied unchanged.
+*/
+class fast_splitter_c {
+protected:
+  struct range_t {
+    // Absolute positions in the source file.
+    uint64_t m_start_pos{}, m_end_pos{};
+    // All timecodes are in units of the source's timecode scale.
+    // m_end_tc is negative if the end is not known.
+    int64_t m_start_tc{}, m_end_tc{-1}, m_offset{};
+  };
+
+  struct part_t {
+    std::string m_file_name;
+    std::vector<range_t> m_ranges;
+    std::shared_ptr<EbmlHead> m_head;
+    std::shared_ptr<KaxInfo> m_info;
+    std::shared_ptr<KaxTracks> m_tracks;
+    std::shared_ptr<KaxChapters> m_chapters;
+    std::shared_ptr<KaxTags> m_tags;
+    std::shared_ptr<KaxAttachments> m_attachments;
+    std::shared_ptr<KaxCues> m_cues;
+    std::string m_error;
+  };
+
+  struct boundary_t {
+    uint64_t m_position;
+    int64_t m_cue_time;
+  };
+
+  std::string m_file_name;
+  std::vector<split_point_c> m_split_points;
+  int m_max_num_files;
+
+  std::shared_ptr<EbmlHead> m_head;
+  std::shared_ptr<KaxInfo> m_info;
+  std::shared_ptr<KaxTracks> m_tracks;
+  std::shared_ptr<KaxChapters> m_chapters;
+  std::shared_ptr<KaxTags> m_tags;
+  std::shared_ptr<KaxAttachments> m_attachments;
+  std::shared_ptr<KaxCues> m_cues;
+
+  track_info_c const &m_ti;
+  // Maps the numbers of the tracks to be copied to their new numbers.
+  // Only used if at least one track is removed.
+  std::unordered_map<uint64_t, uint64_t> m_track_numbers;
+  std::unordered_set<uint64_t> m_track_uids_with_tags;
+  bool m_filter_blocks{};
+
+  uint64_t m_timecode_scale{}, m_segment_data_start_pos{}, m_segment_end{}, m_first_cluster_pos{};
+  boost::optional<int64_t> m_source_duration;
+
+  std::vector<boundary_t> m_boundaries;
+  std::vector<std::unique_ptr<part_t> > m_parts;
+
+  std::atomic<uint64_t> m_bytes_copied{}, m_num_parts_done{};
+  uint64_t m_bytes_to_copy{};
+  progress_report_c m_progress_report;
+
+  debugging_option_c m_debug{"fast_split"};
+
+public:
+  fast_splitter_c(std::string const &file_name, track_info_c const &ti, std::vector<split_point_c> const &split_points, int max_num_files);
+
+  void run();
+
+protected:
+  void read_source();
+  void select_tracks();
+  void select_tags();
+  void collect_boundaries();
+  void create_parts();
+  void prepare_headers();
+  void write_parts();
+  void write_part(part_t &part);
+
+  uint64_t find_boundary(int64_t timecode) const;
+  int64_t read_cluster_timecode(mm_io_c &in, uint64_t position) const;
+  KaxCues *create_cues_for(part_t const &part) const;
+  KaxChapters *create_chapters_for(part_t const &part) const;
+  void display_progress(bool is_100percent);
+};
+
+#endif  // MTX_MERGE_FAST_SPLIT_H
@@ -28,6 +28,7 @@
 #include "common/container.h"
 #include "common/ebml.h"
 #include "common/hacks.h"
+#include "common/memory_accounting.h"
 #include "common/strings/formatting.h"
 #include "common/unique_numbers.h"
 #include "common/xml/ebml_tags_converter.h"
@@ -43,6 +44,8 @@
    : track_video == track_type ? DEFTRACK_TYPE_VIDEO \
    :                             DEFTRACK_TYPE_SUBS)
 
+static auto &s_queue_memory = mtx::memory_accounting::component("packetizer queues");
+
 #define LOOKUP_TRACK_ID(container)                    \
       mtx::includes(container, m_ti.m_id) ? m_ti.m_id \
     : mtx::includes(container, -1)        ? -1        \
@@ -329,6 +332,10 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
 }
 
 generic_packetizer_c::~generic_packetizer_c() {
+  s_queue_memory.remove(m_enqueued_bytes);
+
+  for (auto const &packet : m_deferred_packets)
+    s_queue_memory.remove(packet->data->get_size());
 }
 
 void
@@ -1194,8 +1201,11 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
 
   if (1 != m_connected_to)
     add_packet2(pack);
-  else
+
+  else {
     m_deferred_packets.push_back(pack);
+    s_queue_memory.add(pack->data->get_size());
+  }
 }
 
 #define ADJUST_TIMECODE(x) (int64_t)((x + m_correction_timecode_offset + m_append_timecode_offset) * m_ti.m_tcsync.numerator / m_ti.m_tcsync.denominator) + m_ti.m_tcsync.displacement
@@ -1272,6 +1282,7 @@ generic_packetizer_c::add_packet2(packet_cptr pack) {
 
   if (!m_compressor) {
     m_enqueued_bytes += pack->data->get_size();
+    s_queue_memory.add(pack->data->get_size());
     return;
   }
 
@@ -1282,6 +1293,7 @@ generic_packetizer_c::add_packet2(packet_cptr pack) {
       pack->data_adds[i] = m_compressor->compress(pack->data_adds[i]);
 
     m_enqueued_bytes += pack->data->get_size();
+    s_queue_memory.add(pack->data->get_size());
 
   } catch (mtx::compression_x &e) {
     mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Compression failed: %1%\n")) % e.error());
@@ -1290,8 +1302,10 @@ generic_packetizer_c::add_packet2(packet_cptr pack) {
 
 void
 generic_packetizer_c::process_deferred_packets() {
-  for (auto &packet : m_deferred_packets)
+  for (auto &packet : m_deferred_packets) {
+    s_queue_memory.remove(packet->data->get_size());
     add_packet2(packet);
+  }
   m_deferred_packets.clear();
 }
 
@@ -1306,6 +1320,7 @@ generic_packetizer_c::get_packet() {
   pack->output_order_timecode = timestamp_c::ns(pack->assigned_timecode - std::max(m_codec_delay.to_ns(0), m_seek_pre_roll.to_ns(0)));
 
   m_enqueued_bytes -= pack->data->get_size();
+  s_queue_memory.remove(pack->data->get_size());
 
   --m_next_packet_wo_assigned_timecode;
   if (0 > m_next_packet_wo_assigned_timecode)
@@ -1523,6 +1538,7 @@ generic_packetizer_c::is_compatible_with(output_compatibility_e compatibility) {
 void
 generic_packetizer_c::discard_queued_packets() {
   m_packet_queue.clear();
+  s_queue_memory.remove(m_enqueued_bytes);
   m_enqueued_bytes = 0;
 }
 
@@ -1585,6 +1601,9 @@ generic_packetizer_c::create_track_number() {
 
 file_status_e
 generic_packetizer_c::read(bool force) {
+  if (complete_parsed_frames())
+    return FILE_STATUS_MOREDATA;
+
   return m_reader->read(this, force);
 }
 
@@ -280,6 +280,12 @@ protected:
   virtual void flush_impl() {
   };
 
+  // Packetizers parsing in a separate thread hand over finished frames
+  // here. Returns whether or not packets may have been added.
+  virtual bool complete_parsed_frames() {
+    return false;
+  }
+
   virtual void show_experimental_status_version(std::string const &codec_id);
 };
 
@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include "common/list_utils.h"
+#include "common/memory_accounting.h"
 #include "common/strings/formatting.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
@@ -75,6 +76,8 @@ generic_reader_c::generic_reader_c(const track_info_c &ti,
   , m_num_audio_tracks{}
   , m_num_subtitle_tracks{}
   , m_reference_timecode_tolerance{}
+  , m_max_queued_bytes{20 * 1024 * 1024}
+  , m_max_queued_bytes_av{512 * 1024 * 1024}
 {
   add_all_requested_track_ids(*this, m_ti.m_atracks.m_items);
   add_all_requested_track_ids(*this, m_ti.m_vtracks.m_items);
@@ -265,6 +268,35 @@ generic_reader_c::get_queued_bytes()
   return bytes;
 }
 
+/** \brief Decides whether the reader should stop reading for now
+
+   Without a limit a reader whose tracks are interleaved badly would
+   read huge amounts of data for one track while looking for packets
+   of another one. Once more than \c m_max_queued_bytes are queued in
+   its packetizers the reader only continues reading on behalf of
+   audio and video tracks, and only up to \c m_max_queued_bytes_av.
+   Readers return \c FILE_STATUS_HOLDING in that case; the main loop
+   then forces them to read once all of their packetizers are held.
+
+   Once the memory limit set with \c --max-memory has been reached all
+   readers hold regardless of their own queues. They then only read
+   when forced to for a packetizer that has run dry.
+*/
+bool
+generic_reader_c::queue_limit_reached(int64_t num_queued_bytes,
+                                      generic_packetizer_c *requested_ptzr)
+  const {
+  if (mtx::memory_accounting::limit_reached())
+    return true;
+
+  if (num_queued_bytes <= m_max_queued_bytes)
+    return false;
+
+  auto track_type = requested_ptzr ? requested_ptzr->get_track_type() : -1;
+
+  return !mtx::included_in(track_type, track_audio, track_video) || (num_queued_bytes > m_max_queued_bytes_av);
+}
+
 file_status_e
 generic_reader_c::flush_packetizer(int num) {
   return flush_packetizer(PTZR(num));
@@ -69,6 +69,10 @@ protected:
 
   timestamp_c m_restricted_timecodes_min, m_restricted_timecodes_max;
 
+  // Limits for the data queued in this reader's packetizers; see
+  // queue_limit_reached().
+  int64_t m_max_queued_bytes, m_max_queued_bytes_av;
+
 public:
   generic_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~generic_reader_c();
@@ -113,6 +117,7 @@ public:
     return m_in->get_size();
   }
   virtual int64_t get_queued_bytes() const;
+  virtual bool queue_limit_reached(int64_t num_queued_bytes, generic_packetizer_c *requested_ptzr) const;
   virtual bool is_simple_subtitle_container() {
     return false;
   }
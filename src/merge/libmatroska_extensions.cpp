@@ -157,6 +157,29 @@ kax_cluster_c::delete_non_blocks() {
   RemoveAll();
 }
 
+filepos_t
+kax_cluster_c::Render(IOCallback &output,
+                      KaxCues &cues_to_update,
+                      bool save_default) {
+  // KaxCluster::Render() clears the list of block blobs once they've
+  // been written. Keep them around for recording where each block
+  // ended up.
+  auto blobs  = Blobs;
+  auto result = KaxCluster::Render(output, cues_to_update, save_default);
+
+  m_block_positions.clear();
+  m_block_positions.reserve(blobs.size());
+
+  for (auto blob : blobs) {
+    auto &block   = static_cast<KaxInternalBlock &>(*blob);
+    auto position = blob->IsSimpleBlock() ? static_cast<KaxSimpleBlock &>(*blob).GetElementPosition() : static_cast<KaxBlockGroup &>(*blob).GetElementPosition();
+
+    m_block_positions.push_back({ block.TrackNum(), block.GlobalTimecode(), position });
+  }
+
+  return result;
+}
+
 kax_cues_with_cleanup_c::kax_cues_with_cleanup_c()
   : KaxCues{}
 {
@@ -26,7 +26,14 @@
 using namespace libebml;
 using namespace libmatroska;
 
+struct id_timecode_position_t {
+  uint64_t id, timecode, position;
+};
+
 class kax_cluster_c: public KaxCluster {
+protected:
+  std::vector<id_timecode_position_t> m_block_positions;
+
 public:
   kax_cluster_c(): KaxCluster() {
     PreviousTimecode = 0;
@@ -34,6 +41,14 @@ public:
 
   void delete_non_blocks();
 
+  filepos_t Render(IOCallback &output, KaxCues &cues_to_update, bool save_default = false);
+
+  // Track number, timecode & position of all blocks in the order they
+  // were rendered by the last call to Render().
+  std::vector<id_timecode_position_t> const &get_block_positions() const {
+    return m_block_positions;
+  }
+
   void set_min_timecode(int64_t min_timecode) {
     MinTimecode = min_timecode;
   }
@@ -49,8 +49,10 @@
 #include "common/iso639.h"
 #include "common/kax_analyzer.h"
 #include "common/list_utils.h"
+#include "common/memory_accounting.h"
 #include "common/mm_io.h"
 #include "common/mm_mpls_multi_file_io.h"
+#include "common/output_channel.h"
 #include "common/segmentinfo.h"
 #include "common/split_arg_parsing.h"
 #include "common/strings/formatting.h"
@@ -61,6 +63,7 @@
 #include "common/xml/ebml_segmentinfo_converter.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "merge/cluster_helper.h"
+#include "merge/fast_split.h"
 #include "merge/filelist.h"
 #include "merge/generic_reader.h"
 #include "merge/output_control.h"
@@ -123,6 +126,23 @@ set_usage() {
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
   usage_text += Y("  --disable-track-statistics-tags\n"
                   "                           Do not write tags with track statistics.\n");
+  usage_text += Y("  --preallocate-output     Reserve the estimated space for each destination\n"
+                  "                           file before writing it.\n");
+  usage_text += Y("  --streaming-output       Write the destination file strictly sequentially\n"
+                  "                           without ever seeking back.\n");
+  usage_text += Y("  --avoid-page-cache       Keep source and destination files out of the\n"
+                  "                           operating system's page cache.\n");
+  usage_text += Y("  --direct-output          Write destination files with direct I/O\n"
+                  "                           bypassing the page cache.\n");
+  usage_text += Y("  --read-ahead-size <d[K,M]>\n"
+                  "                           Read up to d bytes (KB, MB) of each source file\n"
+                  "                           ahead in a separate thread (default: 8M; 0\n"
+                  "                           disables reading ahead).\n");
+  usage_text += Y("  --parallel-parsing       Parse AVC, HEVC, MPEG-1/2, VC-1, DTS and TrueHD\n"
+                  "                           tracks in a separate thread per track.\n");
+  usage_text += Y("  --max-memory <d[K,M,G]>  Pause reading source files while the queued\n"
+                  "                           data takes up more than d bytes (KB, MB, GB)\n"
+                  "                           and report the peak usage.\n");
   usage_text +=   "\n";
   usage_text += Y(" File splitting, linking, appending and concatenating (more global options):\n");
   usage_text += Y("  --split <d[K,M,G]|HH:MM:SS|s>\n"
@@ -145,6 +165,14 @@ set_usage() {
                   "                           Create a new file before each chapter (with 'all')\n"
                   "                           or before chapter numbers A, B etc.\n");
   usage_text += Y("  --split-max-files <n>    Create at most n files.\n");
+  usage_text += Y("  --fast-split             Split a single Matroska source file with cues by\n"
+                  "                           copying whole clusters and writing all\n"
+                  "                           destination files in parallel. Only for\n"
+                  "                           'timecodes:' and 'parts:'.\n");
+  usage_text += Y("  --fast-remux             Copy a single Matroska source file by passing\n"
+                  "                           its blocks through unchanged. Only tracks,\n"
+                  "                           tags, chapters and attachments can be\n"
+                  "                           selected.\n");
   usage_text += Y("  --link                   Link splitted files.\n");
   usage_text += Y("  --link-to-previous <SID> Link the first file to the given SID.\n");
   usage_text += Y("  --link-to-next <SID>     Link the last file to the given SID.\n");
@@ -327,6 +355,9 @@ set_usage() {
                   "                           Sets maximum size to probe for tracks in percent\n"
                   "                           of the total file size for certain file types\n"
                   "                           (default: 0.3).\n");
+  usage_text += Y("  --progress-format <format>\n"
+                  "                           Set the format of the progress reports\n"
+                  "                           ('text', 'json').\n");
   usage_text += Y("  -l, --list-types         Lists supported source file types.\n");
   usage_text += Y("  --list-languages         Lists all ISO639 languages and their\n"
                   "                           ISO639-2 codes.\n");
@@ -2038,6 +2069,64 @@ parse_arg_identification_format(std::vector<std::string>::const_iterator &sit,
   ++sit;
 }
 
+static void
+parse_arg_progress_format(std::string const &arg) {
+  auto format = balg::to_lower_copy(arg);
+
+  if (format == "text")
+    g_progress_format = progress_format_e::text;
+
+  else if (format == "json")
+    g_progress_format = progress_format_e::json;
+
+  else
+    mxerror(boost::format(Y("Invalid progress format in '%1% %2%'.\n")) % "--progress-format" % arg);
+}
+
+static void
+parse_arg_read_ahead_size(std::string const &arg) {
+  auto s        = arg;
+  auto modifier = int64_t{1};
+  auto last     = s.empty() ? 0 : tolower(s[s.length() - 1]);
+
+  if ('k' == last)
+    modifier = 1024;
+  else if ('m' == last)
+    modifier = 1024 * 1024;
+
+  if (1 != modifier)
+    s.erase(s.size() - 1);
+
+  int64_t size = 0;
+  if (!parse_number(s, size) || (0 > size) || ((1024 * 1024 * 1024 / modifier) < size))
+    mxerror(boost::format(Y("Invalid read-ahead size in '%1% %2%'.\n")) % "--read-ahead-size" % arg);
+
+  g_read_ahead_size = size * modifier;
+}
+
+static void
+parse_arg_max_memory(std::string const &arg) {
+  auto s        = arg;
+  auto modifier = int64_t{1};
+  auto last     = s.empty() ? 0 : tolower(s[s.length() - 1]);
+
+  if ('k' == last)
+    modifier = 1024;
+  else if ('m' == last)
+    modifier = 1024 * 1024;
+  else if ('g' == last)
+    modifier = 1024 * 1024 * 1024;
+
+  if (1 != modifier)
+    s.erase(s.size() - 1);
+
+  int64_t size = 0;
+  if (!parse_number(s, size) || (0 > size) || ((std::numeric_limits<int64_t>::max() / modifier) < size))
+    mxerror(boost::format(Y("Invalid memory limit in '%1% %2%'.\n")) % "--max-memory" % arg);
+
+  mtx::memory_accounting::set_limit(size * modifier);
+}
+
 static void
 parse_arg_probe_range(boost::optional<std::string> next_arg) {
   if (!next_arg)
@@ -2118,6 +2207,53 @@ handle_identification_args(std::vector<std::string> &args) {
   mxexit();
 }
 
+/** \brief Verifies that the other options are compatible with \c --fast-split
+
+   The fast split and fast remux modes copy clusters from a single
+   Matroska file without creating readers or packetizers. Therefore
+   only the options concerning the output files themselves and the
+   selection of tracks, tags, chapters and attachments can be honored.
+*/
+static void
+verify_fast_split_args(std::vector<std::string> const &args) {
+  auto option = std::string{g_fast_split ? "--fast-split" : "--fast-remux"};
+
+  for (auto sit = args.cbegin(), sit_end = args.cend(); sit != sit_end; sit++) {
+    auto const &this_arg = *sit;
+
+    if (mtx::included_in(this_arg, "-o", "--output", "--split", "--split-max-files", "--title", "--priority", "--command-line-charset", "--engage", "--progress-format"))
+      sit++;
+
+    else if (mtx::included_in(this_arg, "-a", "--atracks", "--audio-tracks", "-d", "--vtracks", "--video-tracks", "-s", "--stracks", "--sub-tracks", "--subtitle-tracks", "-b", "--btracks", "--button-tracks", "--track-tags"))
+      sit++;
+
+    else if (mtx::included_in(this_arg, "--fast-split", "--fast-remux", "-q", "--quiet", "-v", "--verbose", "-w", "--webm"))
+      continue;
+
+    else if (mtx::included_in(this_arg, "-A", "--noaudio", "--no-audio", "-D", "--novideo", "--no-video", "-S", "--nosubs", "--no-subs", "--no-subtitles", "-B", "--nobuttons", "--no-buttons",
+                              "-T", "--no-track-tags", "-M", "--no-attachments", "--no-chapters", "--no-global-tags"))
+      continue;
+
+    else if ((1 < this_arg.size()) && ('-' == this_arg[0]) && (g_files.empty() || (this_arg != g_files[0]->name)))
+      mxerror(boost::format(Y("'%1%' cannot be used together with '%2%'.\n")) % this_arg % option);
+  }
+
+  // '--fast-remux' writes a single file unless '--split' is used.
+  auto const &split_points = g_cluster_helper->get_split_points();
+  if (   (g_fast_split && split_points.empty())
+      || (!split_points.empty() && !mtx::included_in(split_points.front().m_type, split_point_c::timecode, split_point_c::parts)))
+    mxerror(boost::format(Y("'%1%' can only be used together with '--split timecodes:...' or '--split parts:...'.\n")) % option);
+
+  if (!g_no_linking)
+    mxerror(boost::format(Y("'%1%' cannot be used together with '--link'.\n")) % option);
+
+  if ((g_files.size() != 1) || (g_files[0]->all_names.size() != 1))
+    mxerror(boost::format(Y("'%1%' requires exactly one source file.\n")) % option);
+
+  if (!kax_analyzer_c::probe(g_files[0]->name))
+    mxerror(boost::format(Y("'%1%' requires the source file to be a Matroska file, but '%2%' is not.\n")) % option % g_files[0]->name);
+}
+
 static void
 parse_args(std::vector<std::string> args) {
   handle_identification_args(args);
@@ -2242,6 +2378,12 @@ parse_args(std::vector<std::string> args) {
 
       sit++;
 
+    } else if (this_arg == "--fast-split") {
+      g_fast_split = true;
+
+    } else if (this_arg == "--fast-remux") {
+      g_fast_remux = true;
+
     } else if (this_arg == "--link") {
       g_no_linking = false;
 
@@ -2288,6 +2430,45 @@ parse_args(std::vector<std::string> args) {
     else if (this_arg == "--disable-track-statistics-tags")
       g_no_track_statistics_tags = true;
 
+    else if (this_arg == "--preallocate-output")
+      g_preallocate_output = true;
+
+    else if (this_arg == "--streaming-output")
+      g_streaming_output = true;
+
+    else if (this_arg == "--progress-format") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      parse_arg_progress_format(next_arg);
+      sit++;
+    }
+
+    else if (this_arg == "--avoid-page-cache")
+      g_avoid_page_cache = true;
+
+    else if (this_arg == "--read-ahead-size") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      parse_arg_read_ahead_size(next_arg);
+      sit++;
+    }
+
+    else if (this_arg == "--direct-output")
+      g_direct_output = true;
+
+    else if (this_arg == "--parallel-parsing")
+      g_parallel_parsing = true;
+
+    else if (this_arg == "--max-memory") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      parse_arg_max_memory(next_arg);
+      sit++;
+    }
+
     else if (this_arg == "--attachment-description") {
       if (no_next_arg)
         mxerror(Y("'--attachment-description' lacks the description.\n"));
@@ -2777,6 +2958,21 @@ parse_args(std::vector<std::string> args) {
   if (!g_cluster_helper->splitting() && !g_no_linking)
     mxwarn(Y("'--link' is only useful in combination with '--split'.\n"));
 
+  if (g_fast_split || g_fast_remux)
+    verify_fast_split_args(args);
+
+  if (g_streaming_output) {
+    if (g_cluster_helper->splitting())
+      mxerror(Y("'--streaming-output' cannot be used together with '--split'.\n"));
+
+    if (chapter_generation_mode_e::none != g_cluster_helper->get_chapter_generation_mode())
+      mxerror(Y("'--streaming-output' cannot be used together with '--generate-chapters'.\n"));
+
+    // The cues can only be written at the end of the file, and the
+    // seek head at the start pointing to them could not be updated.
+    g_write_cues = false;
+  }
+
   if (!inputs_found && g_files.empty())
     mxerror(Y("No source files were given.\n"));
 }
@@ -2939,6 +3135,37 @@ setup(int argc,
   return args;
 }
 
+/** \brief Shows how much memory the queues and buffers needed at most
+
+   Only done if a limit has been set or in verbose mode as the peak
+   values are mostly interesting for tuning \c --max-memory.
+*/
+static void
+display_peak_memory_usage() {
+  auto limit = mtx::memory_accounting::get_limit();
+  if (!limit && (2 > verbose))
+    return;
+
+  if (limit)
+    mxinfo(boost::format(Y("Peak amount of queued data: %1% (limit: %2%).\n")) % format_file_size(mtx::memory_accounting::get_peak()) % format_file_size(limit));
+  else
+    mxinfo(boost::format(Y("Peak amount of queued data: %1%.\n")) % format_file_size(mtx::memory_accounting::get_peak()));
+
+  for (auto const component : mtx::memory_accounting::components())
+    mxinfo(boost::format("  %1%: %2%\n") % component->get_name() % format_file_size(component->get_peak()));
+}
+
+static void
+run_fast_split(int64_t start) {
+  fast_splitter_c{g_files[0]->name, *g_files[0]->ti, g_cluster_helper->get_split_points(), g_split_max_num_files}.run();
+
+  mxinfo(boost::format(Y("Multiplexing took %1%.\n")) % create_minutes_seconds_time_string((mtx::sys::get_current_time_millis() - start + 500) / 1000, true));
+
+  cleanup();
+
+  mxexit();
+}
+
 /** \brief Setup and high level program control
 
    Calls the functions for setup, handling the command line arguments,
@@ -2954,8 +3181,14 @@ main(int argc,
 
   parse_args(args);
 
+  // From here on all messages are written by a background thread.
+  mtx::output::start_channel();
+
   int64_t start = mtx::sys::get_current_time_millis();
 
+  if (g_fast_split || g_fast_remux)
+    run_fast_split(start);
+
   add_filelists_for_playlists();
   create_readers();
 
@@ -2989,6 +3222,8 @@ main(int argc,
             % ex.what() % ex.error());
   }
 
+  display_peak_memory_usage();
+
   mxinfo(boost::format(Y("Multiplexing took %1%.\n")) % create_minutes_seconds_time_string((mtx::sys::get_current_time_millis() - start + 500) / 1000, true));
 
   cleanup();
@@ -68,6 +68,7 @@
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
 #include "merge/output_control.h"
+#include "merge/progress_report.h"
 #include "merge/webm.h"
 
 using namespace libmatroska;
@@ -101,6 +102,9 @@ std::string g_outfile;
 int64_t g_file_sizes                        = 0;
 int g_max_blocks_per_cluster                = 65535;
 int64_t g_max_ns_per_cluster                = 5000000000ll;
+int64_t g_read_ahead_size                   = 8 * 1024 * 1024;
+bool g_avoid_page_cache                     = false;
+bool g_direct_output                        = false;
 bool g_write_cues                           = true;
 bool g_cue_writing_requested                = false;
 generic_packetizer_c *g_video_packetizer    = nullptr;
@@ -109,6 +113,11 @@ bool g_no_lacing                            = false;
 bool g_no_linking                           = true;
 bool g_use_durations                        = false;
 bool g_no_track_statistics_tags             = false;
+bool g_preallocate_output                   = false;
+bool g_streaming_output                     = false;
+bool g_fast_split                           = false;
+bool g_fast_remux                           = false;
+bool g_parallel_parsing                     = false;
 
 double g_timecode_scale                     = TIMECODE_SCALE;
 timecode_scale_mode_e g_timecode_scale_mode = TIMECODE_SCALE_MODE_NORMAL;
@@ -120,6 +129,8 @@ int g_default_tracks_priority[3]            = { 0, 0, 0, };
 bool g_identifying                                            = false;
 identification_output_format_e g_identification_output_format = identification_output_format_e::text;
 
+progress_format_e g_progress_format                            = progress_format_e::text;
+
 std::unique_ptr<KaxSegment> g_kax_segment;
 std::unique_ptr<KaxTracks> g_kax_tracks;
 KaxTrackEntry *g_kax_last_entry             = nullptr;
@@ -151,6 +162,7 @@ append_mode_e g_append_mode                 = APPEND_MODE_FILE_BASED;
 bool s_appending_files                      = false;
 auto s_debug_appending                      = debugging_option_c{"append|appending"};
 auto s_debug_rerender_track_headers         = debugging_option_c{"rerender|rerender_track_headers"};
+auto s_debug_preallocation                  = debugging_option_c{"preallocate|preallocation"};
 
 std::string g_default_language              = "und";
 
@@ -173,7 +185,8 @@ static std::unique_ptr<EbmlVoid> s_void_after_track_headers;
 
 static std::vector<std::tuple<timestamp_c, std::string, std::string>> s_additional_chapter_atoms;
 
-static mm_io_cptr s_out;
+static mm_io_cptr s_out, s_streaming_out;
+static int64_t s_bytes_in_previous_files = 0;
 
 static bitvalue_c s_seguid_prev(128), s_seguid_current(128), s_seguid_next(128);
 
@@ -181,6 +194,10 @@ static int s_display_files_done           = 0;
 static int s_display_path_length          = 1;
 static generic_reader_c *s_display_reader = nullptr;
 
+static progress_report_c s_progress_report;
+static std::map<int64_t, int64_t> s_num_packets_by_track;
+static timestamp_c s_last_output_timestamp;
+
 static std::unique_ptr<EbmlHead> s_head;
 
 static std::string s_muxing_app, s_writing_app;
@@ -209,6 +226,33 @@ family_uids_c::add_family_uid(const KaxSegmentFamily &family) {
   return true;
 }
 
+/** \brief Returns the number of bytes to read ahead of each source file
+
+   Each source file is read ahead by its own thread so that all of
+   them are read concurrently while the readers demux. Identification
+   only reads the headers and doesn't benefit from it.
+*/
+std::size_t
+get_read_ahead_size() {
+  return g_identifying ? 0 : g_read_ahead_size;
+}
+
+/** \brief Returns the flags to open the user's source files with
+
+   Temporary files and other helper files are opened without them.
+*/
+unsigned int
+get_source_file_flags() {
+  return g_avoid_page_cache ? mm_file_io_c::FLAG_AVOID_PAGE_CACHE : 0;
+}
+
+/** \brief Returns the flags to open the destination files with
+*/
+unsigned int
+get_destination_file_flags() {
+  return get_source_file_flags() | (g_direct_output ? mm_file_io_c::FLAG_DIRECT_OUTPUT : 0);
+}
+
 static int64_t
 calculate_file_duration() {
   return std::llround(static_cast<double>(g_cluster_helper->get_duration()) / static_cast<double>(g_timecode_scale));
@@ -230,6 +274,14 @@ sighandler(int /* signum */) {
   if (!s_out)
     mxerror(Y("mkvmerge was interrupted by a SIGINT (Ctrl+C?)\n"));
 
+  if (g_streaming_output) {
+    // Nothing can be fixed after the fact when streaming.
+    s_out->close();
+    cleanup();
+
+    mxerror(Y("mkvmerge was interrupted by a SIGINT (Ctrl+C?)\n"));
+  }
+
   mxwarn(Y("\nmkvmerge received a SIGINT (probably because the user pressed "
            "Ctrl+C). Trying to sanitize the file. If mkvmerge hangs during "
            "this process you'll have to kill it manually.\n"));
@@ -294,6 +346,26 @@ determine_display_reader() {
   return winner->reader.get();
 }
 
+static void
+display_progress_as_json(int percentage) {
+  auto sample         = progress_report_c::sample_t{};
+  sample.m_time_ms    = mtx::sys::get_current_time_millis();
+  sample.m_percentage = percentage;
+  sample.m_timestamp  = s_last_output_timestamp;
+
+  for (auto const &file : g_files) {
+    sample.m_bytes_total += file->reader->m_size;
+    sample.m_bytes_read  += std::min<uint64_t>(file->reader->m_in->getFilePointer(), file->reader->m_size);
+  }
+
+  sample.m_bytes_written = s_bytes_in_previous_files + (s_out ? s_out->getFilePointer() : 0);
+
+  for (auto const &track : s_num_packets_by_track)
+    sample.m_tracks.push_back({ track.first, track.second });
+
+  s_progress_report.display(sample);
+}
+
 /** \brief Selects a reader for displaying its progress information
 */
 static void
@@ -306,7 +378,9 @@ display_progress(bool is_100percent = false) {
     return;
 
   if (is_100percent) {
-    if (g_gui_mode)
+    if (progress_format_e::json == g_progress_format)
+      display_progress_as_json(100);
+    else if (g_gui_mode)
       mxinfo(boost::format("#GUI#progress 100%%\n"));
     else
       mxinfo(boost::format(Y("Progress: 100%%%1%")) % "\r");
@@ -320,9 +394,13 @@ display_progress(bool is_100percent = false) {
   int current_percentage = (s_display_reader->get_progress() + s_display_files_done * 100) / s_display_path_length;
   int64_t current_time   = mtx::sys::get_current_time_millis();
 
+  // The JSON reports contain more than the percentage; they're output
+  // periodically even if the percentage hasn't changed.
+  auto has_news = (current_percentage != s_previous_percentage) || (progress_format_e::json == g_progress_format);
+
   if (   (-1 == s_previous_percentage)
       || ((100 == current_percentage) && (100 > s_previous_percentage))
-      || ((current_percentage != s_previous_percentage) && ((current_time - s_previous_progress_on) >= 500)))
+      || (has_news && ((current_time - s_previous_progress_on) >= 500)))
     display_progress = true;
 
   if (!display_progress)
@@ -331,7 +409,9 @@ display_progress(bool is_100percent = false) {
   // if (2 < current_percentage)
   //   exit(42);
 
-  if (g_gui_mode)
+  if (progress_format_e::json == g_progress_format)
+    display_progress_as_json(current_percentage);
+  else if (g_gui_mode)
     mxinfo(boost::format("#GUI#progress %1%%%\n") % current_percentage);
   else
     mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_percentage % "\r");
@@ -500,6 +580,17 @@ rerender_ebml_head() {
   if (!out || !s_head)
     return;
 
+  // Once the headers have been streamed the head cannot be updated
+  // anymore.
+  if (g_streaming_output && !s_streaming_out) {
+    static auto s_warning_printed = false;
+    if (!s_warning_printed)
+      mxwarn(Y("The EBML head had to be updated after the first cluster had been written. This is not possible in streaming mode. "
+               "The document type versions in the destination file may be too low.\n"));
+    s_warning_printed = true;
+    return;
+  }
+
   out->save_pos(s_head->GetElementPosition());
   render_ebml_head(out);
   out->restore_pos();
@@ -554,10 +645,14 @@ render_headers(mm_io_c *out) {
 
     s_kax_infos = std::make_unique<KaxInfo>();
 
-    s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
+    // The duration is unknown until the end of the file. It cannot be
+    // filled in when streaming and is therefore omitted.
+    if (!g_streaming_output) {
+      s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
 
-    s_kax_duration->SetValue(0.0);
-    s_kax_infos->PushElement(*s_kax_duration);
+      s_kax_duration->SetValue(0.0);
+      s_kax_infos->PushElement(*s_kax_duration);
+    }
 
     if (s_muxing_app.empty()) {
       if (!hack_engaged(ENGAGE_NO_VARIABLE_DATA)) {
@@ -838,6 +933,15 @@ shrink_void_and_rerender_track_headers(int64_t new_void_size) {
 */
 void
 rerender_track_headers() {
+  if (g_streaming_output && !s_streaming_out) {
+    static auto s_warning_printed = false;
+    if (!s_warning_printed)
+      mxwarn(Y("The track headers had to be updated after the first cluster had been written. This is not possible in streaming mode. "
+               "The track headers in the destination file may be incomplete.\n"));
+    s_warning_printed = true;
+    return;
+  }
+
   g_kax_tracks->UpdateSize(false);
 
   auto position_before    = s_out->getFilePointer();
@@ -1327,6 +1431,38 @@ prepare_tags_for_rendering() {
   g_tags_size = s_kax_tags->ElementSize();
 }
 
+/** \brief Reserve disk space for the current output file
+
+   The final size is estimated from the sizes of all source files that
+   at least one track is used from. When splitting by size the
+   estimate is limited to the size of a single part. Reserving the
+   space up front lets the file system lay the file out contiguously.
+   Space that isn't used is released again in \c finish_file().
+*/
+static void
+preallocate_output_file() {
+  if (!g_preallocate_output)
+    return;
+
+  auto estimated_size = boost::accumulate(g_files, int64_t{}, [](int64_t size, filelist_cptr const &file) {
+    return size + (file->reader->m_reader_packetizers.empty() ? 0 : file->size);
+  });
+
+  estimated_size += 1 == g_file_num ? g_attachment_sizes_first : g_attachment_sizes_others;
+  estimated_size -= s_bytes_in_previous_files;
+
+  auto split_size = g_cluster_helper->get_current_split_size();
+  if (split_size)
+    estimated_size = std::min(estimated_size, split_size);
+
+  if (0 >= estimated_size)
+    return;
+
+  auto result = s_out->preallocate(estimated_size);
+
+  mxdebug_if(s_debug_preallocation, boost::format("preallocate_output_file: reserving %1% bytes for '%2%': %3%\n") % estimated_size % s_out->get_file_name() % (result ? "OK" : "failed"));
+}
+
 /** \brief Creates the next output file
 
    Creates a new file name depending on the split settings. Opens that
@@ -1343,7 +1479,7 @@ create_next_output_file() {
 
   // Open the output file.
   try {
-    s_out = !g_cluster_helper->discarding() ? mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024) : mm_io_cptr{ new mm_null_io_c{this_outfile} };
+    s_out = !g_cluster_helper->discarding() ? mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024, get_destination_file_flags()) : mm_io_cptr{ new mm_null_io_c{this_outfile} };
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % this_outfile % ex);
   }
@@ -1351,6 +1487,16 @@ create_next_output_file() {
   if (verbose && !g_cluster_helper->discarding())
     mxinfo(boost::format(Y("The file '%1%' has been opened for writing.\n")) % this_outfile);
 
+  preallocate_output_file();
+
+  // Seeking back isn't possible in streaming mode. Therefore all
+  // headers are kept in memory until the first cluster is rendered so
+  // that the packetizers can still update them.
+  if (g_streaming_output) {
+    s_streaming_out = s_out;
+    s_out           = std::make_shared<mm_mem_io_c>(nullptr, 0, 1024 * 1024);
+  }
+
   g_cluster_helper->set_output(s_out.get());
 
   render_headers(s_out.get());
@@ -1459,6 +1605,53 @@ render_chapters() {
   s_kax_chapters_void.reset();
 }
 
+/** \brief Writes the headers kept in memory to the destination in streaming mode
+
+   Called before the first cluster is rendered. The chapters and the
+   meta seek element are rendered into the space reserved for them,
+   and the segment's size is set to "unknown". Afterwards the headers
+   cannot be modified anymore.
+*/
+void
+finish_streaming_headers() {
+  if (!s_streaming_out)
+    return;
+
+  if (g_kax_chapters)
+    add_chapters_for_current_part();
+
+  render_chapters();
+
+  if (s_kax_as)
+    g_kax_sh_main->IndexThis(*s_kax_as, *g_kax_segment);
+
+  if (s_chapters_in_this_file && !hack_engaged(ENGAGE_NO_CHAPTERS_IN_META_SEEK))
+    g_kax_sh_main->IndexThis(*s_chapters_in_this_file, *g_kax_segment);
+
+  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+    g_kax_sh_main->UpdateSize();
+    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+      mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
+             % g_kax_sh_main->ElementSize() % BUGMSG);
+  }
+
+  // The segment's head was written with an eight byte long size
+  // field. Set all of its value bits in order to mark the size as
+  // unknown.
+  unsigned char unknown_size[8] = { 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+  s_out->setFilePointer(g_kax_segment->GetElementPosition() + g_kax_segment->HeadSize() - 8);
+  s_out->write(unknown_size, 8);
+
+  auto headers = static_cast<mm_mem_io_c *>(s_out.get());
+  s_streaming_out->write(headers->get_buffer(), headers->get_size());
+  s_streaming_out->flush();
+
+  s_out = s_streaming_out;
+  s_streaming_out.reset();
+
+  g_cluster_helper->set_output(s_out.get());
+}
+
 static KaxTags *
 set_track_statistics_tags(KaxTags *tags) {
   if (g_no_track_statistics_tags || outputting_webm())
@@ -1492,6 +1685,8 @@ finish_file(bool last_file,
 
   run_before_file_finished_packetizer_hooks();
 
+  finish_streaming_headers();
+
   bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
   if (do_output)
     mxinfo("\n");
@@ -1510,56 +1705,59 @@ finish_file(bool last_file,
     cues_c::get().write(*s_out, *g_kax_sh_main);
   }
 
-  // Now re-render the s_kax_duration and fill in the biggest timecode
-  // as the file's duration.
-  s_out->save_pos(s_kax_duration->GetElementPosition());
-  s_kax_duration->SetValue(calculate_file_duration());
-  s_kax_duration->Render(*s_out);
+  // The segment information cannot be updated when streaming.
+  if (!g_streaming_output) {
+    // Now re-render the s_kax_duration and fill in the biggest timecode
+    // as the file's duration.
+    s_out->save_pos(s_kax_duration->GetElementPosition());
+    s_kax_duration->SetValue(calculate_file_duration());
+    s_kax_duration->Render(*s_out);
 
-  // If splitting is active and this is the last part then handle the
-  // 'next segment UID'. If it was given on the command line then set it here.
-  // Otherwise remove an existing one (e.g. from file linking during
-  // splitting).
-
-  s_kax_infos->UpdateSize(true);
-  int64_t info_size = s_kax_infos->ElementSize();
-  int changed       = 0;
-
-  if (last_file && g_seguid_link_next) {
-    GetChild<KaxNextUID>(*s_kax_infos).CopyBuffer(g_seguid_link_next->data(), 128 / 8);
-    changed = 1;
-
-  } else if (last_file || g_no_linking) {
-    size_t i;
-    for (i = 0; s_kax_infos->ListSize() > i; ++i)
-      if (Is<KaxNextUID>((*s_kax_infos)[i])) {
-        delete (*s_kax_infos)[i];
-        s_kax_infos->Remove(i);
-        changed = 2;
-        break;
-      }
-  }
+    // If splitting is active and this is the last part then handle the
+    // 'next segment UID'. If it was given on the command line then set it here.
+    // Otherwise remove an existing one (e.g. from file linking during
+    // splitting).
 
-  if (0 != changed) {
-    s_out->setFilePointer(s_kax_infos->GetElementPosition());
     s_kax_infos->UpdateSize(true);
-    info_size -= s_kax_infos->ElementSize();
-    s_kax_infos->Render(*s_out, true);
-    if (2 == changed) {
-      if (2 < info_size) {
-        EbmlVoid void_after_infos;
-        void_after_infos.SetSize(info_size);
-        void_after_infos.UpdateSize();
-        void_after_infos.SetSize(info_size - void_after_infos.HeadSize());
-        void_after_infos.Render(*s_out);
-
-      } else if (0 < info_size) {
-        char zero[2] = {0, 0};
-        s_out->write(zero, info_size);
+    int64_t info_size = s_kax_infos->ElementSize();
+    int changed       = 0;
+
+    if (last_file && g_seguid_link_next) {
+      GetChild<KaxNextUID>(*s_kax_infos).CopyBuffer(g_seguid_link_next->data(), 128 / 8);
+      changed = 1;
+
+    } else if (last_file || g_no_linking) {
+      size_t i;
+      for (i = 0; s_kax_infos->ListSize() > i; ++i)
+        if (Is<KaxNextUID>((*s_kax_infos)[i])) {
+          delete (*s_kax_infos)[i];
+          s_kax_infos->Remove(i);
+          changed = 2;
+          break;
+        }
+    }
+
+    if (0 != changed) {
+      s_out->setFilePointer(s_kax_infos->GetElementPosition());
+      s_kax_infos->UpdateSize(true);
+      info_size -= s_kax_infos->ElementSize();
+      s_kax_infos->Render(*s_out, true);
+      if (2 == changed) {
+        if (2 < info_size) {
+          EbmlVoid void_after_infos;
+          void_after_infos.SetSize(info_size);
+          void_after_infos.UpdateSize();
+          void_after_infos.SetSize(info_size - void_after_infos.HeadSize());
+          void_after_infos.Render(*s_out);
+
+        } else if (0 < info_size) {
+          char zero[2] = {0, 0};
+          s_out->write(zero, info_size);
+        }
       }
     }
+    s_out->restore_pos();
   }
-  s_out->restore_pos();
 
   // Render the segment info a second time if the user has requested that.
   if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
@@ -1567,7 +1765,8 @@ finish_file(bool last_file,
     g_kax_sh_main->IndexThis(*s_kax_infos, *g_kax_segment);
   }
 
-  render_chapters();
+  if (!g_streaming_output)
+    render_chapters();
 
   // Render the meta seek information with the cues
   if (g_write_meta_seek_for_clusters && (g_kax_sh_cues->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
@@ -1614,18 +1813,26 @@ finish_file(bool last_file,
     s_kax_as.reset();
   }
 
-  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK) && !g_streaming_output) {
     g_kax_sh_main->UpdateSize();
     if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
              % g_kax_sh_main->ElementSize() % BUGMSG);
   }
 
-  // Set the correct size for the segment.
+  // Set the correct size for the segment. It stays unknown when
+  // streaming.
   int64_t final_file_size = s_out->getFilePointer();
-  if (g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+  if (!g_streaming_output && g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
     g_kax_segment->OverwriteHead(*s_out);
 
+  // Release the space reserved by preallocate_output_file() that
+  // hasn't been used.
+  if (g_preallocate_output)
+    s_out->truncate(final_file_size);
+
+  s_bytes_in_previous_files += final_file_size;
+
   s_out.reset();
 
   g_kax_segment.reset();
@@ -1636,8 +1843,22 @@ finish_file(bool last_file,
   s_head.reset();
 }
 
+static void
+drop_streaming_headers() {
+  // In streaming mode the headers are kept in memory until the first
+  // cluster is written. The actual destination is s_streaming_out
+  // until then.
+  if (!s_streaming_out)
+    return;
+
+  s_out = s_streaming_out;
+  s_streaming_out.reset();
+}
+
 void
 force_close_output_file() {
+  drop_streaming_headers();
+
   if (!s_out)
     return;
 
@@ -2057,6 +2278,11 @@ main_loop() {
 
       winner->pack.reset();
 
+      if (progress_format_e::json == g_progress_format) {
+        ++s_num_packets_by_track[pack->source->get_track_num()];
+        s_last_output_timestamp = timestamp_c::ns(pack->assigned_timecode);
+      }
+
       // If splitting by parts is active and the last part has been
       // processed fully then we can finish up.
       if (g_cluster_helper->is_splitting_and_processed_fully()) {
@@ -2094,6 +2320,8 @@ destroy_readers() {
 */
 void
 cleanup() {
+  drop_streaming_headers();
+
   if (s_out) {
     // If cleanup was called as a result of an exception during
     // writing due to the file system being full, the destructor would
@@ -123,6 +123,11 @@ enum class identification_output_format_e {
   json,
 };
 
+enum class progress_format_e {
+  text,
+  json,
+};
+
 class family_uids_c: public std::vector<bitvalue_c> {
 public:
   bool add_family_uid(const KaxSegmentFamily &family);
@@ -172,16 +177,20 @@ extern float g_video_fps;
 extern generic_packetizer_c *g_video_packetizer;
 
 extern bool g_write_cues, g_cue_writing_requested;
-extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags;
+extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags, g_preallocate_output, g_streaming_output, g_fast_split, g_fast_remux, g_parallel_parsing;
 
 extern bool g_identifying;
 extern identification_output_format_e g_identification_output_format;
 
+extern progress_format_e g_progress_format;
+
 extern int g_file_num;
 extern int64_t g_file_sizes;
 
 extern int64_t g_max_ns_per_cluster;
 extern int g_max_blocks_per_cluster;
+extern int64_t g_read_ahead_size;
+extern bool g_avoid_page_cache, g_direct_output;
 extern int g_default_tracks[3], g_default_tracks_priority[3];
 
 extern int g_split_max_num_files;
@@ -206,6 +215,7 @@ void create_next_output_file();
 void finish_file(bool last_file, bool create_new_file = false, bool previously_discarding = false);
 void force_close_output_file();
 void rerender_track_headers();
+void finish_streaming_headers();
 void rerender_ebml_head();
 std::string create_output_name();
 
@@ -214,6 +224,10 @@ bool set_required_matroska_read_version(unsigned int required_version);
 
 int64_t add_attachment(attachment_cptr const &attachment);
 
+std::size_t get_read_ahead_size();
+unsigned int get_source_file_flags();
+unsigned int get_destination_file_flags();
+
 #if defined(SYS_UNIX) || defined(SYS_APPLE)
 void sighandler(int signum);
 #endif
@@ -0,0 +1,158 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   running a packetizer's parser in a separate thread
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/at_scope_exit.h"
+#include "common/memory_accounting.h"
+#include "merge/output_control.h"
+#include "merge/packetizer_worker.h"
+
+static auto &s_pending_memory = mtx::memory_accounting::component("packetizer workers");
+
+packetizer_worker_c::packetizer_worker_c(std::size_t max_pending_jobs)
+  : m_max_pending_jobs{std::max<std::size_t>(max_pending_jobs, 1)}
+{
+  m_thread = std::make_unique<std::thread>(&packetizer_worker_c::run, this);
+}
+
+packetizer_worker_c::~packetizer_worker_c() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop_requested = true;
+    m_jobs.clear();
+  }
+
+  m_job_available.notify_all();
+  m_thread->join();
+
+  for (auto const &result : m_results)
+    s_pending_memory.remove(result.m_num_bytes);
+}
+
+std::unique_ptr<packetizer_worker_c>
+packetizer_worker_c::create_if_enabled() {
+  if (!g_parallel_parsing)
+    return {};
+
+  return std::make_unique<packetizer_worker_c>();
+}
+
+void
+packetizer_worker_c::submit(job_t job) {
+  enqueue(std::move(job), 0);
+}
+
+void
+packetizer_worker_c::enqueue(job_t job,
+                             int64_t num_bytes) {
+  // Limit the amount of data held by pending jobs and their results.
+  if (m_results.size() >= m_max_pending_jobs)
+    complete_next_job();
+
+  auto messages = std::make_shared<captured_messages_t>();
+  auto task     = std::packaged_task<completion_t()>{[job = std::move(job), messages]() -> completion_t {
+    capture_messages_of_current_thread(messages.get());
+    at_scope_exit_c stop_capturing{[]() { capture_messages_of_current_thread(nullptr); }};
+
+    return job();
+  }};
+
+  m_results.push_back(pending_result_t{task.get_future(), messages, num_bytes});
+  s_pending_memory.add(num_bytes);
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_jobs.push_back(std::move(task));
+  }
+
+  m_job_available.notify_one();
+}
+
+/** \brief Submits a job that parses the data of \c packet
+
+   Readers often pass on memory they don't own, e.g. their re-used
+   read buffer or a block that is freed together with its cluster.
+   Such memory may be overwritten or freed as soon as \c process()
+   returns, so the packet's data is copied here before the job can
+   access it.
+*/
+void
+packetizer_worker_c::submit(packet_cptr const &packet,
+                            job_t job) {
+  if (packet->data)
+    packet->data->grab();
+
+  enqueue(std::move(job), packet->data ? packet->data->get_size() : 0);
+}
+
+/** \brief Runs the completions of all jobs finished so far
+
+   Stops at the first job that is still pending so that completions
+   are run in submission order. Returns whether or not at least one
+   completion has been run.
+*/
+bool
+packetizer_worker_c::complete_finished_jobs() {
+  auto completed = false;
+
+  while (   !m_results.empty()
+         && (m_results.front().m_result.wait_for(std::chrono::seconds::zero()) == std::future_status::ready)) {
+    complete_next_job();
+    completed = true;
+  }
+
+  return completed;
+}
+
+void
+packetizer_worker_c::complete_all_jobs() {
+  while (!m_results.empty())
+    complete_next_job();
+}
+
+void
+packetizer_worker_c::complete_next_job() {
+  auto result = std::move(m_results.front());
+  m_results.pop_front();
+  s_pending_memory.remove(result.m_num_bytes);
+
+  // Waiting for the result makes the job's messages visible to this
+  // thread.
+  result.m_result.wait();
+  replay_captured_messages(*result.m_messages);
+
+  auto completion = result.m_result.get();
+  if (completion)
+    completion();
+}
+
+void
+packetizer_worker_c::run() {
+  while (true) {
+    auto task = std::packaged_task<completion_t()>{};
+
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_job_available.wait(lock, [this]() { return m_stop_requested || !m_jobs.empty(); });
+
+      if (m_stop_requested)
+        return;
+
+      task = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+
+    task();
+  }
+}
@@ -0,0 +1,93 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   class definition for running a packetizer's parser in a separate thread
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_PACKETIZER_WORKER_H
+#define MTX_MERGE_PACKETIZER_WORKER_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "merge/packet.h"
+
+/** \brief Runs the parsing stage of a packetizer in a separate thread
+
+   Jobs are executed one after the other in the order they've been
+   submitted. A job may only access state that nothing else touches
+   while jobs are pending, usually the packetizer's bitstream parser.
+   It returns a completion function that is run by the thread that
+   submitted the job and that hands the parsed frames over to the
+   packetizer. Completions are always run in submission order, so the
+   packetizer's queue receives the same packets in the same order as
+   without a worker.
+
+   Exceptions thrown by a job are re-thrown in the submitting thread
+   when its completion is due. Informational messages and warnings
+   issued by a job are collected and output by the submitting thread
+   right before the job's completion is run.
+
+   The data of packets submitted with their jobs is accounted for in
+   the "packetizer workers" memory accounting component until the
+   job's completion has been run.
+*/
+class packetizer_worker_c {
+public:
+  using completion_t = std::function<void()>;
+  using job_t        = std::function<completion_t()>;
+
+protected:
+  std::size_t const m_max_pending_jobs;
+
+  struct pending_result_t {
+    std::future<completion_t> m_result;
+    std::shared_ptr<captured_messages_t> m_messages;
+    int64_t m_num_bytes{};
+  };
+
+  // Only used by the submitting thread.
+  std::deque<pending_result_t> m_results;
+
+  // Shared with the worker thread; protected by m_mutex.
+  std::mutex m_mutex;
+  std::condition_variable m_job_available;
+  std::deque<std::packaged_task<completion_t()>> m_jobs;
+  bool m_stop_requested{};
+  std::unique_ptr<std::thread> m_thread;
+
+public:
+  packetizer_worker_c(std::size_t max_pending_jobs = 32);
+  virtual ~packetizer_worker_c();
+
+  void submit(job_t job);
+  void submit(packet_cptr const &packet, job_t job);
+  bool complete_finished_jobs();
+  void complete_all_jobs();
+
+  bool is_idle() const {
+    return m_results.empty();
+  }
+
+  static std::unique_ptr<packetizer_worker_c> create_if_enabled();
+
+protected:
+  void enqueue(job_t job, int64_t num_bytes);
+  void complete_next_job();
+  void run();
+};
+
+#endif // MTX_MERGE_PACKETIZER_WORKER_H
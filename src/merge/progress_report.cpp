@@ -0,0 +1,118 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   machine-readable progress reports
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/command_line.h"
+#include "merge/progress_report.h"
+
+namespace {
+
+double
+fraction_done(progress_report_c::sample_t const &sample) {
+  if (sample.m_bytes_total)
+    return std::min(static_cast<double>(sample.m_bytes_read) / sample.m_bytes_total, 1.0);
+  return std::min(sample.m_percentage, 100) / 100.0;
+}
+
+// Readers may seek back, e.g. when a Matroska file's cues are read
+// after the clusters. The amount read since the previous sample is
+// then treated as zero instead of reporting a negative rate.
+nlohmann::json
+rate(uint64_t current,
+     uint64_t previous,
+     int64_t duration_ms) {
+  if (0 >= duration_ms)
+    return {};
+  return current > previous ? (current - previous) * 1000 / duration_ms : uint64_t{};
+}
+
+}
+
+nlohmann::json
+progress_report_c::add_sample(sample_t const &sample) {
+  if (!m_first)
+    m_first = sample;
+
+  auto duration = m_previous ? sample.m_time_ms - m_previous->m_time_ms : 0;
+  auto tracks   = nlohmann::json::array();
+
+  for (auto const &track : sample.m_tracks) {
+    auto previous_num_packets = int64_t{};
+
+    if (m_previous)
+      for (auto const &previous_track : m_previous->m_tracks)
+        if (previous_track.m_id == track.m_id)
+          previous_num_packets = previous_track.m_num_packets;
+
+    auto packet_rate = 0 < duration ? nlohmann::json(static_cast<double>(std::max<int64_t>(track.m_num_packets - previous_num_packets, 0)) * 1000 / duration) : nlohmann::json{};
+
+    tracks.push_back(nlohmann::json{
+      { "id",          track.m_id          },
+      { "packets",     track.m_num_packets },
+      { "packet_rate", packet_rate         },
+    });
+  }
+
+  auto remaining_time = estimate_remaining_time(sample);
+  auto json           = nlohmann::json{
+    { "progress",       sample.m_percentage                   },
+    { "elapsed",        sample.m_time_ms - m_first->m_time_ms },
+    { "bytes_read",     sample.m_bytes_read                   },
+    { "bytes_total",    sample.m_bytes_total                  },
+    { "bytes_written",  sample.m_bytes_written                },
+    { "read_rate",      nlohmann::json{}                      },
+    { "write_rate",     nlohmann::json{}                      },
+    { "timestamp",      nlohmann::json{}                      },
+    { "remaining_time", nlohmann::json{}                      },
+    { "tracks",         tracks                                },
+  };
+
+  if (m_previous) {
+    json["read_rate"]  = rate(sample.m_bytes_read,    m_previous->m_bytes_read,    duration);
+    json["write_rate"] = rate(sample.m_bytes_written, m_previous->m_bytes_written, duration);
+  }
+
+  if (sample.m_timestamp.valid())
+    json["timestamp"] = sample.m_timestamp.to_ns();
+
+  if (remaining_time)
+    json["remaining_time"] = *remaining_time;
+
+  m_previous = sample;
+
+  return json;
+}
+
+void
+progress_report_c::display(sample_t const &sample) {
+  auto json = mtx::json::dump(add_sample(sample));
+
+  if (g_gui_mode)
+    mxinfo(boost::format("#GUI#progress_json %1%\n") % json);
+  else
+    mxinfo(boost::format("%1%\n") % json);
+}
+
+boost::optional<int64_t>
+progress_report_c::estimate_remaining_time(sample_t const &sample)
+  const {
+  auto elapsed = sample.m_time_ms - m_first->m_time_ms;
+  auto done    = fraction_done(sample) - fraction_done(*m_first);
+
+  // Too little data for a meaningful estimate.
+  if ((1000 > elapsed) || (0 >= done))
+    return boost::none;
+
+  return static_cast<int64_t>(std::llround(elapsed * (1.0 - fraction_done(sample)) / done));
+}
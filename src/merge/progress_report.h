@@ -0,0 +1,54 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   class definition for the machine-readable progress reports
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_PROGRESS_REPORT_H
+#define MTX_MERGE_PROGRESS_REPORT_H
+
+#include "common/common_pch.h"
+
+#include "common/json.h"
+#include "common/timestamp.h"
+
+/** \brief Turns progress samples into JSON objects
+
+   Each sample contains the absolute counters at the time it was
+   taken. Rates are calculated from the difference to the previous
+   sample; the remaining time is extrapolated from the average rate
+   since the first sample.
+*/
+class progress_report_c {
+public:
+  struct track_t {
+    int64_t m_id{}, m_num_packets{};
+  };
+
+  struct sample_t {
+    int64_t m_time_ms{};
+    int m_percentage{};
+    uint64_t m_bytes_read{}, m_bytes_total{}, m_bytes_written{};
+    timestamp_c m_timestamp;
+    std::vector<track_t> m_tracks;
+  };
+
+protected:
+  boost::optional<sample_t> m_first, m_previous;
+
+public:
+  nlohmann::json add_sample(sample_t const &sample);
+  void display(sample_t const &sample);
+
+protected:
+  boost::optional<int64_t> estimate_remaining_time(sample_t const &sample) const;
+};
+
+#endif  // MTX_MERGE_PROGRESS_REPORT_H
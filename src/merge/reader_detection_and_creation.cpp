@@ -14,7 +14,7 @@
 
 // #include "common/logger.h"
 #include "common/mm_mpls_multi_file_io.h"
-#include "common/mm_read_buffer_io.h"
+#include "common/mm_read_ahead_io.h"
 #include "common/strings/formatting.h"
 #include "common/xml/xml.h"
 #include "input/r_aac.h"
@@ -57,6 +57,7 @@
 #include "input/r_webvtt.h"
 #include "merge/filelist.h"
 #include "merge/input_x.h"
+#include "merge/output_control.h"
 #include "merge/reader_detection_and_creation.h"
 
 static std::vector<bfs::path>
@@ -71,12 +72,15 @@ file_names_to_paths(const std::vector<std::string> &file_names) {
 static mm_io_cptr
 open_input_file(filelist_t &file) {
   try {
+    auto read_ahead_size = get_read_ahead_size();
+    auto flags           = get_source_file_flags();
+
     if (file.all_names.size() == 1)
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(file.name), 1 << 17));
+      return mm_io_cptr(mm_read_ahead_io_c::open(new mm_file_io_c(file.name, MODE_READ, flags), read_ahead_size));
 
     else {
       std::vector<bfs::path> paths = file_names_to_paths(file.all_names);
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_multi_file_io_c(paths, file.name), 1 << 17));
+      return mm_io_cptr(mm_read_ahead_io_c::open(new mm_multi_file_io_c(paths, file.name, flags), read_ahead_size));
     }
 
   } catch (mtx::mm_io::exception &ex) {
@@ -89,6 +93,18 @@ open_input_file(filelist_t &file) {
   }
 }
 
+/** \brief Wraps an opened playlist in a read-ahead proxy
+
+   The playlist is shared with the file list entry, so the proxy must
+   not delete it. It is kept alive as long as the proxy is instead.
+*/
+static mm_io_cptr
+open_playlist_input(filelist_t &file) {
+  auto mpls_in = file.playlist_mpls_in;
+
+  return mm_io_cptr(mm_read_ahead_io_c::open(mpls_in.get(), get_read_ahead_size(), false), [mpls_in](mm_io_c *io) { delete io; });
+}
+
 static bool
 open_playlist_file(filelist_t &file,
                    mm_io_c *in) {
@@ -311,7 +327,7 @@ create_readers() {
 
   for (auto &file : g_files) {
     try {
-      mm_io_cptr input_file = file->playlist_mpls_in ? std::static_pointer_cast<mm_io_c>(file->playlist_mpls_in) : open_input_file(*file);
+      mm_io_cptr input_file = file->playlist_mpls_in ? open_playlist_input(*file) : open_input_file(*file);
 
       switch (file->type) {
         case FILE_TYPE_AAC:
@@ -15,10 +15,59 @@
 #include "common/common_pch.h"
 
 #include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
 #include "merge/timestamp_factory.h"
 
+namespace {
+
+/* Timestamp files in format v2 can contain millions of lines. The
+   generic parse_number() splits the string and converts both parts
+   with boost::lexical_cast which dominates the time spent
+   parsing. Plain decimal numbers are therefore converted directly.
+   The result is identical as long as both the numerator and the
+   denominator can be represented exactly by a double. Everything else
+   is handed to parse_number().
+*/
+bool
+parse_decimal(std::string const &s,
+              double &value) {
+  uint64_t const max_exact = 1ull << 53;
+  uint64_t numerator       = 0;
+  uint64_t denominator     = 1;
+  auto in_fraction         = false;
+  auto idx                 = 0u;
+
+  for (auto const length = s.length(); idx < length; ++idx) {
+    auto c = s[idx];
+
+    if ((c == '.') && !in_fraction && (0 < idx)) {
+      in_fraction = true;
+      continue;
+    }
+
+    if (   (c < '0')
+        || (c > '9')
+        || (numerator   >= (max_exact / 10))
+        || (denominator >= (max_exact / 10)))
+      return parse_number(s, value);
+
+    numerator = numerator * 10 + (c - '0');
+    if (in_fraction)
+      denominator *= 10;
+  }
+
+  if (!idx)
+    return false;
+
+  value = static_cast<double>(numerator) / static_cast<double>(denominator);
+
+  return true;
+}
+
+}
+
 timestamp_factory_cptr
 timestamp_factory_c::create(const std::string &file_name,
                            const std::string &source_name,
@@ -28,7 +77,7 @@ timestamp_factory_c::create(const std::string &file_name,
 
   mm_io_c *in = nullptr;           // avoid gcc warning
   try {
-    in = new mm_text_io_c(new mm_file_io_c(file_name));
+    in = new mm_text_io_c(new mm_read_buffer_io_c(new mm_file_io_c(file_name), 1 << 17));
   } catch(...) {
     mxerror(boost::format(Y("The timecode file '%1%' could not be opened for reading.\n")) % file_name);
   }
@@ -68,8 +117,6 @@ void
 timestamp_factory_v1_c::parse(mm_io_c &in) {
   std::string line;
   timecode_range_c t;
-  std::vector<timecode_range_c>::iterator iit;
-  std::vector<timecode_range_c>::const_iterator pit;
 
   int line_no = 1;
   do {
@@ -120,30 +167,32 @@ timestamp_factory_v1_c::parse(mm_io_c &in) {
     t.start_frame = 0;
   else {
     std::sort(m_ranges.begin(), m_ranges.end());
-    bool done;
-    do {
-      done = true;
-      iit  = m_ranges.begin();
-      size_t i;
-      for (i = 0; i < (m_ranges.size() - 1); i++) {
-        iit++;
-        if (m_ranges[i].end_frame < (m_ranges[i + 1].start_frame - 1)) {
-          t.start_frame = m_ranges[i].end_frame + 1;
-          t.end_frame = m_ranges[i + 1].start_frame - 1;
-          t.fps = m_default_fps;
-          m_ranges.insert(iit, t);
-          done = false;
-          break;
-        }
-      }
-    } while (!done);
+
+    // Fill the gaps between the ranges with the default FPS in a
+    // single pass.
+    std::vector<timecode_range_c> ranges;
+    ranges.reserve(m_ranges.size() * 2 + 1);
+
     if (m_ranges[0].start_frame != 0) {
       t.start_frame = 0;
-      t.end_frame = m_ranges[0].start_frame - 1;
-      t.fps = m_default_fps;
-      m_ranges.insert(m_ranges.begin(), t);
+      t.end_frame   = m_ranges[0].start_frame - 1;
+      t.fps         = m_default_fps;
+      ranges.push_back(t);
+    }
+
+    for (auto idx = 0u, num_ranges = static_cast<unsigned int>(m_ranges.size()); idx < num_ranges; ++idx) {
+      ranges.push_back(m_ranges[idx]);
+
+      if (((idx + 1) < num_ranges) && (m_ranges[idx].end_frame < (m_ranges[idx + 1].start_frame - 1))) {
+        t.start_frame = m_ranges[idx].end_frame + 1;
+        t.end_frame   = m_ranges[idx + 1].start_frame - 1;
+        t.fps         = m_default_fps;
+        ranges.push_back(t);
+      }
     }
-    t.start_frame = m_ranges[m_ranges.size() - 1].end_frame + 1;
+
+    m_ranges.swap(ranges);
+    t.start_frame = m_ranges.back().end_frame + 1;
   }
 
   t.end_frame = 0xfffffffffffffffll;
@@ -151,12 +200,14 @@ timestamp_factory_v1_c::parse(mm_io_c &in) {
   m_ranges.push_back(t);
 
   m_ranges[0].base_timecode = 0.0;
-  pit = m_ranges.begin();
-  for (iit = m_ranges.begin() + 1; iit < m_ranges.end(); iit++, pit++)
-    iit->base_timecode = pit->base_timecode + ((double)pit->end_frame - (double)pit->start_frame + 1) * 1000000000.0 / pit->fps;
+  for (auto idx = 1u; idx < m_ranges.size(); ++idx) {
+    auto const &prev          = m_ranges[idx - 1];
+    m_ranges[idx].base_timecode = prev.base_timecode + ((double)prev.end_frame - (double)prev.start_frame + 1) * 1000000000.0 / prev.fps;
+  }
 
-  for (iit = m_ranges.begin(); iit < m_ranges.end(); iit++)
-    mxdebug_if(m_debug, boost::format("ranges: entry %1% -> %2% at %3% with %4%\n") % iit->start_frame % iit->end_frame % iit->fps % iit->base_timecode);
+  if (m_debug)
+    for (auto const &range : m_ranges)
+      mxdebug(boost::format("ranges: entry %1% -> %2% at %3% with %4%\n") % range.start_frame % range.end_frame % range.fps % range.base_timecode);
 }
 
 bool
@@ -166,7 +217,7 @@ timestamp_factory_v1_c::get_next(packet_cptr &packet) {
     packet->duration = get_at(m_frameno + 1) - packet->assigned_timecode;
 
   m_frameno++;
-  if ((m_frameno > m_ranges[m_current_range].end_frame) && (m_current_range < (m_ranges.size() - 1)))
+  while ((m_frameno > m_ranges[m_current_range].end_frame) && (m_current_range < (m_ranges.size() - 1)))
     m_current_range++;
 
   mxdebug_if(m_debug, boost::format("ext_timecodes v1: tc %1% dur %2% for %3%\n") % packet->assigned_timecode % packet->duration % (m_frameno - 1));
@@ -174,13 +225,32 @@ timestamp_factory_v1_c::get_next(packet_cptr &packet) {
   return false;
 }
 
+timecode_range_c const &
+timestamp_factory_v1_c::find_range(uint64_t frame)
+  const {
+  // Sequential access only ever needs the current range or the one
+  // following it.
+  auto const &current = m_ranges[m_current_range];
+  if ((frame >= current.start_frame) && (frame <= current.end_frame))
+    return current;
+
+  if ((m_current_range + 1) < m_ranges.size()) {
+    auto const &next = m_ranges[m_current_range + 1];
+    if ((frame >= next.start_frame) && (frame <= next.end_frame))
+      return next;
+  }
+
+  // The ranges are sorted, don't overlap and cover all frames.
+  auto itr = std::upper_bound(m_ranges.begin(), m_ranges.end(), frame, [](uint64_t wanted, timecode_range_c const &range) { return wanted < range.start_frame; });
+
+  return itr == m_ranges.begin() ? *itr : *(itr - 1);
+}
+
 int64_t
 timestamp_factory_v1_c::get_at(uint64_t frame) {
-  timecode_range_c *t = &m_ranges[m_current_range];
-  if ((frame > t->end_frame) && (m_current_range < (m_ranges.size() - 1)))
-    t = &m_ranges[m_current_range + 1];
+  auto const &t = find_range(frame);
 
-  return (int64_t)(t->base_timecode + 1000000000.0 * (frame - t->start_frame) / t->fps);
+  return (int64_t)(t.base_timecode + 1000000000.0 * (frame - t.start_frame) / t.fps);
 }
 
 void
@@ -199,7 +269,7 @@ timestamp_factory_v2_c::parse(mm_io_c &in) {
       continue;
 
     double timecode;
-    if (!parse_number(line.c_str(), timecode))
+    if (!parse_decimal(line, timecode))
       mxerror(boost::format(Y("The line %1% of the timecode file '%2%' does not contain a valid floating point number.\n")) % line_no % m_file_name);
 
     if ((2 == m_version) && (timecode < previous_timecode))
@@ -214,16 +284,15 @@ timestamp_factory_v2_c::parse(mm_io_c &in) {
               % in.get_file_name());
 
     previous_timecode = timecode;
-    m_timecodes.push_back((int64_t)(timecode * 1000000));
-    if (m_timecodes.size() > 1) {
-      int64_t duration = m_timecodes[m_timecodes.size() - 1] - m_timecodes[m_timecodes.size() - 2];
-      if (dur_map.find(duration) == dur_map.end())
-        dur_map[duration] = 1;
-      else
-        dur_map[duration] = dur_map[duration] + 1;
+    auto timestamp    = (int64_t)(timecode * 1000000);
+
+    if (!m_timecodes.empty()) {
+      int64_t duration = timestamp - m_timecodes.back();
+      ++dur_map[duration];
       dur_sum += duration;
-      m_durations.push_back(duration);
     }
+
+    m_timecodes.add(timestamp);
   }
 
   if (m_timecodes.empty())
@@ -249,16 +318,19 @@ timestamp_factory_v2_c::parse(mm_io_c &in) {
   if (0 < dur_sum)
     m_default_duration = dur_sum;
 
-  m_durations.push_back(dur_sum);
+  m_last_duration = dur_sum;
+
+  mxdebug_if(m_debug, boost::format("ext_timecodes: Version %1%, %2% entries, %3% bytes used\n") % m_version % m_timecodes.size() % m_timecodes.get_memory_usage());
 }
 
 bool
 timestamp_factory_v2_c::get_next(packet_cptr &packet) {
-  if ((static_cast<size_t>(m_frameno) >= m_timecodes.size()) && !m_warning_printed) {
-    mxwarn_tid(m_source_name, m_tid,
-               boost::format(Y("The number of external timecodes %1% is smaller than the number of frames in this track. "
-                               "The remaining frames of this track might not be timestamped the way you intended them to be. mkvmerge might even crash.\n"))
-               % m_timecodes.size());
+  if (static_cast<size_t>(m_frameno) >= m_timecodes.size()) {
+    if (!m_warning_printed)
+      mxwarn_tid(m_source_name, m_tid,
+                 boost::format(Y("The number of external timecodes %1% is smaller than the number of frames in this track. "
+                                 "The remaining frames of this track might not be timestamped the way you intended them to be. mkvmerge might even crash.\n"))
+                 % m_timecodes.size());
     m_warning_printed = true;
 
     if (m_timecodes.empty()) {
@@ -275,9 +347,11 @@ timestamp_factory_v2_c::get_next(packet_cptr &packet) {
     return false;
   }
 
-  packet->assigned_timecode = m_timecodes[m_frameno];
+  // Both entries are decoded sequentially; the second one is re-used
+  // for the next frame.
+  packet->assigned_timecode = m_timecodes.get(m_frameno);
   if (!m_preserve_duration || (0 >= packet->duration))
-    packet->duration = m_durations[m_frameno];
+    packet->duration = static_cast<size_t>(m_frameno + 1) < m_timecodes.size() ? m_timecodes.get(m_frameno + 1) - packet->assigned_timecode : m_last_duration;
   m_frameno++;
 
   return false;
@@ -16,6 +16,7 @@
 
 #include "common/common_pch.h"
 
+#include "merge/compact_timestamp_list.h"
 #include "merge/packet.h"
 #include "merge/track_info.h"
 
@@ -121,11 +122,13 @@ public:
 
 protected:
   virtual int64_t get_at(uint64_t frame);
+  timecode_range_c const &find_range(uint64_t frame) const;
 };
 
 class timestamp_factory_v2_c: public timestamp_factory_c {
 protected:
-  std::vector<int64_t> m_timecodes, m_durations;
+  compact_timestamp_list_c m_timecodes;
+  int64_t m_last_duration;
   int64_t m_frameno;
   double m_default_duration;
   bool m_warning_printed;
@@ -135,6 +138,7 @@ public:
                         const std::string &source_name,
                         int64_t tid, int version)
     : timestamp_factory_c(file_name, source_name, tid, version)
+    , m_last_duration(0)
     , m_frameno(0)
     , m_default_duration(0)
     , m_warning_printed(false)
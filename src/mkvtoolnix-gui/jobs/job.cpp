@@ -8,6 +8,7 @@
 #include "common/list_utils.h"
 #include "common/logger.h"
 #include "common/qt.h"
+#include "common/strings/formatting.h"
 #include "mkvtoolnix-gui/jobs/job.h"
 #include "mkvtoolnix-gui/jobs/mux_job.h"
 #include "mkvtoolnix-gui/merge/mux_config.h"
@@ -66,6 +67,21 @@ Job::progress()
   return m_progress;
 }
 
+Job::Statistics
+Job::statistics()
+  const {
+  return m_statistics;
+}
+
+QString
+Job::displayableThroughput()
+  const {
+  if ((Running != m_status) || !m_statistics.m_readRate)
+    return {};
+
+  return QY("%1/s").arg(Q(format_file_size(*m_statistics.m_readRate)));
+}
+
 QStringList const &
 Job::output()
   const {
@@ -164,6 +180,7 @@ Job::setStatus(Status status) {
     m_errors.clear();
     m_warningsAcknowledged = 0;
     m_errorsAcknowledged   = 0;
+    m_statistics           = Statistics{};
 
   } else if ((DoneOk == status) || (DoneWarnings == status) || (Failed == status) || (Aborted == status))
     m_dateFinished = QDateTime::currentDateTime();
@@ -192,6 +209,14 @@ Job::setProgress(unsigned int progress) {
   emit progressChanged(m_id, m_progress);
 }
 
+void
+Job::setStatistics(Statistics const &statistics) {
+  QMutexLocker locked{&m_mutex};
+
+  m_statistics = statistics;
+  emit statisticsChanged(m_id, m_statistics);
+}
+
 void
 Job::setPendingAuto() {
   QMutexLocker locked{&m_mutex};
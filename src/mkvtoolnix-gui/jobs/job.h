@@ -45,6 +45,14 @@ public:
     ErrorLine,
   };
 
+  // Reported by programs supporting machine-readable progress reports
+  // while the job is running.
+  struct Statistics {
+    uint64_t m_bytesRead{}, m_bytesTotal{}, m_bytesWritten{};
+    boost::optional<uint64_t> m_readRate, m_writeRate;
+    boost::optional<int64_t> m_timestamp, m_remainingTime;
+  };
+
 private:
   static uint64_t ms_next_id;
 
@@ -55,6 +63,7 @@ protected:
   QString m_description;
   QStringList m_output, m_warnings, m_errors, m_fullOutput;
   unsigned int m_progress, m_exitCode;
+  Statistics m_statistics;
   int m_warningsAcknowledged, m_errorsAcknowledged;
   QDateTime m_dateAdded, m_dateStarted, m_dateFinished;
   bool m_quitAfterFinished, m_modified;
@@ -72,6 +81,8 @@ public:
   Status status() const;
   QString description() const;
   unsigned int progress() const;
+  Statistics statistics() const;
+  QString displayableThroughput() const;
 
   QStringList const &output() const;
   QStringList const &warnings() const;
@@ -119,6 +130,7 @@ protected:
 public slots:
   virtual void setStatus(Job::Status status);
   virtual void setProgress(unsigned int progress);
+  virtual void setStatistics(mtx::gui::Jobs::Job::Statistics const &statistics);
   virtual void addLineToInternalLogs(QString const &line, mtx::gui::Jobs::Job::LineType type);
   virtual void abort() = 0;
   virtual void updateUnacknowledgedWarningsAndErrors();
@@ -127,6 +139,7 @@ public slots:
 signals:
   void statusChanged(uint64_t id, mtx::gui::Jobs::Job::Status oldStatus, mtx::gui::Jobs::Job::Status newStatus);
   void progressChanged(uint64_t id, unsigned int progress);
+  void statisticsChanged(uint64_t id, mtx::gui::Jobs::Job::Statistics const &statistics);
   void numUnacknowledgedWarningsOrErrorsChanged(uint64_t id, int numWarnings, int numErrors);
 
   void lineRead(QString const &line, mtx::gui::Jobs::Job::LineType type);
@@ -143,5 +156,6 @@ public:                         // static
 
 Q_DECLARE_METATYPE(mtx::gui::Jobs::Job::LineType);
 Q_DECLARE_METATYPE(mtx::gui::Jobs::Job::Status);
+Q_DECLARE_METATYPE(mtx::gui::Jobs::Job::Statistics);
 
 #endif  // MTX_MKVTOOLNIX_GUI_JOBS_JOB_H
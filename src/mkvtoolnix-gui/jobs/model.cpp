@@ -54,6 +54,7 @@ Model::retranslateUi() {
     { QY("Date added"),    Q("dateAdded")      },
     { QY("Date started"),  Q("dateStarted")    },
     { QY("Date finished"), Q("dateFinished")   },
+    { QY("Throughput"),    Q("throughput")     },
   });
 
   horizontalHeaderItem(StatusIconColumn)->setIcon(QIcon{Q(":/icons/16x16/dialog-warning-grayscale.png")});
@@ -64,6 +65,7 @@ Model::retranslateUi() {
   horizontalHeaderItem(DateAddedColumn)   ->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
   horizontalHeaderItem(DateStartedColumn) ->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
   horizontalHeaderItem(DateFinishedColumn)->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+  horizontalHeaderItem(ThroughputColumn)  ->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
 
   for (auto row = 0, numRows = rowCount(); row < numRows; ++row) {
     auto idx = index(row, 0);
@@ -139,12 +141,14 @@ Model::setRowText(QList<QStandardItem *> const &items,
   items.at(DateAddedColumn)   ->setText(Util::displayableDate(job.dateAdded()));
   items.at(DateStartedColumn) ->setText(Util::displayableDate(job.dateStarted()));
   items.at(DateFinishedColumn)->setText(Util::displayableDate(job.dateFinished()));
+  items.at(ThroughputColumn)  ->setText(job.displayableThroughput());
 
   items[DescriptionColumn ]->setTextAlignment(Qt::AlignLeft  | Qt::AlignVCenter);
   items[ProgressColumn    ]->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
   items[DateAddedColumn   ]->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
   items[DateStartedColumn ]->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
   items[DateFinishedColumn]->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+  items[ThroughputColumn  ]->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
 
   auto numWarnings = job.numUnacknowledgedWarnings();
   auto numErrors   = job.numUnacknowledgedErrors();
@@ -156,7 +160,7 @@ QList<QStandardItem *>
 Model::itemsForRow(QModelIndex const &idx) {
   auto rowItems = QList<QStandardItem *>{};
 
-  for (auto column = 0; 8 > column; ++column)
+  for (auto column = 0; 9 > column; ++column)
     rowItems << itemFromIndex(idx.sibling(idx.row(), column));
 
   return rowItems;
@@ -166,7 +170,7 @@ QList<QStandardItem *>
 Model::createRow(Job const &job)
   const {
   auto items = QList<QStandardItem *>{};
-  for (auto idx = 0; idx < 8; ++idx)
+  for (auto idx = 0; idx < 9; ++idx)
     items << new QStandardItem{};
   setRowText(items, job);
 
@@ -245,6 +249,7 @@ Model::add(JobPtr const &job) {
   invisibleRootItem()->appendRow(createRow(*job));
 
   connect(job.get(), &Job::progressChanged,                          this, &Model::onProgressChanged);
+  connect(job.get(), &Job::statisticsChanged,                        this, &Model::onStatisticsChanged);
   connect(job.get(), &Job::statusChanged,                            this, &Model::onStatusChanged);
   connect(job.get(), &Job::numUnacknowledgedWarningsOrErrorsChanged, this, &Model::onNumUnacknowledgedWarningsOrErrorsChanged);
 
@@ -280,6 +285,7 @@ Model::onStatusChanged(uint64_t id,
   item(row, StatusColumn)->setText(Job::displayableStatus(status));
   item(row, DateStartedColumn)->setText(Util::displayableDate(job.dateStarted()));
   item(row, DateFinishedColumn)->setText(Util::displayableDate(job.dateFinished()));
+  item(row, ThroughputColumn)->setText(job.displayableThroughput());
 
   if ((Job::Running == status) && !m_running) {
     m_running        = true;
@@ -343,6 +349,16 @@ Model::onProgressChanged(uint64_t id,
   }
 }
 
+void
+Model::onStatisticsChanged(uint64_t id,
+                           mtx::gui::Jobs::Job::Statistics const &) {
+  QMutexLocker locked{&m_mutex};
+
+  auto row = rowFromId(id);
+  if (RowNotFound != row)
+    item(row, ThroughputColumn)->setText(m_jobsById[id]->displayableThroughput());
+}
+
 void
 Model::onNumUnacknowledgedWarningsOrErrorsChanged(uint64_t id,
                                                   int,
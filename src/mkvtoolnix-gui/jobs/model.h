@@ -43,6 +43,7 @@ public:
   static int const DateAddedColumn    = 5;
   static int const DateStartedColumn  = 6;
   static int const DateFinishedColumn = 7;
+  static int const ThroughputColumn   = 8;
 
   static int const RowNotFound        = -1;
 
@@ -91,6 +92,7 @@ signals:
 public slots:
   void onStatusChanged(uint64_t id, mtx::gui::Jobs::Job::Status oldStatus, mtx::gui::Jobs::Job::Status newStatus);
   void onProgressChanged(uint64_t id, unsigned int progress);
+  void onStatisticsChanged(uint64_t id, mtx::gui::Jobs::Job::Statistics const &statistics);
   void onNumUnacknowledgedWarningsOrErrorsChanged(uint64_t id, int numWarnings, int numErrors);
   void removeScheduledJobs();
 
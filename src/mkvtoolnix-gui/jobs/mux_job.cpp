@@ -8,6 +8,7 @@
 #include <QTemporaryFile>
 #include <QTimer>
 
+#include "common/json.h"
 #include "common/qt.h"
 #include "mkvtoolnix-gui/jobs/mux_job.h"
 #include "mkvtoolnix-gui/main_window/main_window.h"
@@ -21,6 +22,25 @@ namespace mtx { namespace gui { namespace Jobs {
 
 using namespace mtx::gui;
 
+namespace {
+
+template<typename T>
+boost::optional<T>
+optionalNumber(nlohmann::json const &json,
+               char const *key) {
+  auto itr = json.find(key);
+  if ((itr == json.end()) || !itr->is_number())
+    return boost::none;
+
+  // Converting a negative number to an unsigned type would wrap around.
+  if (std::is_unsigned<T>::value && (itr->get<double>() < 0))
+    return boost::none;
+
+  return itr->get<T>();
+}
+
+}
+
 MuxJob::MuxJob(Status status,
                Merge::MuxConfigPtr const &config)
   : Job{status}
@@ -52,7 +72,7 @@ MuxJob::start() {
   setStatus(Job::Running);
   setProgress(0);
 
-  m_process.start(Util::Settings::get().actualMkvmergeExe(), QStringList{} << "--gui-mode" << QString{"@%1"}.arg(m_settingsFile->fileName()), QIODevice::ReadOnly);
+  m_process.start(Util::Settings::get().actualMkvmergeExe(), QStringList{} << "--gui-mode" << "--progress-format" << "json" << QString{"@%1"}.arg(m_settingsFile->fileName()), QIODevice::ReadOnly);
 }
 
 void
@@ -102,6 +122,11 @@ MuxJob::processLine(QString const &rawLine) {
     return;
   }
 
+  if (line.startsWith("#GUI#progress_json ")) {
+    processProgressReport(line.mid(19));
+    return;
+  }
+
   auto matches = QRegularExpression{"^#GUI#progress\\s+(\\d+)%"}.match(line);
   if (matches.hasMatch()) {
     setProgress(matches.captured(1).toUInt());
@@ -111,6 +136,34 @@ MuxJob::processLine(QString const &rawLine) {
   emit lineRead(line, InfoLine);
 }
 
+void
+MuxJob::processProgressReport(QString const &json) {
+  auto report = nlohmann::json{};
+
+  try {
+    report = mtx::json::parse(to_utf8(json));
+  } catch (std::exception const &) {
+    return;
+  }
+
+  if (!report.is_object())
+    return;
+
+  auto statistics            = Statistics{};
+  statistics.m_bytesRead     = optionalNumber<uint64_t>(report, "bytes_read").value_or(0);
+  statistics.m_bytesTotal    = optionalNumber<uint64_t>(report, "bytes_total").value_or(0);
+  statistics.m_bytesWritten  = optionalNumber<uint64_t>(report, "bytes_written").value_or(0);
+  statistics.m_readRate      = optionalNumber<uint64_t>(report, "read_rate");
+  statistics.m_writeRate     = optionalNumber<uint64_t>(report, "write_rate");
+  statistics.m_timestamp     = optionalNumber<int64_t>(report, "timestamp");
+  statistics.m_remainingTime = optionalNumber<int64_t>(report, "remaining_time");
+
+  if (auto progress = optionalNumber<unsigned int>(report, "progress"))
+    setProgress(*progress);
+
+  setStatistics(statistics);
+}
+
 void
 MuxJob::readAvailable() {
   m_bytesRead += m_process.readAllStandardOutput();
@@ -55,6 +55,7 @@ public slots:
 protected:
   void processBytesRead();
   void processLine(QString const &rawLine);
+  void processProgressReport(QString const &json);
   virtual void saveJobInternal(Util::ConfigFile &settings) const;
   virtual void runProgramSetupVariables(ProgramRunner::VariableMap &variables) override;
 
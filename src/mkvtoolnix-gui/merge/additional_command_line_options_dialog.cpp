@@ -42,6 +42,31 @@ AdditionalCommandLineOptionsDialog::AdditionalCommandLineOptionsDialog(QWidget *
   add(Q("--disable-lacing"),                false, global, { QY("Disables lacing for all tracks."), QY("This will increase the file's size, especially if there are many audio tracks."), QY("Use only for testing.") });
   add(Q("--enable-durations"),              false, global, { QY("Write durations for all blocks."), QY("This will increase file size and does not offer any additional value for players at the moment.") });
   add(Q("--disable-track-statistics-tags"), false, global, { QY("Tells mkvmerge not to write tags with statistics for each track.") });
+  add(Q("--streaming-output"),              false, global,
+      { QY("Tells mkvmerge to write the destination file strictly sequentially without ever seeking back."),
+        QY("This allows writing to a named pipe while the file is still being created."),
+        QY("The segment size and duration are unknown and no cues are written in this mode.") });
+  add(Q("--fast-split"),                    false, global,
+      { QY("Tells mkvmerge to split a single Matroska source file by copying whole clusters and writing all destination files in parallel."),
+        QY("Only works when splitting by timecodes or by parts and if the source file contains cues."),
+        QY("Each part starts at the first cue point at or after the requested split point.") });
+  add(Q("--preallocate-output"),            false, global, { QY("Tells mkvmerge to reserve the estimated disk space for each destination file before writing it."), QY("This allows the file system to lay out the files contiguously.") });
+  add(Q("--avoid-page-cache"),              false, global,
+      { QY("Tells mkvmerge to keep the source and destination files out of the operating system's page cache."),
+        QY("This avoids evicting other programs' data from the cache when multiplexing large files.") });
+  add(Q("--direct-output"),                 false, global,
+      { QY("Tells mkvmerge to write the destination files with direct I/O bypassing the operating system's page cache."),
+        QY("Falls back to normal writes if the file system doesn't support it.") });
+  add(Q("--read-ahead-size"),               true,  global,
+      { QY("Sets the amount of data each source file is read ahead of the demultiplexer by a separate thread."),
+        QY("The default is 8 MB. 0 disables reading ahead.") });
+  add(Q("--parallel-parsing"),              false, global,
+      { QY("Tells mkvmerge to parse AVC/h.264, HEVC/h.265, MPEG-1/2, VC-1, DTS and TrueHD tracks in a separate thread per track."),
+        QY("This speeds up multiplexing files with several such tracks on multi-core processors.") });
+  add(Q("--max-memory"),                    true,  global,
+      { QY("Limits the amount of data mkvmerge keeps queued in memory."),
+        QY("While the limit is exceeded source files are only read for tracks that have run out of data."),
+        QY("The peak amounts are reported at the end.") });
   add(Q("--timecode-scale"),                true,  global,
       { QY("Forces the timecode scale factor to the given value."),
         QY("You have to enter a value between 1000 and 10000000 or the magic value -1."),
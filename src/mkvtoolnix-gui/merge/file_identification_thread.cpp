@@ -7,6 +7,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QTimer>
+#include <QtConcurrent>
 
 #include "common/qt.h"
 #include "mkvtoolnix-gui/merge/file_identification_thread.h"
@@ -24,6 +25,7 @@ class FileIdentificationWorkerPrivate {
     bool m_append;
     QModelIndex m_sourceFileIdx;
     QList<SourceFilePtr> m_identifiedFiles;
+    bool m_identifiedInParallel{};
   };
 
   QList<IdentificationPack> m_toIdentify;
@@ -96,6 +98,7 @@ FileIdentificationWorker::identifyFiles() {
 
   while (true) {
     QString fileName;
+    QStringList fileNamesToIdentifyInParallel;
 
     {
       QMutexLocker lock{&d->m_mutex};
@@ -118,7 +121,17 @@ FileIdentificationWorker::identifyFiles() {
         continue;
       }
 
-      fileName = pack.m_fileNames.takeFirst();
+      if (!pack.m_identifiedInParallel) {
+        pack.m_identifiedInParallel   = true;
+        fileNamesToIdentifyInParallel = pack.m_fileNames;
+
+      } else
+        fileName = pack.m_fileNames.takeFirst();
+    }
+
+    if (!fileNamesToIdentifyInParallel.isEmpty()) {
+      identifyInParallel(fileNamesToIdentifyInParallel);
+      continue;
     }
 
     auto result = identifyThisFile(fileName);
@@ -130,23 +143,39 @@ FileIdentificationWorker::identifyFiles() {
   }
 }
 
-bool
-FileIdentificationWorker::handleFileThatShouldBeSelectedElsewhere(QString const &fileName) {
+FileIdentificationWorker::SpecialFileType
+FileIdentificationWorker::determineSpecialFileType(QString const &fileName) {
   Q_D(FileIdentificationWorker);
 
   QFile file{fileName};
   if (!file.open(QIODevice::ReadOnly))
-    return false;
+    return SpecialFileType::None;
 
   auto content = std::string{ file.read(1024).data() };
 
   if (boost::regex_search(content, d->m_simpleChaptersRE) || boost::regex_search(content, d->m_xmlChaptersRE))
+    return SpecialFileType::Chapters;
+
+  if (boost::regex_search(content, d->m_xmlSegmentInfoRE))
+    return SpecialFileType::SegmentInfo;
+
+  if (boost::regex_search(content, d->m_xmlTagsRE))
+    return SpecialFileType::Tags;
+
+  return SpecialFileType::None;
+}
+
+bool
+FileIdentificationWorker::handleFileThatShouldBeSelectedElsewhere(QString const &fileName) {
+  auto type = determineSpecialFileType(fileName);
+
+  if (type == SpecialFileType::Chapters)
     emit identifiedAsXmlOrSimpleChapters(fileName);
 
-  else if (boost::regex_search(content, d->m_xmlSegmentInfoRE))
+  else if (type == SpecialFileType::SegmentInfo)
     emit identifiedAsXmlSegmentInfo(fileName);
 
-  else if (boost::regex_search(content, d->m_xmlTagsRE))
+  else if (type == SpecialFileType::Tags)
     emit identifiedAsXmlTags(fileName);
 
   else
@@ -214,6 +243,31 @@ FileIdentificationWorker::scanPlaylists(QFileInfoList const &files) {
 
   emit playlistScanStarted(numFiles);
 
+  auto fileNames = QStringList{};
+  for (auto const &file : files)
+    fileNames << file.filePath();
+
+  auto future = QtConcurrent::map(fileNames, [](QString const &fileName) {
+    Util::FileIdentifier{fileName}.identify();
+  });
+
+  while (!future.isFinished()) {
+    if (d->m_abortPlaylistScan) {
+      qDebug() << "FileIdentificationWorker::scanPlaylists: scan aborted";
+
+      future.cancel();
+      future.waitForFinished();
+
+      emit playlistScanFinished();
+
+      return Result::Continue;
+    }
+
+    emit playlistScanProgressChanged(future.progressValue());
+
+    QThread::msleep(100);
+  }
+
   QList<SourceFilePtr> identifiedPlaylists;
 
   for (auto idx = 0; idx < numFiles; ++idx) {
@@ -289,6 +343,30 @@ FileIdentificationWorker::identifyThisFile(QString const &fileName) {
   return Result::Continue;
 }
 
+void
+FileIdentificationWorker::identifyInParallel(QStringList const &fileNames) {
+  // Runs mkvmerge for all regular files at the same time. The results
+  // end up in the identification cache where the sequential processing
+  // in identifyThisFile() picks them up.
+  auto toIdentify = QStringList{};
+
+  for (auto const &fileName : fileNames)
+    if (   (QFileInfo{fileName}.completeSuffix().toLower() != Q("bdmv"))
+        && (determineSpecialFileType(fileName) == SpecialFileType::None))
+      toIdentify << fileName;
+
+  toIdentify.removeDuplicates();
+
+  if (toIdentify.count() < 2)
+    return;
+
+  qDebug() << "FileIdentificationWorker::identifyInParallel: identifying" << toIdentify.count() << "files";
+
+  QtConcurrent::blockingMap(toIdentify, [](QString const &fileName) {
+    Util::FileIdentifier{fileName}.identify();
+  });
+}
+
 // ----------------------------------------------------------------------
 
 FileIdentificationThread::FileIdentificationThread(QObject *parent)
@@ -25,6 +25,13 @@ class FileIdentificationWorker : public QObject {
     Continue,
   };
 
+  enum class SpecialFileType {
+    None,
+    Chapters,
+    SegmentInfo,
+    Tags,
+  };
+
 protected:
   Q_DECLARE_PRIVATE(FileIdentificationWorker);
 
@@ -67,10 +74,12 @@ signals:
   void identificationFailed(QString const &errorTitle, QString const &errorText);
 
 protected:
+  SpecialFileType determineSpecialFileType(QString const &fileName);
   bool handleFileThatShouldBeSelectedElsewhere(QString const &fileName);
   boost::optional<FileIdentificationWorker::Result> handleBluRayMainFile(QString const &fileName);
   boost::optional<FileIdentificationWorker::Result> handleIdentifiedPlaylist(SourceFilePtr const &sourceFile);
   Result identifyThisFile(QString const &fileName);
+  void identifyInParallel(QStringList const &fileNames);
 
   Result scanPlaylists(QFileInfoList const &fileNames);
 };
@@ -32,6 +32,7 @@ static void
 registerMetaTypes() {
   qRegisterMetaType<Jobs::Job::LineType>("Job::LineType");
   qRegisterMetaType<Jobs::Job::Status>("Job::Status");
+  qRegisterMetaType<Jobs::Job::Statistics>("Job::Statistics");
   qRegisterMetaType<QProcess::ExitStatus>("QProcess::ExitStatus");
   qRegisterMetaType<std::shared_ptr<Merge::SourceFile>>("std::shared_ptr<SourceFile>");
   qRegisterMetaType<QList<std::shared_ptr<Merge::SourceFile>>>("QList<std::shared_ptr<SourceFile>>");
@@ -34,12 +34,10 @@ Cache::currentVersionString() {
 
 QMutex &
 Cache::cacheDirMutex() {
-  static std::unique_ptr<QMutex> s_mutex;
+  // Files are identified from several threads at the same time.
+  static QMutex s_mutex{QMutex::Recursive};
 
-  if (!s_mutex)
-    s_mutex.reset(new QMutex{QMutex::Recursive});
-
-  return *s_mutex;
+  return s_mutex;
 }
 
 ConfigFilePtr
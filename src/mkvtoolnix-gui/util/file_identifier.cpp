@@ -4,6 +4,8 @@
 #include <QDir>
 #include <QFile>
 #include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QRegularExpression>
 #include <QStringList>
 
@@ -22,6 +24,30 @@
 
 namespace mtx { namespace gui { namespace Util {
 
+namespace {
+
+// Keeps mkvmerge's output for files identified during this session so
+// that adding them again doesn't require reading the cache files.
+struct MemoryCacheEntry {
+  CacheProperties m_properties;
+  int m_exitCode{};
+  QStringList m_output;
+};
+
+QMutex &
+memoryCacheMutex() {
+  static QMutex s_mutex;
+  return s_mutex;
+}
+
+QHash<QString, MemoryCacheEntry> &
+memoryCache() {
+  static QHash<QString, MemoryCacheEntry> s_cache;
+  return s_cache;
+}
+
+}
+
 class FileIdentifierPrivate {
   friend class FileIdentifier;
 
@@ -56,7 +82,13 @@ FileIdentifier::identify() {
   if (d->m_fileName.isEmpty())
     return false;
 
+  if (retrieveResultFromMemoryCache()) {
+    setDefaults();
+    return d->m_succeeded;
+  }
+
   if (retrieveResultFromCache()) {
+    storeResultInMemoryCache();
     setDefaults();
     return d->m_succeeded;
   }
@@ -82,6 +114,7 @@ FileIdentifier::identify() {
   d->m_succeeded = parseOutput();
 
   storeResultInCache();
+  storeResultInMemoryCache();
 
   setDefaults();
 
@@ -443,8 +476,56 @@ FileIdentifier::retrieveResultFromCache() {
   return false;
 }
 
+void
+FileIdentifier::storeResultInMemoryCache()
+  const {
+  Q_D(const FileIdentifier);
+
+  if (d->m_jsonParsingFailed)
+    return;
+
+  QMutexLocker lock{&memoryCacheMutex()};
+
+  memoryCache().insert(cacheKey(), { cacheProperties(), d->m_exitCode, d->m_output });
+}
+
+bool
+FileIdentifier::retrieveResultFromMemoryCache() {
+  Q_D(FileIdentifier);
+
+  auto key = cacheKey();
+
+  {
+    QMutexLocker lock{&memoryCacheMutex()};
+
+    auto itr = memoryCache().find(key);
+    if (itr == memoryCache().end())
+      return false;
+
+    if (itr->m_properties != cacheProperties()) {
+      qDebug() << "FileIdentifier::retrieveResultFromMemoryCache: file has changed, removing entry";
+      memoryCache().erase(itr);
+      return false;
+    }
+
+    d->m_exitCode = itr->m_exitCode;
+    d->m_output   = itr->m_output;
+  }
+
+  // Parsing the output creates new source file & track objects, which
+  // the caller may then modify freely.
+  d->m_succeeded = parseOutput();
+
+  return true;
+}
+
 void
 FileIdentifier::cleanAllCacheFiles() {
+  {
+    QMutexLocker lock{&memoryCacheMutex()};
+    memoryCache().clear();
+  }
+
   Cache::cleanAllCacheFilesForCategory(cacheCategory());
 }
 
@@ -59,6 +59,8 @@ protected:
   virtual QHash<QString, QVariant> cacheProperties() const;
   virtual void storeResultInCache() const;
   virtual bool retrieveResultFromCache();
+  virtual void storeResultInMemoryCache() const;
+  virtual bool retrieveResultFromMemoryCache();
 
 protected:
   static QString cacheCategory();
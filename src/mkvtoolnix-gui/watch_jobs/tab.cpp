@@ -35,6 +35,7 @@ class TabPrivate {
   uint64_t m_id, m_currentJobProgress, m_queueProgress;
   QHash<Jobs::Job::LineType, bool> m_currentJobLineTypeSeen;
   Jobs::Job::Status m_currentJobStatus;
+  Jobs::Job::Statistics m_currentJobStatistics;
   QDateTime m_currentJobStartTime;
   QString m_currentJobDescription;
   QMenu *m_moreActions;
@@ -150,9 +151,10 @@ Tab::connectToJob(Jobs::Job const &job) {
   d->m_id                    = job.id();
   auto connType              = static_cast<Qt::ConnectionType>(Qt::AutoConnection | Qt::UniqueConnection);
 
-  connect(&job, &Jobs::Job::statusChanged,   this, &Tab::onStatusChanged,      connType);
-  connect(&job, &Jobs::Job::progressChanged, this, &Tab::onJobProgressChanged, connType);
-  connect(&job, &Jobs::Job::lineRead,        this, &Tab::onLineRead,           connType);
+  connect(&job, &Jobs::Job::statusChanged,     this, &Tab::onStatusChanged,        connType);
+  connect(&job, &Jobs::Job::progressChanged,   this, &Tab::onJobProgressChanged,   connType);
+  connect(&job, &Jobs::Job::statisticsChanged, this, &Tab::onJobStatisticsChanged, connType);
+  connect(&job, &Jobs::Job::lineRead,          this, &Tab::onLineRead,             connType);
 }
 
 void
@@ -164,9 +166,10 @@ Tab::disconnectFromJob(Jobs::Job const &job) {
     d->m_id                    = std::numeric_limits<uint64_t>::max();
   }
 
-  disconnect(&job, &Jobs::Job::statusChanged,   this, &Tab::onStatusChanged);
-  disconnect(&job, &Jobs::Job::progressChanged, this, &Tab::onJobProgressChanged);
-  disconnect(&job, &Jobs::Job::lineRead,        this, &Tab::onLineRead);
+  disconnect(&job, &Jobs::Job::statusChanged,     this, &Tab::onStatusChanged);
+  disconnect(&job, &Jobs::Job::progressChanged,   this, &Tab::onJobProgressChanged);
+  disconnect(&job, &Jobs::Job::statisticsChanged, this, &Tab::onJobStatisticsChanged);
+  disconnect(&job, &Jobs::Job::lineRead,          this, &Tab::onLineRead);
 }
 
 uint64_t
@@ -238,6 +241,7 @@ Tab::onStatusChanged(uint64_t id,
   });
 
   updateRemainingTime();
+  updateStatistics();
 }
 
 void
@@ -265,6 +269,11 @@ Tab::updateRemainingTime() {
   if ((Jobs::Job::Running != d->m_currentJobStatus) || !d->m_currentJobProgress)
     d->ui->remainingTimeCurrentJob->setText(Q("–"));
 
+  // Estimates reported by the job itself are based on the amount of
+  // data processed instead of on the percentage.
+  else if (d->m_currentJobStatistics.m_remainingTime)
+    d->ui->remainingTimeCurrentJob->setText(Q(create_minutes_seconds_time_string(*d->m_currentJobStatistics.m_remainingTime / 1000)));
+
   else
     updateOneRemainingTimeLabel(d->ui->remainingTimeCurrentJob, d->m_currentJobStartTime, d->m_currentJobProgress);
 
@@ -276,6 +285,23 @@ Tab::updateRemainingTime() {
     updateOneRemainingTimeLabel(d->ui->remainingTimeQueue, model->queueStartTime(), d->m_queueProgress);
 }
 
+void
+Tab::updateStatistics() {
+  Q_D(Tab);
+
+  auto const &statistics = d->m_currentJobStatistics;
+
+  if ((Jobs::Job::Running != d->m_currentJobStatus) || !statistics.m_readRate || !statistics.m_writeRate)
+    d->ui->throughput->setText(Q("–"));
+  else
+    d->ui->throughput->setText(QY("%1/s read, %2/s written").arg(Q(format_file_size(*statistics.m_readRate))).arg(Q(format_file_size(*statistics.m_writeRate))));
+
+  if ((Jobs::Job::Running != d->m_currentJobStatus) || !statistics.m_timestamp)
+    d->ui->position->setText(Q("–"));
+  else
+    d->ui->position->setText(Q(format_timestamp(*statistics.m_timestamp, 0)));
+}
+
 void
 Tab::onQueueProgressChanged(int,
                             int totalProgress) {
@@ -298,6 +324,19 @@ Tab::onJobProgressChanged(uint64_t,
   updateRemainingTime();
 }
 
+void
+Tab::onJobStatisticsChanged(uint64_t,
+                            mtx::gui::Jobs::Job::Statistics const &statistics) {
+  Q_D(Tab);
+
+  if (QObject::sender() != d->m_currentlyConnectedJob)
+    return;
+
+  d->m_currentJobStatistics = statistics;
+  updateStatistics();
+  updateRemainingTime();
+}
+
 void
 Tab::onLineRead(QString const &line,
                 Jobs::Job::LineType type) {
@@ -355,10 +394,11 @@ Tab::setInitialDisplay(Jobs::Job const &job) {
 
   d->m_currentJobLineTypeSeen.clear();
 
-  d->m_currentJobStatus    = job.status();
-  d->m_currentJobProgress  = job.progress();
-  d->m_currentJobStartTime = job.dateStarted();
-  d->m_queueProgress       = MainWindow::watchCurrentJobTab()->queueProgress();
+  d->m_currentJobStatus     = job.status();
+  d->m_currentJobProgress   = job.progress();
+  d->m_currentJobStatistics = job.statistics();
+  d->m_currentJobStartTime  = job.dateStarted();
+  d->m_queueProgress        = MainWindow::watchCurrentJobTab()->queueProgress();
 
   d->ui->description->setText(d->m_currentJobDescription);
   d->ui->status->setText(Jobs::Job::displayableStatus(job.status()));
@@ -373,6 +413,7 @@ Tab::setInitialDisplay(Jobs::Job const &job) {
   d->ui->acknowledgeWarningsAndErrorsButton->setEnabled(job.numUnacknowledgedWarnings() || job.numUnacknowledgedErrors());
 
   updateRemainingTime();
+  updateStatistics();
 }
 
 void
@@ -456,6 +497,8 @@ Tab::clearOutput() {
   d->ui->finishedAt->setText(QY("Not finished yet"));
   d->ui->remainingTimeCurrentJob->setText(Q("–"));
   d->ui->remainingTimeQueue->setText(Q("–"));
+  d->ui->throughput->setText(Q("–"));
+  d->ui->position->setText(Q("–"));
 
   emit watchCurrentJobTabCleared();
 }
@@ -51,6 +51,7 @@ signals:
 public slots:
   void onStatusChanged(uint64_t id, mtx::gui::Jobs::Job::Status oldStatus, mtx::gui::Jobs::Job::Status newStatus);
   void onJobProgressChanged(uint64_t id, unsigned int progress);
+  void onJobStatisticsChanged(uint64_t id, mtx::gui::Jobs::Job::Statistics const &statistics);
   void onQueueProgressChanged(int progress, int totalProgress);
   void onLineRead(QString const &line, mtx::gui::Jobs::Job::LineType type);
   void onAbort();
@@ -63,6 +64,7 @@ public slots:
   void disableButtonIfAllWarningsAndErrorsButtonAcknowledged(int numWarnings, int numErrors);
 
   void updateRemainingTime();
+  void updateStatistics();
 
   void enableMoreActionsActions();
 
@@ -18,6 +18,7 @@
 
 #include "common/mpeg4_p10.h"
 #include "merge/generic_packetizer.h"
+#include "merge/packetizer_worker.h"
 
 using namespace mpeg4::p10;
 
@@ -27,6 +28,7 @@ protected:
   int64_t m_default_duration_for_interlaced_content;
   bool m_first_frame, m_set_display_dimensions;
   debugging_option_c m_debug_timecodes, m_debug_aspect_ratio;
+  std::unique_ptr<packetizer_worker_c> m_worker;
 
 public:
   mpeg4_p10_es_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti);
@@ -50,7 +52,10 @@ protected:
   virtual void handle_delayed_headers();
   virtual void handle_aspect_ratio();
   virtual void handle_actual_default_duration();
+  virtual void handle_parser_exception();
+  virtual void add_frame(avc_frame_t const &frame);
   virtual void flush_impl();
+  virtual bool complete_parsed_frames();
 };
 
 #endif // MTX_P_AVC_H
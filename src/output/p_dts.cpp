@@ -32,6 +32,7 @@ dts_packetizer_c::dts_packetizer_c(generic_reader_c *p_reader,
   , m_skipping_is_normal(false)
   , m_reduce_to_core{get_option_for_track(m_ti.m_reduce_to_core, m_ti.m_id)}
   , m_timestamp_calculator{static_cast<int64_t>(m_first_header.core_sampling_frequency)}
+  , m_worker{packetizer_worker_c::create_if_enabled()}
 {
   set_track_type(track_audio);
 }
@@ -41,7 +42,10 @@ dts_packetizer_c::~dts_packetizer_c() {
 
 memory_cptr
 dts_packetizer_c::get_dts_packet(mtx::dts::header_t &dtsheader,
+                                 int &num_skipped_bytes,
                                  bool flushing) {
+  num_skipped_bytes = 0;
+
   if (0 == m_packet_buffer.get_size())
     return nullptr;
 
@@ -66,25 +70,9 @@ dts_packetizer_c::get_dts_packet(mtx::dts::header_t &dtsheader,
   if ((0 > pos) || (static_cast<int>(pos + dtsheader.frame_byte_size) > buf_size))
     return nullptr;
 
-  if ((1 < verbose) && (dtsheader != m_previous_header)) {
-    mxinfo(Y("DTS header information changed! - New format:\n"));
-    dtsheader.print();
-    m_previous_header = dtsheader;
-  }
-
-  if (verbose && (0 < pos) && !m_skipping_is_normal) {
-    int i;
-    bool all_zeroes = true;
-
-    for (i = 0; i < pos; ++i)
-      if (buf[i]) {
-        all_zeroes = false;
-        break;
-      }
-
-    if (!all_zeroes)
-      mxwarn_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Skipping %1% bytes (no valid DTS header found). This might cause audio/video desynchronisation.\n")) % pos);
-  }
+  // Skipping zero bytes is not worth a warning.
+  if ((0 < pos) && std::any_of(buf, buf + pos, [](unsigned char byte) { return byte != 0; }))
+    num_skipped_bytes = pos;
 
   auto bytes_to_remove = pos + dtsheader.frame_byte_size;
 
@@ -118,6 +106,24 @@ dts_packetizer_c::set_headers() {
 
 int
 dts_packetizer_c::process(packet_cptr packet) {
+  if (m_worker) {
+    m_worker->submit(packet, [this, packet]() -> packetizer_worker_c::completion_t {
+      m_packet_buffer.add(packet->data->get_buffer(), packet->data->get_size());
+
+      auto packets = get_available_packets(false);
+
+      return [this, packet, packets]() {
+        m_timestamp_calculator.add_timestamp(packet);
+        queue_packets(packets);
+        process_available_packets();
+      };
+    });
+
+    m_worker->complete_finished_jobs();
+
+    return FILE_STATUS_MOREDATA;
+  }
+
   m_timestamp_calculator.add_timestamp(packet);
 
   m_packet_buffer.add(packet->data->get_buffer(), packet->data->get_size());
@@ -128,13 +134,39 @@ dts_packetizer_c::process(packet_cptr packet) {
   return FILE_STATUS_MOREDATA;
 }
 
-void
-dts_packetizer_c::queue_available_packets(bool flushing) {
+std::vector<dts_packetizer_c::parsed_packet_t>
+dts_packetizer_c::get_available_packets(bool flushing) {
+  std::vector<parsed_packet_t> packets;
   mtx::dts::header_t dtsheader;
   memory_cptr dts_packet;
+  int num_skipped_bytes;
 
-  while ((dts_packet = get_dts_packet(dtsheader, flushing))) {
-    m_queued_packets.emplace_back(std::make_pair(dtsheader, dts_packet));
+  while ((dts_packet = get_dts_packet(dtsheader, num_skipped_bytes, flushing)))
+    packets.emplace_back(parsed_packet_t{dtsheader, dts_packet, num_skipped_bytes});
+
+  return packets;
+}
+
+void
+dts_packetizer_c::queue_available_packets(bool flushing) {
+  queue_packets(get_available_packets(flushing));
+}
+
+void
+dts_packetizer_c::queue_packets(std::vector<parsed_packet_t> const &packets) {
+  for (auto const &packet : packets) {
+    auto &dtsheader = packet.m_header;
+
+    if ((1 < verbose) && (dtsheader != m_previous_header)) {
+      mxinfo(Y("DTS header information changed! - New format:\n"));
+      dtsheader.print();
+      m_previous_header = dtsheader;
+    }
+
+    if (verbose && packet.m_num_skipped_bytes && !m_skipping_is_normal)
+      mxwarn_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Skipping %1% bytes (no valid DTS header found). This might cause audio/video desynchronisation.\n")) % packet.m_num_skipped_bytes);
+
+    m_queued_packets.emplace_back(packet);
 
     if (!m_first_header.core_sampling_frequency && dtsheader.core_sampling_frequency) {
       m_first_header.core_sampling_frequency = dtsheader.core_sampling_frequency;
@@ -152,18 +184,28 @@ dts_packetizer_c::process_available_packets() {
   if (!m_first_header.core_sampling_frequency)
     return;
 
-  for (auto const &header_and_packet : m_queued_packets) {
-    auto samples_in_packet = header_and_packet.first.get_packet_length_in_core_samples();
+  for (auto const &packet : m_queued_packets) {
+    auto samples_in_packet = packet.m_header.get_packet_length_in_core_samples();
     auto new_timecode      = m_timestamp_calculator.get_next_timestamp(samples_in_packet);
 
-    add_packet(std::make_shared<packet_t>(header_and_packet.second, new_timecode.to_ns(), header_and_packet.first.get_packet_length_in_nanoseconds().to_ns()));
+    add_packet(std::make_shared<packet_t>(packet.m_data, new_timecode.to_ns(), packet.m_header.get_packet_length_in_nanoseconds().to_ns()));
   }
 
   m_queued_packets.clear();
 }
 
+bool
+dts_packetizer_c::complete_parsed_frames() {
+  return m_worker && m_worker->complete_finished_jobs();
+}
+
 void
 dts_packetizer_c::flush_impl() {
+  if (m_worker) {
+    m_worker->complete_all_jobs();
+    m_worker.reset();
+  }
+
   queue_available_packets(true);
   process_available_packets();
 }
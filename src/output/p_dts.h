@@ -20,18 +20,27 @@
 #include "common/byte_buffer.h"
 #include "common/dts.h"
 #include "merge/generic_packetizer.h"
+#include "merge/packetizer_worker.h"
 #include "merge/timestamp_calculator.h"
 
 class dts_packetizer_c: public generic_packetizer_c {
 private:
-  using header_and_packet_t = std::pair<mtx::dts::header_t, memory_cptr>;
+  // Parsing may run in a worker thread. Everything that has to be
+  // reported is therefore stored with the packet and output once the
+  // packet is queued.
+  struct parsed_packet_t {
+    mtx::dts::header_t m_header;
+    memory_cptr m_data;
+    int m_num_skipped_bytes{};
+  };
 
   byte_buffer_c m_packet_buffer;
 
   mtx::dts::header_t m_first_header, m_previous_header;
   bool m_skipping_is_normal, m_reduce_to_core;
   timestamp_calculator_c m_timestamp_calculator;
-  std::deque<header_and_packet_t> m_queued_packets;
+  std::deque<parsed_packet_t> m_queued_packets;
+  std::unique_ptr<packetizer_worker_c> m_worker;
 
 public:
   dts_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, mtx::dts::header_t const &dts_header);
@@ -50,9 +59,12 @@ public:
 
 protected:
   virtual void flush_impl();
+  virtual bool complete_parsed_frames();
 
 private:
-  virtual memory_cptr get_dts_packet(mtx::dts::header_t &dts_header, bool flushing);
+  virtual memory_cptr get_dts_packet(mtx::dts::header_t &dts_header, int &num_skipped_bytes, bool flushing);
+  virtual std::vector<parsed_packet_t> get_available_packets(bool flushing);
+  virtual void queue_packets(std::vector<parsed_packet_t> const &packets);
   virtual void queue_available_packets(bool flushing);
   virtual void process_available_packets();
 };
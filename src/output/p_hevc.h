@@ -20,7 +20,6 @@
 class hevc_video_packetizer_c: public generic_video_packetizer_c {
 protected:
   int m_nalu_size_len_src, m_nalu_size_len_dst;
-  int64_t m_max_nalu_size;
 
 public:
   hevc_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, double fps, int width, int height);
@@ -36,7 +35,7 @@ public:
 protected:
   virtual void extract_aspect_ratio();
   virtual void setup_nalu_size_len_change();
-  virtual void change_nalu_size_len(packet_cptr packet);
+  virtual void remove_filler_nalus_and_change_nalu_size_len(packet_cptr packet);
 };
 
 #endif  // MTX_P_HEVC_H
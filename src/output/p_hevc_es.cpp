@@ -33,6 +33,7 @@ hevc_es_video_packetizer_c::hevc_es_video_packetizer_c(generic_reader_c *p_reade
   , m_set_display_dimensions(false)
   , m_debug_timecodes(   debugging_c::requested("hevc_es|hevc_es_timecodes"))
   , m_debug_aspect_ratio(debugging_c::requested("hevc_es|hevc_es_aspect_ratio"))
+  , m_worker{packetizer_worker_c::create_if_enabled()}
 {
   m_relaxed_timecode_checking = true;
 
@@ -87,10 +88,44 @@ hevc_es_video_packetizer_c::add_extra_data(memory_cptr data) {
 int
 hevc_es_video_packetizer_c::process(packet_cptr packet) {
   try {
-    if (packet->has_timecode())
-      m_parser.add_timecode(packet->timecode);
-    m_parser.add_bytes(packet->data->get_buffer(), packet->data->get_size());
-    flush_frames();
+    // Everything up to the first frame is parsed synchronously as
+    // the headers are taken from the parser's state.
+    if (m_worker && !m_first_frame) {
+      m_worker->submit(packet, [this, packet]() -> packetizer_worker_c::completion_t {
+        if (packet->has_timecode())
+          m_parser.add_timecode(packet->timecode);
+        m_parser.add_bytes(packet->data->get_buffer(), packet->data->get_size());
+
+        auto frames = std::vector<mtx::hevc::frame_t>{};
+        while (m_parser.frame_available())
+          frames.push_back(m_parser.get_frame());
+
+        return [this, frames]() {
+          for (auto const &frame : frames)
+            add_frame(frame);
+        };
+      });
+
+      m_worker->complete_finished_jobs();
+
+    } else {
+      if (packet->has_timecode())
+        m_parser.add_timecode(packet->timecode);
+      m_parser.add_bytes(packet->data->get_buffer(), packet->data->get_size());
+      flush_frames();
+    }
+
+  } catch (mtx::exception &) {
+    handle_parser_exception();
+  }
+
+  return FILE_STATUS_MOREDATA;
+}
+
+void
+hevc_es_video_packetizer_c::handle_parser_exception() {
+  try {
+    throw;
 
   } catch (mtx::mpeg::nalu_size_length_x &error) {
     mxerror_tid(m_ti.m_fname, m_ti.m_id,
@@ -105,8 +140,21 @@ hevc_es_video_packetizer_c::process(packet_cptr packet) {
                                 "Either your file is damaged (which mkvmerge cannot cope with yet) or this is a bug in mkvmerge itself. "
                                 "The error message was:\n%1%\n")) % error.error());
   }
+}
 
-  return FILE_STATUS_MOREDATA;
+bool
+hevc_es_video_packetizer_c::complete_parsed_frames() {
+  if (!m_worker)
+    return false;
+
+  try {
+    return m_worker->complete_finished_jobs();
+
+  } catch (mtx::exception &) {
+    handle_parser_exception();
+  }
+
+  return false;
 }
 
 void
@@ -160,6 +208,17 @@ hevc_es_video_packetizer_c::handle_actual_default_duration() {
 
 void
 hevc_es_video_packetizer_c::flush_impl() {
+  if (m_worker) {
+    try {
+      m_worker->complete_all_jobs();
+
+    } catch (mtx::exception &) {
+      handle_parser_exception();
+    }
+
+    m_worker.reset();
+  }
+
   m_parser.flush();
   flush_frames();
 }
@@ -172,13 +231,17 @@ hevc_es_video_packetizer_c::flush_frames() {
       m_first_frame = false;
     }
 
-    auto frame = m_parser.get_frame();
-    add_packet(new packet_t(frame.m_data, frame.m_start,
-                            frame.m_end > frame.m_start ? frame.m_end - frame.m_start : m_htrack_default_duration,
-                            frame.m_keyframe            ? -1                          : frame.m_start + frame.m_ref1));
+    add_frame(m_parser.get_frame());
   }
 }
 
+void
+hevc_es_video_packetizer_c::add_frame(mtx::hevc::frame_t const &frame) {
+  add_packet(new packet_t(frame.m_data, frame.m_start,
+                          frame.m_end > frame.m_start ? frame.m_end - frame.m_start : m_htrack_default_duration,
+                          frame.m_keyframe            ? -1                          : frame.m_start + frame.m_ref1));
+}
+
 unsigned int
 hevc_es_video_packetizer_c::get_nalu_size_length()
   const {
@@ -17,12 +17,14 @@
 
 #include "common/hevc.h"
 #include "merge/generic_packetizer.h"
+#include "merge/packetizer_worker.h"
 
 class hevc_es_video_packetizer_c: public generic_packetizer_c {
 protected:
   mtx::hevc::es_parser_c m_parser;
   int64_t m_default_duration_for_interlaced_content;
   bool m_first_frame, m_set_display_dimensions, m_debug_timecodes, m_debug_aspect_ratio;
+  std::unique_ptr<packetizer_worker_c> m_worker;
 
 public:
   hevc_es_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti);
@@ -46,7 +48,10 @@ protected:
   virtual void handle_delayed_headers();
   virtual void handle_aspect_ratio();
   virtual void handle_actual_default_duration();
+  virtual void handle_parser_exception();
+  virtual void add_frame(mtx::hevc::frame_t const &frame);
   virtual void flush_impl();
+  virtual bool complete_parsed_frames();
 };
 
 #endif // MTX_P_HEVC_ES_H
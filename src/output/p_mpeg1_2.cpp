@@ -38,6 +38,7 @@ mpeg1_2_video_packetizer_c(generic_reader_c *p_reader,
   , m_aspect_ratio_extracted{true}
   , m_num_removed_stuffing_bytes{}
   , m_debug_stuffing_removal{"mpeg1_2|mpeg1_2_stuffing_removal"}
+  , m_worker{packetizer_worker_c::create_if_enabled()}
 {
 
   set_codec_id((boost::format("V_MPEG%1%") % version).str());
@@ -50,6 +51,11 @@ mpeg1_2_video_packetizer_c(generic_reader_c *p_reader,
 
   m_timestamp_factory_application_mode = TFA_SHORT_QUEUEING;
 
+  // The parser must not call mxerror() from the worker thread. Its
+  // errors are reported on the main thread instead.
+  if (m_worker)
+    m_parser.SetThrowOnError(true);
+
   // m_parser.SeparateSequenceHeaders();
 }
 
@@ -179,7 +185,22 @@ mpeg1_2_video_packetizer_c::process(packet_cptr packet) {
   if (!m_aspect_ratio_extracted)
     extract_aspect_ratio(packet->data->get_buffer(), packet->data->get_size());
 
-  return m_framed ? process_framed(packet) : process_unframed(packet);
+  if (m_framed)
+    return process_framed(packet);
+
+  try {
+    return process_unframed(packet);
+
+  } catch (char const *error) {
+    handle_parser_error(error);
+  }
+
+  return FILE_STATUS_DONE;
+}
+
+void
+mpeg1_2_video_packetizer_c::handle_parser_error(char const *error) {
+  mxerror_tid(m_ti.m_fname, m_ti.m_id, error);
 }
 
 int
@@ -197,9 +218,55 @@ mpeg1_2_video_packetizer_c::process_framed(packet_cptr packet) {
 
 int
 mpeg1_2_video_packetizer_c::process_unframed(packet_cptr packet) {
+  // The codec private data is taken from the parser's state, so
+  // parsing is done synchronously until it has been set.
+  if (m_worker && m_hcodec_private) {
+    // The parser's end-of-stream or error state is only known once the
+    // completions of the jobs submitted earlier have been run.
+    if (m_parser_finished)
+      return FILE_STATUS_DONE;
+
+    m_worker->submit(packet, [this, packet]() -> packetizer_worker_c::completion_t {
+      auto new_packets = std::vector<packet_cptr>{};
+
+      auto parsed = parse_unframed(packet, [&new_packets](packet_cptr const &new_packet) {
+        new_packets.push_back(new_packet);
+      });
+
+      return [this, new_packets, parsed]() {
+        for (auto const &new_packet : new_packets) {
+          remove_stuffing_bytes_and_handle_sequence_headers(new_packet);
+          generic_video_packetizer_c::process(new_packet);
+        }
+
+        if (!parsed)
+          m_parser_finished = true;
+      };
+    });
+
+    m_worker->complete_finished_jobs();
+
+    return m_parser_finished ? FILE_STATUS_DONE : FILE_STATUS_MOREDATA;
+  }
+
+  auto parsed = parse_unframed(packet, [this](packet_cptr const &new_packet) {
+    if (!m_hcodec_private)
+      create_private_data();
+
+    remove_stuffing_bytes_and_handle_sequence_headers(new_packet);
+
+    generic_video_packetizer_c::process(new_packet);
+  });
+
+  return parsed ? FILE_STATUS_MOREDATA : FILE_STATUS_DONE;
+}
+
+bool
+mpeg1_2_video_packetizer_c::parse_unframed(packet_cptr const &packet,
+                                           std::function<void(packet_cptr const &)> const &handle_frame) {
   int state = m_parser.GetState();
   if ((MPV_PARSER_STATE_EOS == state) || (MPV_PARSER_STATE_ERROR == state))
-    return FILE_STATUS_DONE;
+    return false;
 
   auto old_memory = packet->data;
   auto data_ptr   = old_memory->get_buffer();
@@ -222,26 +289,44 @@ mpeg1_2_video_packetizer_c::process_unframed(packet_cptr packet) {
       if (!frame)
         break;
 
-      if (!m_hcodec_private)
-        create_private_data();
-
       packet_cptr new_packet  = packet_cptr(new packet_t(new memory_c(frame->data, frame->size, true), frame->timecode, frame->duration, frame->refs[0], frame->refs[1]));
       new_packet->time_factor = MPEG2_PICTURE_TYPE_FRAME == frame->pictureStructure ? 1 : 2;
 
-      remove_stuffing_bytes_and_handle_sequence_headers(new_packet);
-
-      generic_video_packetizer_c::process(new_packet);
+      handle_frame(new_packet);
 
       frame->data = nullptr;
       state       = m_parser.GetState();
     }
   } while (0 < new_bytes);
 
-  return FILE_STATUS_MOREDATA;
+  return true;
+}
+
+bool
+mpeg1_2_video_packetizer_c::complete_parsed_frames() {
+  try {
+    return m_worker && m_worker->complete_finished_jobs();
+
+  } catch (char const *error) {
+    handle_parser_error(error);
+  }
+
+  return false;
 }
 
 void
 mpeg1_2_video_packetizer_c::flush_impl() {
+  if (m_worker) {
+    try {
+      m_worker->complete_all_jobs();
+
+    } catch (char const *error) {
+      handle_parser_error(error);
+    }
+
+    m_worker.reset();
+  }
+
   m_parser.SetEOS();
   generic_packetizer_c::process(new packet_t(new memory_c((unsigned char *)"", 0, false)));
 }
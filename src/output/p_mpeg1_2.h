@@ -17,6 +17,7 @@
 #include "common/common_pch.h"
 
 #include "common/mpeg1_2.h"
+#include "merge/packetizer_worker.h"
 #include "output/p_generic_video.h"
 #include "mpegparser/M2VParser.h"
 
@@ -27,6 +28,8 @@ protected:
   bool m_framed, m_aspect_ratio_extracted;
   int64_t m_num_removed_stuffing_bytes;
   debugging_option_c m_debug_stuffing_removal;
+  std::unique_ptr<packetizer_worker_c> m_worker;
+  bool m_parser_finished{};
 
 public:
   mpeg1_2_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, int version, double fps, int width, int height, int dwidth, int dheight, bool framed);
@@ -44,8 +47,11 @@ protected:
   virtual void create_private_data();
   virtual int process_framed(packet_cptr packet);
   virtual int process_unframed(packet_cptr packet);
+  virtual bool parse_unframed(packet_cptr const &packet, std::function<void(packet_cptr const &)> const &handle_frame);
   virtual void remove_stuffing_bytes_and_handle_sequence_headers(packet_cptr packet);
   virtual void flush_impl();
+  virtual bool complete_parsed_frames();
+  virtual void handle_parser_error(char const *error);
 };
 
 #endif  // MTX_OUTPUT_P_MPEG1_2_H
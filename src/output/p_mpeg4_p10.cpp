@@ -18,6 +18,7 @@
 #include "common/codec.h"
 #include "common/endian.h"
 #include "common/hacks.h"
+#include "common/mpeg.h"
 #include "common/mpeg4_p10.h"
 #include "common/strings/formatting.h"
 #include "merge/output_control.h"
@@ -32,7 +33,6 @@ mpeg4_p10_video_packetizer_c(generic_reader_c *p_reader,
   : generic_video_packetizer_c{p_reader, p_ti, MKV_V_MPEG4_AVC, fps, width, height}
   , m_nalu_size_len_src{}
   , m_nalu_size_len_dst{}
-  , m_max_nalu_size{}
 {
   m_relaxed_timecode_checking = true;
 
@@ -104,10 +104,7 @@ mpeg4_p10_video_packetizer_c::process(packet_cptr packet) {
 
   m_ref_timecode = packet->timecode;
 
-  if (m_nalu_size_len_dst && (m_nalu_size_len_dst != m_nalu_size_len_src))
-    change_nalu_size_len(packet);
-
-  remove_filler_nalus(*packet->data);
+  remove_filler_nalus_and_change_nalu_size_len(packet);
 
   add_packet(packet);
 
@@ -147,7 +144,6 @@ mpeg4_p10_video_packetizer_c::setup_nalu_size_len_change() {
 
   m_nalu_size_len_dst = m_ti.m_nalu_size_length;
   private_data[4]     = (private_data[4] & 0xfc) | (m_nalu_size_len_dst - 1);
-  m_max_nalu_size     = 1ll << (8 * m_nalu_size_len_dst);
 
   set_codec_private(m_ti.m_private_data);
 
@@ -155,81 +151,15 @@ mpeg4_p10_video_packetizer_c::setup_nalu_size_len_change() {
 }
 
 void
-mpeg4_p10_video_packetizer_c::change_nalu_size_len(packet_cptr packet) {
-  unsigned char *src = packet->data->get_buffer();
-  int size           = packet->data->get_size();
-
-  if (!src || !size)
-    return;
-
-  std::vector<int> nalu_sizes;
-
-  int src_pos = 0;
-
-  // Find all NALU sizes in this packet.
-  while (src_pos < size) {
-    if ((size - src_pos) < m_nalu_size_len_src)
-      break;
-
-    int nalu_size = get_uint_be(&src[src_pos], m_nalu_size_len_src);
-    nalu_size     = std::min<int>(nalu_size, size - src_pos - m_nalu_size_len_src);
-
-    if (nalu_size > m_max_nalu_size)
-      mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("The chosen NALU size length of %1% is too small. Try using '4'.\n")) % m_nalu_size_len_dst);
-
-    src_pos += m_nalu_size_len_src + nalu_size;
-
-    nalu_sizes.push_back(nalu_size);
-  }
-
-  // Allocate memory if the new NALU size length is greater
-  // than the previous one. Otherwise reuse the existing memory.
-  if (m_nalu_size_len_dst > m_nalu_size_len_src) {
-    int new_size = size + nalu_sizes.size() * (m_nalu_size_len_dst - m_nalu_size_len_src);
-    packet->data = memory_cptr(new memory_c((unsigned char *)safemalloc(new_size), new_size, true));
-  }
-
-  // Copy the NALUs and write the new sized length field.
-  unsigned char *dst = packet->data->get_buffer();
-  src_pos            = 0;
-  int dst_pos        = 0;
-
-  size_t i;
-  for (i = 0; nalu_sizes.size() > i; ++i) {
-    int nalu_size = nalu_sizes[i];
-
-    put_uint_be(&dst[dst_pos], nalu_size, m_nalu_size_len_dst);
-
-    memmove(&dst[dst_pos + m_nalu_size_len_dst], &src[src_pos + m_nalu_size_len_src], nalu_size);
-
-    src_pos += m_nalu_size_len_src + nalu_size;
-    dst_pos += m_nalu_size_len_dst + nalu_size;
-  }
-
-  packet->data->set_size(dst_pos);
-}
-
-void
-mpeg4_p10_video_packetizer_c::remove_filler_nalus(memory_c &data)
-  const {
-  auto ptr        = data.get_buffer();
-  auto total_size = data.get_size();
-  auto idx        = 0u;
+mpeg4_p10_video_packetizer_c::remove_filler_nalus_and_change_nalu_size_len(packet_cptr packet) {
+  auto nalu_size_len_dst = m_nalu_size_len_dst ? m_nalu_size_len_dst : m_nalu_size_len_src;
 
-  while ((idx + m_nalu_size_len_dst) < total_size) {
-    auto nalu_size = get_uint_be(&ptr[idx], m_nalu_size_len_dst) + m_nalu_size_len_dst;
+  try {
+    packet->data = mtx::mpeg::remove_nalus_and_change_nalu_size_len(packet->data, m_nalu_size_len_src, nalu_size_len_dst, [](unsigned char nalu_header) {
+      return NALU_TYPE_FILLER_DATA == nalu_header;
+    });
 
-    if ((idx + nalu_size) > total_size)
-      break;
-
-    if (ptr[idx + m_nalu_size_len_dst] == NALU_TYPE_FILLER_DATA) {
-      memmove(&ptr[idx], &ptr[idx + nalu_size], total_size - idx - nalu_size);
-      total_size -= nalu_size;
-      continue;
-    }
-
-    idx += nalu_size;
+  } catch (mtx::mpeg::nalu_size_length_x &) {
+    mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("The chosen NALU size length of %1% is too small. Try using '4'.\n")) % m_nalu_size_len_dst);
   }
-
-  data.resize(total_size);
 }
@@ -95,22 +95,63 @@ pcm_packetizer_c::process(packet_cptr packet) {
   if (packet->has_timecode() && (packet->data->get_size() >= m_min_packet_size))
     return process_packaged(packet);
 
-  m_buffer.add(packet->data->get_buffer(), packet->data->get_size());
+  auto data      = packet->data->get_buffer();
+  auto data_size = packet->data->get_size();
+  auto offset    = std::size_t{};
 
-  while (m_buffer.get_size() >= m_packet_size) {
-    auto packet = std::make_shared<packet_t>(memory_c::clone(m_buffer.get_buffer(), m_packet_size), m_samples_output * m_s2ts, m_samples_per_packet * m_s2ts);
+  // Complete the packet started by previous calls first.
+  if (m_buffer.get_size()) {
+    offset = std::min(m_packet_size - m_buffer.get_size(), data_size);
+    m_buffer.add(data, offset);
 
-    byte_swap_data(*packet->data);
-
-    add_packet(packet);
+    if (m_buffer.get_size() < m_packet_size)
+      return FILE_STATUS_MOREDATA;
 
+    add_unpackaged_packet(m_buffer.get_buffer(), m_packet_size);
     m_buffer.remove(m_packet_size);
+  }
+
+  // If the input has exactly the output's packet size then its memory
+  // can be used as-is.
+  if (!offset && (data_size == m_packet_size) && (!m_byte_swapper || packet->data->is_free())) {
+    byte_swap_data(*packet->data);
+    add_packet(std::make_shared<packet_t>(packet->data, m_samples_output * m_s2ts, m_samples_per_packet * m_s2ts));
     m_samples_output += m_samples_per_packet;
+
+    return FILE_STATUS_MOREDATA;
   }
 
+  // Otherwise create the packets directly from the input and only keep
+  // the remainder.
+  for (; (offset + m_packet_size) <= data_size; offset += m_packet_size)
+    add_unpackaged_packet(&data[offset], m_packet_size);
+
+  if (offset < data_size)
+    m_buffer.add(&data[offset], data_size - offset);
+
   return FILE_STATUS_MOREDATA;
 }
 
+void
+pcm_packetizer_c::add_unpackaged_packet(unsigned char const *data,
+                                        std::size_t size) {
+  auto samples_here = size_to_samples(size);
+  auto packet       = std::make_shared<packet_t>(memory_c::alloc(size), m_samples_output * m_s2ts, samples_here * m_s2ts);
+
+  // Copy & swap in a single pass.
+  if (m_byte_swapper) {
+    size -= size % (m_bits_per_sample / 8);
+    packet->data->set_size(size);
+    m_byte_swapper(data, packet->data->get_buffer(), size);
+
+  } else
+    std::memcpy(packet->data->get_buffer(), data, size);
+
+  add_packet(packet);
+
+  m_samples_output += samples_here;
+}
+
 int
 pcm_packetizer_c::process_packaged(packet_cptr const &packet) {
   auto buffer_size = m_buffer.get_size();
@@ -158,18 +199,11 @@ pcm_packetizer_c::process_packaged(packet_cptr const &packet) {
 
 void
 pcm_packetizer_c::flush_impl() {
-  uint32_t size = m_buffer.get_size();
-  if (0 >= size)
+  auto size = m_buffer.get_size();
+  if (!size)
     return;
 
-  int64_t samples_here = size_to_samples(size);
-  auto packet          = std::make_shared<packet_t>(memory_c::clone(m_buffer.get_buffer(), size), m_samples_output * m_s2ts, samples_here * m_s2ts);
-
-  byte_swap_data(*packet->data);
-
-  add_packet(packet);
-
-  m_samples_output += samples_here;
+  add_unpackaged_packet(m_buffer.get_buffer(), size);
   m_buffer.remove(size);
 }
 
@@ -33,6 +33,7 @@ truehd_packetizer_c::truehd_packetizer_c(generic_reader_c *p_reader,
   , m_current_samples_per_frame{}
   , m_ref_timecode{}
   , m_timestamp_calculator{sampling_rate}
+  , m_worker{packetizer_worker_c::create_if_enabled()}
 {
   m_first_truehd_header.m_codec         = codec;
   m_first_truehd_header.m_sampling_rate = sampling_rate;
@@ -77,6 +78,26 @@ truehd_packetizer_c::process_framed(truehd_frame_cptr const &frame,
 
 int
 truehd_packetizer_c::process(packet_cptr packet) {
+  if (m_worker) {
+    m_worker->submit(packet, [this, packet]() -> packetizer_worker_c::completion_t {
+      m_parser.add_data(packet->data->get_buffer(), packet->data->get_size());
+
+      auto frames = std::vector<truehd_frame_cptr>{};
+      while (m_parser.frame_available())
+        frames.push_back(m_parser.get_next_frame());
+
+      return [this, packet, frames]() {
+        m_timestamp_calculator.add_timestamp(packet);
+        for (auto const &frame : frames)
+          process_framed(frame, -1);
+      };
+    });
+
+    m_worker->complete_finished_jobs();
+
+    return FILE_STATUS_MOREDATA;
+  }
+
   m_timestamp_calculator.add_timestamp(packet);
 
   m_parser.add_data(packet->data->get_buffer(), packet->data->get_size());
@@ -126,8 +147,18 @@ truehd_packetizer_c::adjust_header_values(truehd_frame_cptr const &frame) {
   m_timestamp_calculator.set_samples_per_second(m_first_truehd_header.m_sampling_rate);
 }
 
+bool
+truehd_packetizer_c::complete_parsed_frames() {
+  return m_worker && m_worker->complete_finished_jobs();
+}
+
 void
 truehd_packetizer_c::flush_impl() {
+  if (m_worker) {
+    m_worker->complete_all_jobs();
+    m_worker.reset();
+  }
+
   m_parser.parse(true);
   flush_frames();
 }
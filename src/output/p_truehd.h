@@ -18,6 +18,7 @@
 
 #include "common/truehd.h"
 #include "merge/generic_packetizer.h"
+#include "merge/packetizer_worker.h"
 #include "merge/timestamp_calculator.h"
 
 class truehd_packetizer_c: public generic_packetizer_c {
@@ -28,6 +29,7 @@ protected:
   int64_t m_current_samples_per_frame, m_ref_timecode;
   timestamp_calculator_c m_timestamp_calculator;
   truehd_parser_c m_parser;
+  std::unique_ptr<packetizer_worker_c> m_worker;
 
 public:
   truehd_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, truehd_frame_t::codec_e codec, int sampling_rate, int channels);
@@ -48,6 +50,7 @@ protected:
 
   virtual void flush_impl();
   virtual void flush_frames();
+  virtual bool complete_parsed_frames();
 };
 
 #endif // MTX_P_TRUEHD_H
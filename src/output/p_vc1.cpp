@@ -29,6 +29,7 @@ using namespace libmatroska;
 vc1_video_packetizer_c::vc1_video_packetizer_c(generic_reader_c *n_reader, track_info_c &n_ti)
   : generic_packetizer_c(n_reader, n_ti)
   , m_previous_timecode(-1)
+  , m_worker{packetizer_worker_c::create_if_enabled()}
 {
   m_relaxed_timecode_checking = true;
 
@@ -96,7 +97,7 @@ vc1_video_packetizer_c::set_headers() {
 }
 
 void
-vc1_video_packetizer_c::add_timecodes_to_parser(packet_cptr &packet) {
+vc1_video_packetizer_c::add_timecodes_to_parser(packet_cptr const &packet) {
   if (-1 != packet->timecode)
     m_parser.add_timecode(packet->timecode, 0);
 
@@ -114,6 +115,28 @@ vc1_video_packetizer_c::add_timecodes_to_parser(packet_cptr &packet) {
 
 int
 vc1_video_packetizer_c::process(packet_cptr packet) {
+  // The headers are taken from the parser's state, so parsing is
+  // done synchronously until they've been found.
+  if (m_worker && m_raw_headers) {
+    m_worker->submit(packet, [this, packet]() -> packetizer_worker_c::completion_t {
+      add_timecodes_to_parser(packet);
+      m_parser.add_bytes(packet->data->get_buffer(), packet->data->get_size());
+
+      auto frames = std::vector<mtx::vc1::frame_cptr>{};
+      while (m_parser.is_frame_available())
+        frames.push_back(m_parser.get_frame());
+
+      return [this, frames]() {
+        for (auto const &frame : frames)
+          add_frame(frame);
+      };
+    });
+
+    m_worker->complete_finished_jobs();
+
+    return FILE_STATUS_MOREDATA;
+  }
+
   add_timecodes_to_parser(packet);
 
   m_parser.add_bytes(packet->data->get_buffer(), packet->data->get_size());
@@ -144,18 +167,31 @@ vc1_video_packetizer_c::headers_found() {
 
 void
 vc1_video_packetizer_c::flush_impl() {
+  if (m_worker) {
+    m_worker->complete_all_jobs();
+    m_worker.reset();
+  }
+
   m_parser.flush();
   flush_frames();
 }
 
 void
 vc1_video_packetizer_c::flush_frames() {
-  while (m_parser.is_frame_available()) {
-    auto frame = m_parser.get_frame();
-    add_packet(new packet_t(frame->data, frame->timecode, frame->duration, frame->is_key() ? -1 : m_previous_timecode));
+  while (m_parser.is_frame_available())
+    add_frame(m_parser.get_frame());
+}
 
-    m_previous_timecode = frame->timecode;
-  }
+void
+vc1_video_packetizer_c::add_frame(mtx::vc1::frame_cptr const &frame) {
+  add_packet(new packet_t(frame->data, frame->timecode, frame->duration, frame->is_key() ? -1 : m_previous_timecode));
+
+  m_previous_timecode = frame->timecode;
+}
+
+bool
+vc1_video_packetizer_c::complete_parsed_frames() {
+  return m_worker && m_worker->complete_finished_jobs();
 }
 
 connection_result_e
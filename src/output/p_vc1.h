@@ -17,6 +17,7 @@
 #include "common/common_pch.h"
 
 #include "merge/generic_packetizer.h"
+#include "merge/packetizer_worker.h"
 #include "common/vc1.h"
 
 class vc1_video_packetizer_c: public generic_packetizer_c {
@@ -27,6 +28,8 @@ protected:
 
   int64_t m_previous_timecode;
 
+  std::unique_ptr<packetizer_worker_c> m_worker;
+
 public:
   vc1_video_packetizer_c(generic_reader_c *n_reader, track_info_c &n_ti);
 
@@ -42,8 +45,10 @@ public:
 protected:
   virtual void flush_impl();
   virtual void flush_frames();
+  virtual void add_frame(mtx::vc1::frame_cptr const &frame);
+  virtual bool complete_parsed_frames();
   virtual void headers_found();
-  virtual void add_timecodes_to_parser(packet_cptr &packet);
+  virtual void add_timecodes_to_parser(packet_cptr const &packet);
 };
 
 #endif // MTX_P_VC1_H
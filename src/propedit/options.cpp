@@ -23,6 +23,7 @@
 
 options_c::options_c()
   : m_show_progress(false)
+  , m_use_index_cache(false)
   , m_parse_mode(kax_analyzer_c::parse_mode_fast)
 {
 }
@@ -127,10 +128,12 @@ options_c::dump_info()
   mxinfo(boost::format("options:\n"
                        "  file_name:     %1%\n"
                        "  show_progress: %2%\n"
-                       "  parse_mode:    %3%\n")
+                       "  parse_mode:    %3%\n"
+                       "  index_cache:   %4%\n")
          % m_file_name
          % m_show_progress
-         % static_cast<int>(m_parse_mode));
+         % static_cast<int>(m_parse_mode)
+         % m_use_index_cache);
 
   for (auto &target : m_targets)
     target->dump_info();
@@ -23,7 +23,7 @@ class options_c {
 public:
   std::string m_file_name;
   std::vector<target_cptr> m_targets;
-  bool m_show_progress;
+  bool m_show_progress, m_use_index_cache;
   kax_analyzer_c::parse_mode_e m_parse_mode;
 
 public:
@@ -126,6 +126,7 @@ run(options_cptr &options) {
   try {
     ok = analyzer
       ->set_parse_mode(options->m_parse_mode)
+      .set_use_index_cache(options->m_use_index_cache)
       .set_open_mode(MODE_WRITE)
       .set_throw_on_error(true)
       .process();
@@ -35,6 +35,11 @@ propedit_cli_parser_c::set_parse_mode() {
   }
 }
 
+void
+propedit_cli_parser_c::enable_index_cache() {
+  m_options->m_use_index_cache = true;
+}
+
 void
 propedit_cli_parser_c::add_target() {
   try {
@@ -206,6 +211,7 @@ propedit_cli_parser_c::init_parser() {
   add_section_header(YT("Options"));
   OPT("l|list-property-names",      list_property_names, YT("List all valid property names and exit"));
   OPT("p|parse-mode=<mode>",        set_parse_mode,      YT("Sets the Matroska parser mode to 'fast' (default) or 'full'"));
+  OPT("use-index-cache",            enable_index_cache,  YT("Re-use the positions of the file's top level elements from an earlier run instead of analyzing the file again"));
 
   add_section_header(YT("Actions for handling properties"));
   OPT("e|edit=<selector>",          add_target,          YT("Sets the Matroska file section that all following add/set/delete "
@@ -11,16 +11,21 @@
 #include "common/os.h"
 
 #include <algorithm>
+#include <deque>
+#include <future>
 #include <limits>
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "common/bit_cursor.h"
 #include "common/byte_buffer.h"
 #include "common/checksums/base.h"
 #include "common/common_pch.h"
+#include "common/endian.h"
 #include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/strings/parsing.h"
 #include "common/translation.h"
 
@@ -33,10 +38,18 @@ static auto g_errors_found   = false;
 static auto g_warnings_found = false;
 
 static int64_t g_file_size;
-static mm_file_io_c *g_in;
+static std::string g_file_name;
 
 static std::map<int64_t, bool> g_is_master;
 
+static unsigned int g_num_jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+static uint32_t const s_crc32_id         = 0xBF;
+static uint32_t const s_cluster_id       = 0x1F43B675;
+static uint32_t const s_block_id         = 0xA1;
+static uint32_t const s_simple_block_id  = 0xA3;
+static int64_t const s_max_cluster_job_size = 64 * 1024 * 1024;
+
 class vint_c {
 public:
   int64_t value;
@@ -62,6 +75,228 @@ public:
   }
 };
 
+class fatal_error_c {
+public:
+  std::string m_message;
+
+  fatal_error_c(std::string const &message)
+    : m_message(message)
+  {
+  }
+};
+
+/* The state of the validation of a range of the file. The main
+   thread validates the file sequentially and writes its output
+   immediately. Clusters can be validated by other threads. Their
+   output is collected in m_output and written in file order once the
+   cluster has been validated completely.
+*/
+class context_c {
+public:
+  // A CRC-32 element covers the rest of its parent's content. Its
+  // checksum is calculated from the data read while that is parsed.
+  struct crc32_t {
+    int m_level;
+    int64_t m_pos, m_end_pos;
+    uint32_t m_stored_crc;
+    mtx::checksum::base_uptr m_crc;
+  };
+
+  mm_io_c *m_in;
+  int64_t m_base_pos;
+  bool m_buffer_output, m_errors_found, m_warnings_found;
+  std::string m_output, m_fatal_error;
+  std::vector<crc32_t> m_crc32s;
+  memory_cptr m_skip_buffer;
+
+  context_c(mm_io_c *in,
+            int64_t base_pos,
+            bool buffer_output)
+    : m_in(in)
+    , m_base_pos(base_pos)
+    , m_buffer_output(buffer_output)
+    , m_errors_found(false)
+    , m_warnings_found(false)
+  {
+  }
+
+  int64_t get_pos() {
+    return m_base_pos + m_in->getFilePointer();
+  }
+
+  bool set_pos(int64_t pos);
+  uint32_t read(unsigned char *buffer, uint32_t size);
+  unsigned char read_uint8();
+
+  void add_crc32(int level, int64_t pos, uint32_t stored_crc, int64_t end_pos);
+
+  void info(boost::format const &message);
+  void fatal(boost::format const &message);
+
+protected:
+  void verify_crc32s(int64_t pos);
+};
+
+class output_queue_c {
+protected:
+  struct entry_t {
+    std::future<context_c> m_job;
+    std::string m_trailing_output;
+  };
+
+  std::deque<entry_t> m_entries;
+
+public:
+  void add_output(std::string const &output) {
+    if (m_entries.empty())
+      mxinfo(output);
+    else
+      m_entries.back().m_trailing_output += output;
+  }
+
+  void add_job(std::future<context_c> job) {
+    m_entries.push_back(entry_t{std::move(job), {}});
+
+    while (m_entries.size() > g_num_jobs)
+      write_first();
+
+    while (!m_entries.empty() && (m_entries.front().m_job.wait_for(std::chrono::seconds::zero()) == std::future_status::ready))
+      write_first();
+  }
+
+  void finish() {
+    while (!m_entries.empty())
+      write_first();
+  }
+
+protected:
+  void write_first() {
+    auto &entry = m_entries.front();
+    auto result = entry.m_job.get();
+
+    mxinfo(result.m_output);
+    mxinfo(entry.m_trailing_output);
+
+    g_errors_found   = g_errors_found   || result.m_errors_found;
+    g_warnings_found = g_warnings_found || result.m_warnings_found;
+
+    m_entries.pop_front();
+
+    if (result.m_fatal_error.empty())
+      return;
+
+    // No thread must be running while the program exits.
+    for (auto &other_entry : m_entries)
+      other_entry.m_job.wait();
+
+    mxerror(result.m_fatal_error);
+  }
+};
+
+static output_queue_c g_output_queue;
+
+static std::string
+level_string(int level) {
+  std::string s;
+  int i;
+
+  for (i = 0; i < level; ++i)
+    s += " ";
+
+  return s;
+}
+
+void
+context_c::info(boost::format const &message) {
+  if (m_buffer_output)
+    m_output += message.str();
+  else
+    g_output_queue.add_output(message.str());
+}
+
+/* Moves to pos. Data covered by a CRC-32 element is read instead of
+   being skipped so that it is checksummed.
+*/
+bool
+context_c::set_pos(int64_t pos) {
+  if (!m_crc32s.empty() && (get_pos() < pos)) {
+    if (!m_skip_buffer)
+      m_skip_buffer = memory_c::alloc(1024 * 1024);
+
+    while (!m_crc32s.empty() && (get_pos() < pos)) {
+      auto to_read = static_cast<uint32_t>(std::min<int64_t>({ pos, m_crc32s.front().m_end_pos, get_pos() + static_cast<int64_t>(m_skip_buffer->get_size()) }) - get_pos());
+      if (read(m_skip_buffer->get_buffer(), to_read) != to_read) {
+        verify_crc32s(std::numeric_limits<int64_t>::max());
+        break;
+      }
+    }
+  }
+
+  return m_in->setFilePointer2(pos - m_base_pos);
+}
+
+uint32_t
+context_c::read(unsigned char *buffer,
+                uint32_t size) {
+  auto pos      = get_pos();
+  auto num_read = m_in->read(buffer, size);
+
+  for (auto &crc32 : m_crc32s)
+    crc32.m_crc->add(buffer, std::min<int64_t>(num_read, crc32.m_end_pos - pos));
+
+  verify_crc32s(pos + num_read);
+
+  return num_read;
+}
+
+unsigned char
+context_c::read_uint8() {
+  unsigned char byte;
+  if (read(&byte, 1) != 1)
+    throw mtx::mm_io::end_of_file_x{};
+
+  return byte;
+}
+
+void
+context_c::add_crc32(int level,
+                     int64_t pos,
+                     uint32_t stored_crc,
+                     int64_t end_pos) {
+  m_crc32s.push_back(crc32_t{level, pos, end_pos, stored_crc, mtx::checksum::for_algorithm(mtx::checksum::algorithm_e::crc32_ieee_le, 0xffffffff)});
+  verify_crc32s(get_pos());
+}
+
+/* Compares the checksums of all CRC-32 elements whose parent ends at or
+   before pos. Nested parents end first, so they're at the back.
+*/
+void
+context_c::verify_crc32s(int64_t pos) {
+  while (!m_crc32s.empty() && (m_crc32s.back().m_end_pos <= pos)) {
+    auto &crc32         = m_crc32s.back();
+    auto calculated_crc = static_cast<uint32_t>(0xffffffff ^ dynamic_cast<mtx::checksum::uint_result_c &>(*crc32.m_crc).get_result_as_uint());
+
+    if (crc32.m_stored_crc != calculated_crc) {
+      info(boost::format(Y("%1%  Error: CRC-32 mismatch for the element at %2% (stored: 0x%|3$08x|, calculated: 0x%|4$08x|)\n")) % level_string(crc32.m_level) % crc32.m_pos % crc32.m_stored_crc % calculated_crc);
+      m_errors_found = true;
+    }
+
+    m_crc32s.pop_back();
+  }
+}
+
+/* Ends the validation. Clusters validated in other threads must not
+   exit the program. Their error is reported by the main thread once
+   the cluster's output is due.
+*/
+void
+context_c::fatal(boost::format const &message) {
+  if (!m_buffer_output)
+    mxerror(message);
+
+  throw fatal_error_c{message.str()};
+}
+
 static void
 show_help() {
   mxinfo(Y("ebml_validor [options] input_file_name\n"
@@ -72,6 +307,8 @@ show_help() {
            "  -e, --end <value>      Stop parsing at file position value\n"
            "  -m, --master <value>   The EBML ID value (in hex) is a master\n"
            "  -M, --auto-masters     Use all of Matroska's master elements\n"
+           "  -j, --jobs <value>     Validate up to value clusters at the same time\n"
+           "                         (default: the number of CPUs)\n"
            "\n"
            "General options:\n"
            "\n"
@@ -124,6 +361,11 @@ parse_args(std::vector<std::string> &args) {
         g_is_master[id] = true;
       }
 
+    } else if ((*arg == "-j") || (*arg == "--jobs")) {
+      ++arg;
+      if ((args.end() == arg) || !parse_number(*arg, g_num_jobs) || (0 == g_num_jobs))
+        mxerror(Y("Missing/wrong arugment to --jobs\n"));
+
     } else if ((*arg == "-M") || (*arg == "--auto-masters")) {
       std::map<uint32_t, bool>::const_iterator i = g_master_information.begin();
       while (g_master_information.end() != i) {
@@ -178,28 +420,18 @@ public:
   }
 };
 
-static std::string
-level_string(int level) {
-  std::string s;
-  int i;
-
-  for (i = 0; i < level; ++i)
-    s += " ";
-
-  return s;
-}
-
 static vint_c
-read_id(int64_t end_pos) {
+read_id(context_c &ctx,
+        int64_t end_pos) {
   try {
-    int64_t pos = g_in->getFilePointer();
+    int64_t pos = ctx.get_pos();
     int mask    = 0x80;
     int id_len  = 1;
 
     if (pos >= end_pos)
       throw id_error_c(id_error_c::end_of_scope);
 
-    unsigned char first_byte = g_in->read_uint8();
+    unsigned char first_byte = ctx.read_uint8();
 
     while (0 != mask) {
       if (0 != (first_byte & mask))
@@ -222,7 +454,7 @@ read_id(int64_t end_pos) {
     int i;
     for (i = 1; i < id_len; ++i) {
       id <<= 8;
-      id  |= g_in->read_uint8();
+      id  |= ctx.read_uint8();
     }
 
     return vint_c(id, id_len);
@@ -233,16 +465,17 @@ read_id(int64_t end_pos) {
 }
 
 static vint_c
-read_size(int64_t end_pos) {
+read_size(context_c &ctx,
+          int64_t end_pos) {
   try {
-    int64_t pos  = g_in->getFilePointer();
+    int64_t pos  = ctx.get_pos();
     int mask     = 0x80;
     int size_len = 1;
 
     if (pos >= end_pos)
       throw size_error_c(size_error_c::end_of_scope);
 
-    unsigned char first_byte = g_in->read_uint8();
+    unsigned char first_byte = ctx.read_uint8();
 
     while (0 != mask) {
       if (0 != (first_byte & mask))
@@ -259,7 +492,7 @@ read_size(int64_t end_pos) {
     int i;
     for (i = 1; i < size_len; ++i) {
       size <<= 8;
-      size  |= g_in->read_uint8();
+      size  |= ctx.read_uint8();
     }
 
     return vint_c(size, size_len);
@@ -269,47 +502,239 @@ read_size(int64_t end_pos) {
   }
 }
 
+static bool
+is_master(uint32_t id) {
+  auto itr = g_is_master.find(id);
+  return (g_is_master.end() != itr) && itr->second;
+}
+
+static std::string
+get_element_name(uint32_t id) {
+  auto itr = g_element_names.find(id);
+  return (g_element_names.end() != itr) && !itr->second.empty() ? itr->second : std::string{Y("unknown")};
+}
+
 static void
-parse_content(int level,
+verify_crc32(context_c &ctx,
+             int level,
+             int64_t pos,
+             vint_c const &size,
+             int64_t end_pos) {
+  if (4 != size.value) {
+    ctx.info(boost::format(Y("%1%  Error: the CRC-32 element's size is not four bytes\n")) % level_string(level));
+    ctx.m_errors_found = true;
+    return;
+  }
+
+  // The checksum covers everything in the parent element following
+  // the CRC-32 element. It's verified once the parent has been parsed.
+  unsigned char stored_crc[4];
+  if (ctx.read(stored_crc, 4) != 4)
+    throw mtx::mm_io::end_of_file_x{};
+
+  ctx.add_crc32(level, pos, get_uint32_le(stored_crc), end_pos);
+}
+
+static std::string
+check_block_lacing(unsigned char const *buffer,
+                   int64_t available,
+                   int64_t block_size,
+                   bool &need_more) {
+  auto pos       = int64_t{};
+  auto read_byte = [&](unsigned char &byte) -> bool {
+    if (pos >= available) {
+      need_more = available < block_size;
+      return false;
+    }
+    byte = buffer[pos++];
+    return true;
+  };
+
+  auto read_vint = [&](int64_t &value, int &length) -> bool {
+    unsigned char byte;
+    if (!read_byte(byte) || !byte)
+      return false;
+
+    length   = 1;
+    auto mask = 0x80;
+    while (!(byte & mask)) {
+      mask >>= 1;
+      ++length;
+    }
+
+    value = byte & (mask - 1);
+    for (auto idx = 1; idx < length; ++idx) {
+      if (!read_byte(byte))
+        return false;
+      value = (value << 8) | byte;
+    }
+
+    return true;
+  };
+
+  unsigned char byte;
+  int64_t track_number;
+  int length;
+
+  need_more = false;
+
+  if (!read_vint(track_number, length))
+    return need_more ? std::string{} : Y("the track number is invalid");
+
+  if ((pos + 3) > available)
+    return Y("the block is smaller than its header");
+
+  auto lacing = (buffer[pos + 2] >> 1) & 0x03;
+  pos        += 3;
+
+  if (!lacing)
+    return {};
+
+  if (!read_byte(byte))
+    return need_more ? std::string{} : Y("the number of laced frames is missing");
+
+  auto num_frames = static_cast<int64_t>(byte) + 1;
+  auto total_size = int64_t{};
+
+  if (1 == lacing) {            // Xiph
+    for (auto frame = 1; frame < num_frames; ++frame) {
+      do {
+        if (!read_byte(byte))
+          return need_more ? std::string{} : Y("the lace sizes are truncated");
+        total_size += byte;
+      } while (0xff == byte);
+    }
+
+  } else if (3 == lacing) {     // EBML
+    int64_t frame_size;
+    if (!read_vint(frame_size, length))
+      return need_more ? std::string{} : Y("the lace sizes are truncated");
+
+    total_size = frame_size;
+
+    for (auto frame = 2; frame < num_frames; ++frame) {
+      int64_t difference;
+      if (!read_vint(difference, length))
+        return need_more ? std::string{} : Y("the lace sizes are truncated");
+
+      frame_size += difference - ((int64_t{1} << (7 * length - 1)) - 1);
+      if (0 > frame_size)
+        return Y("a lace size is negative");
+
+      total_size += frame_size;
+    }
+
+  } else if (((block_size - pos) % num_frames) != 0) // fixed-size
+    return Y("the data size is not a multiple of the number of laced frames");
+
+  if ((pos + total_size) > block_size)
+    return Y("the lace sizes exceed the block size");
+
+  return {};
+}
+
+static void
+verify_block(context_c &ctx,
+             int level,
+             int64_t block_size) {
+  static int64_t const s_header_size = 64 * 1024;
+
+  try {
+    auto need_more = false;
+    auto content   = memory_c::alloc(std::min(block_size, s_header_size));
+    if (ctx.read(content->get_buffer(), content->get_size()) != content->get_size())
+      throw mtx::mm_io::end_of_file_x{};
+
+    auto error     = check_block_lacing(content->get_buffer(), content->get_size(), block_size, need_more);
+
+    // Only Xiph lacing of huge frames leads to lace headers this big.
+    if (need_more) {
+      content->resize(block_size);
+      if (ctx.read(content->get_buffer() + s_header_size, block_size - s_header_size) != static_cast<uint32_t>(block_size - s_header_size))
+        throw mtx::mm_io::end_of_file_x{};
+      error = check_block_lacing(content->get_buffer(), block_size, block_size, need_more);
+    }
+
+    if (!error.empty()) {
+      ctx.info(boost::format(Y("%1%  Error: invalid block: %2%\n")) % level_string(level) % error);
+      ctx.m_errors_found = true;
+    }
+
+  } catch (mtx::exception &) {
+    ctx.info(boost::format(Y("%1%  Error: invalid block: %2%\n")) % level_string(level) % Y("end of file"));
+    ctx.m_errors_found = true;
+  }
+}
+
+static context_c validate_cluster(int level, int64_t start_pos, int64_t end_pos);
+
+static void
+parse_content(context_c &ctx,
+              int level,
               int64_t end_pos) {
-  while (static_cast<int64_t>(g_in->getFilePointer()) < end_pos) {
-    int64_t element_start_pos = g_in->getFilePointer();
+  auto first_child = true;
+
+  while (ctx.get_pos() < end_pos) {
+    int64_t element_start_pos = ctx.get_pos();
 
     try {
-      vint_c  id          = read_id(end_pos);
-      vint_c size         = read_size(end_pos);
+      vint_c  id          = read_id(ctx, end_pos);
+      vint_c size         = read_size(ctx, end_pos);
 
-      std::string element_name = g_element_names[id.value];
-      if (element_name.empty())
-        element_name      = Y("unknown");
+      std::string element_name = get_element_name(id.value);
 
-      mxinfo(boost::format(Y("%1%pos %2% id 0x%|3$x| size %4% header size %5% (%6%)\n"))
-             % level_string(level) % element_start_pos % id.value % size.value % (id.coded_size + size.coded_size) % element_name);
+      ctx.info(boost::format(Y("%1%pos %2% id 0x%|3$x| size %4% header size %5% (%6%)\n"))
+               % level_string(level) % element_start_pos % id.value % size.value % (id.coded_size + size.coded_size) % element_name);
 
       if (size.is_unknown()) {
-        mxinfo(boost::format(Y("%1%  Warning: size is coded as 'unknown' (all bits are set)\n")) % level_string(level));
+        ctx.info(boost::format(Y("%1%  Warning: size is coded as 'unknown' (all bits are set)\n")) % level_string(level));
 
         // In Matroska segments often have an unknown size – so don't
         // warn about it.
         if (element_name != "Segment")
-          g_warnings_found = true;
+          ctx.m_warnings_found = true;
       }
 
-      int64_t content_end_pos = size.is_unknown() ? end_pos : g_in->getFilePointer() + size.value;
+      int64_t content_start_pos = ctx.get_pos();
+      int64_t content_end_pos   = size.is_unknown() ? end_pos : content_start_pos + size.value;
 
       if (content_end_pos > end_pos) {
-        mxinfo(boost::format(Y("%1%  Error: Element ends after scope\n")) % level_string(level));
-        g_errors_found = true;
-        if (!g_in->setFilePointer2(end_pos))
-          mxerror(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
+        ctx.info(boost::format(Y("%1%  Error: Element ends after scope\n")) % level_string(level));
+        ctx.m_errors_found = true;
+        if (!ctx.set_pos(end_pos))
+          ctx.fatal(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
         return;
       }
 
-      if (g_is_master[id.value])
-        parse_content(level + 1, content_end_pos);
+      if ((s_crc32_id == id.value) && (0 < level)) {
+        if (!first_child) {
+          ctx.info(boost::format(Y("%1%  Warning: the CRC-32 element is not the first child of its parent\n")) % level_string(level));
+          ctx.m_warnings_found = true;
+        }
+
+        verify_crc32(ctx, level, element_start_pos, size, end_pos);
+
+      } else if (((s_block_id == id.value) || (s_simple_block_id == id.value)) && !size.is_unknown())
+        verify_block(ctx, level, size.value);
 
-      if (!g_in->setFilePointer2(content_end_pos))
-        mxerror(boost::format(Y("Error: Seek to %1%\n")) % content_end_pos);
+      auto validate_concurrently
+        =  (s_cluster_id == id.value)
+        && !size.is_unknown()
+        && (1 < g_num_jobs)
+        && !ctx.m_buffer_output
+        && (size.value <= s_max_cluster_job_size);
+
+      if (is_master(id.value) && validate_concurrently)
+        g_output_queue.add_job(std::async(std::launch::async, validate_cluster, level + 1, content_start_pos, content_end_pos));
+
+      else if (is_master(id.value)) {
+        if (!ctx.set_pos(content_start_pos))
+          ctx.fatal(boost::format(Y("Error: Seek to %1%\n")) % content_start_pos);
+        parse_content(ctx, level + 1, content_end_pos);
+      }
+
+      if (!ctx.set_pos(content_end_pos))
+        ctx.fatal(boost::format(Y("Error: Seek to %1%\n")) % content_end_pos);
 
     } catch (id_error_c &error) {
       std::string message
@@ -319,11 +744,11 @@ parse_content(int level,
         : id_error_c::longer_than_four_bytes == error.code ? Y("ID is longer than four bytes")
         :                                                    Y("reason is unknown");
 
-      mxinfo(boost::format(Y("%1%Error at %2%: error reading the element ID (%3%)\n")) % level_string(level) % element_start_pos % message);
-      g_errors_found = true;
+      ctx.info(boost::format(Y("%1%Error at %2%: error reading the element ID (%3%)\n")) % level_string(level) % element_start_pos % message);
+      ctx.m_errors_found = true;
 
-      if (!g_in->setFilePointer2(end_pos))
-        mxerror(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
+      if (!ctx.set_pos(end_pos))
+        ctx.fatal(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
       return;
 
     } catch (size_error_c &error) {
@@ -332,24 +757,65 @@ parse_content(int level,
         : size_error_c::end_of_scope == error.code ? Y("End of scope")
         :                                            Y("reason is unknown");
 
-      mxinfo(boost::format(Y("%1%Error at %2%: error reading the element size (%3%)\n")) % level_string(level) % element_start_pos % message);
-      g_errors_found = true;
+      ctx.info(boost::format(Y("%1%Error at %2%: error reading the element size (%3%)\n")) % level_string(level) % element_start_pos % message);
+      ctx.m_errors_found = true;
 
-      if (!g_in->setFilePointer2(end_pos))
-        mxerror(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
+      if (!ctx.set_pos(end_pos))
+        ctx.fatal(boost::format(Y("Error: Seek to %1%\n")) % end_pos);
       return;
 
+    } catch (fatal_error_c &) {
+      throw;
+
     } catch (...) {
-      mxerror(Y("Unknown error occured\n"));
+      ctx.fatal(boost::format(Y("Unknown error occured\n")));
     }
+
+    first_child = false;
+  }
+}
+
+/* Runs in its own thread. The whole cluster is read with a single
+   read request and validated from memory.
+*/
+static context_c
+validate_cluster(int level,
+                 int64_t start_pos,
+                 int64_t end_pos) {
+  context_c ctx(nullptr, start_pos, true);
+
+  try {
+    auto size    = end_pos - start_pos;
+    auto content = memory_c::alloc(size);
+
+    mm_file_io_c file(g_file_name);
+    file.setFilePointer(start_pos);
+    auto num_read = file.read(content->get_buffer(), size);
+
+    mm_mem_io_c in(content->get_buffer(), num_read);
+    ctx.m_in = &in;
+
+    parse_content(ctx, level, end_pos);
+
+  } catch (fatal_error_c &error) {
+    ctx.m_fatal_error = error.m_message;
+
+  } catch (...) {
+    ctx.m_fatal_error = Y("Unknown error occured\n");
   }
+
+  ctx.m_in = nullptr;
+  ctx.m_skip_buffer.reset();
+
+  return ctx;
 }
 
 static void
 parse_file(const std::string &file_name) {
-  mm_file_io_c in(file_name);
+  mm_read_buffer_io_c in(new mm_file_io_c(file_name), 1 << 20);
+  context_c ctx(&in, 0, false);
 
-  g_in        = &in;
+  g_file_name = file_name;
   g_file_size = in.get_size();
 
   g_start     = std::min(g_file_size, g_start);
@@ -358,11 +824,13 @@ parse_file(const std::string &file_name) {
   if (!in.setFilePointer2(g_start))
     mxerror(boost::format(Y("Error: Seek to %1%\n")) % g_start);
 
-  parse_content(0, g_end);
+  parse_content(ctx, 0, g_end);
 
-  if (g_errors_found)
+  g_output_queue.finish();
+
+  if (g_errors_found || ctx.m_errors_found)
     mxexit(2);
-  if (g_warnings_found)
+  if (g_warnings_found || ctx.m_warnings_found)
     mxexit(1);
 }
 
@@ -374,6 +842,10 @@ main(int argc,
   init_element_names();
   init_master_information();
 
+  // The CRC tables are initialized on first use which must not
+  // happen in several threads at the same time.
+  mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::crc32_ieee_le, "", 0);
+
   std::vector<std::string> args = command_line_utf8(argc, argv);
   std::string file_name         = parse_args(args);
 
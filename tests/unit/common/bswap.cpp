@@ -0,0 +1,57 @@
+#include "common/common_pch.h"
+
+#include "common/bswap.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<unsigned char>
+create_words(std::size_t num_words,
+             std::size_t word_length) {
+  auto bytes = std::vector<unsigned char>(num_words * word_length);
+  for (auto idx = 0u; idx < bytes.size(); ++idx)
+    bytes[idx] = idx * 7 + 3;
+
+  return bytes;
+}
+
+std::vector<unsigned char>
+swap_naively(std::vector<unsigned char> const &bytes,
+             std::size_t word_length) {
+  auto swapped = bytes;
+  for (auto idx = 0u; idx < bytes.size(); idx += word_length)
+    std::reverse(swapped.begin() + idx, swapped.begin() + idx + word_length);
+
+  return swapped;
+}
+
+TEST(BSwap, Buffer) {
+  for (auto word_length : std::vector<std::size_t>{ 2, 3, 4, 6, 8 })
+    for (auto num_words : std::vector<std::size_t>{ 0, 1, 5, 16, 33, 100 }) {
+      auto src      = create_words(num_words, word_length);
+      auto expected = swap_naively(src, word_length);
+      auto dst      = std::vector<unsigned char>(src.size());
+
+      mtx::bswap_buffer(src.data(), dst.data(), src.size(), word_length);
+      EXPECT_EQ(expected, dst);
+    }
+}
+
+TEST(BSwap, BufferInPlace) {
+  for (auto word_length : std::vector<std::size_t>{ 2, 3, 4, 8 }) {
+    auto data     = create_words(67, word_length);
+    auto expected = swap_naively(data, word_length);
+
+    mtx::bswap_buffer(data.data(), data.data(), data.size(), word_length);
+    EXPECT_EQ(expected, data);
+  }
+}
+
+TEST(BSwap, BufferInvalidSize) {
+  unsigned char buffer[5];
+
+  EXPECT_THROW(mtx::bswap_buffer(buffer, buffer, 5, 2), std::invalid_argument);
+}
+
+}
@@ -0,0 +1,37 @@
+#include "common/common_pch.h"
+
+#include "common/flac.h"
+
+#include "gtest/gtest.h"
+
+#if defined(HAVE_FLAC_FORMAT_H)
+
+namespace {
+
+TEST(FLAC, FrameHeaderSizeValid) {
+  unsigned char const simple[]          = { 0xff, 0xf8, 0xc9, 0x18, 0x00, 0xc2, 0x00, 0x00 };
+  unsigned char const with_block_size[] = { 0xff, 0xf8, 0x79, 0x18, 0xc2, 0x80, 0x0f, 0xff, 0xaf, 0x00 };
+  unsigned char const variable[]        = { 0xff, 0xf9, 0xc9, 0x18, 0xe1, 0x80, 0x80, 0x74 };
+
+  EXPECT_EQ(6u, mtx::flac::get_frame_header_size(simple,          sizeof(simple)));
+  EXPECT_EQ(9u, mtx::flac::get_frame_header_size(with_block_size, sizeof(with_block_size)));
+  EXPECT_EQ(8u, mtx::flac::get_frame_header_size(variable,        sizeof(variable)));
+}
+
+TEST(FLAC, FrameHeaderSizeInvalid) {
+  unsigned char const wrong_crc[]        = { 0xff, 0xf8, 0xc9, 0x18, 0x00, 0xc3 };
+  unsigned char const wrong_sync[]       = { 0xff, 0xfa, 0xc9, 0x18, 0x00, 0xc2 };
+  unsigned char const reserved_bits[]    = { 0xff, 0xf8, 0x09, 0x18, 0x00, 0xc2 };
+  unsigned char const bad_utf8[]         = { 0xff, 0xf8, 0xc9, 0x18, 0xe1, 0x00, 0x80, 0x74 };
+  unsigned char const simple[]           = { 0xff, 0xf8, 0xc9, 0x18, 0x00, 0xc2 };
+
+  EXPECT_EQ(0u, mtx::flac::get_frame_header_size(wrong_crc,     sizeof(wrong_crc)));
+  EXPECT_EQ(0u, mtx::flac::get_frame_header_size(wrong_sync,    sizeof(wrong_sync)));
+  EXPECT_EQ(0u, mtx::flac::get_frame_header_size(reserved_bits, sizeof(reserved_bits)));
+  EXPECT_EQ(0u, mtx::flac::get_frame_header_size(bad_utf8,      sizeof(bad_utf8)));
+  EXPECT_EQ(0u, mtx::flac::get_frame_header_size(simple,        sizeof(simple) - 1));
+}
+
+}
+
+#endif  // HAVE_FLAC_FORMAT_H
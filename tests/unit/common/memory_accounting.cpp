@@ -0,0 +1,79 @@
+#include "common/common_pch.h"
+
+#include "common/memory_accounting.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(MemoryAccounting, CurrentAndPeak) {
+  auto &component = mtx::memory_accounting::component("unit test current and peak");
+  auto base       = mtx::memory_accounting::get_current();
+
+  component.add(1000);
+  component.add(500);
+  component.remove(1200);
+  component.add(100);
+
+  EXPECT_EQ(400,         component.get_current());
+  EXPECT_EQ(1500,        component.get_peak());
+  EXPECT_EQ(base + 400,  mtx::memory_accounting::get_current());
+  EXPECT_LE(base + 1500, mtx::memory_accounting::get_peak());
+
+  component.remove(400);
+  EXPECT_EQ(0,    component.get_current());
+  EXPECT_EQ(base, mtx::memory_accounting::get_current());
+}
+
+TEST(MemoryAccounting, ComponentsAreRegisteredOnce) {
+  auto &first  = mtx::memory_accounting::component("unit test registration");
+  auto &second = mtx::memory_accounting::component("unit test registration");
+
+  EXPECT_EQ(&first, &second);
+  EXPECT_EQ(1, boost::count_if(mtx::memory_accounting::components(), [](mtx::memory_accounting::component_c const *component) {
+    return component->get_name() == "unit test registration";
+  }));
+}
+
+TEST(MemoryAccounting, Limit) {
+  auto &component = mtx::memory_accounting::component("unit test limit");
+  auto base       = mtx::memory_accounting::get_current();
+
+  mtx::memory_accounting::set_limit(0);
+  component.add(1000);
+  EXPECT_FALSE(mtx::memory_accounting::limit_reached());
+
+  mtx::memory_accounting::set_limit(base + 1001);
+  EXPECT_FALSE(mtx::memory_accounting::limit_reached());
+
+  component.add(1);
+  EXPECT_TRUE(mtx::memory_accounting::limit_reached());
+
+  component.remove(1001);
+  EXPECT_FALSE(mtx::memory_accounting::limit_reached());
+
+  mtx::memory_accounting::set_limit(0);
+  EXPECT_EQ(0, mtx::memory_accounting::get_limit());
+}
+
+TEST(MemoryAccounting, ConcurrentUpdates) {
+  auto &component = mtx::memory_accounting::component("unit test concurrent updates");
+  auto threads    = std::vector<std::thread>{};
+
+  for (auto idx = 0; idx < 4; ++idx)
+    threads.emplace_back([&component]() {
+      for (auto round = 0; round < 10000; ++round) {
+        component.add(10);
+        component.remove(10);
+      }
+    });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0, component.get_current());
+  EXPECT_GE(40, component.get_peak());
+  EXPECT_LE(10, component.get_peak());
+}
+
+}
@@ -1,5 +1,10 @@
 #include "common/common_pch.h"
 
+#include <thread>
+#if !defined(SYS_WINDOWS)
+# include <unistd.h>
+#endif
+
 #include "gtest/gtest.h"
 #include "tests/unit/util.h"
 
@@ -7,6 +12,76 @@
 
 namespace {
 
+std::vector<unsigned char>
+create_pattern(std::size_t size) {
+  auto pattern = std::vector<unsigned char>(size);
+  for (auto idx = 0u; idx < size; ++idx)
+    pattern[idx] = (idx * 7 + idx / 251) & 0xff;
+
+  return pattern;
+}
+
+std::string
+temporary_file_name() {
+  return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("mtx-unit-test-%%%%-%%%%-%%%%")).string();
+}
+
+void
+write_and_read_back(unsigned int flags = 0) {
+  auto file_name = temporary_file_name();
+  auto expected  = create_pattern(5 * 1024 * 1024 + 123);
+
+  {
+    mm_file_io_c out{file_name, MODE_CREATE, flags};
+
+    // Small writes are collected in the buffer, large ones bypass it.
+    auto position = 0u;
+    for (auto size : { 1u, 10u, 100u, 1000u, 70000u, 3u, 200000u }) {
+      EXPECT_EQ(size, out.write(&expected[position], size));
+      position += size;
+    }
+
+    while (position < expected.size()) {
+      auto size = std::min<std::size_t>(expected.size() - position, 1024 * 1024 + 17);
+      EXPECT_EQ(size, out.write(&expected[position], size));
+      position += size;
+    }
+
+    // Overwrite data in the middle after seeking back.
+    for (auto idx = 5000u; idx < 5010u; ++idx)
+      expected[idx] = 0xaa;
+
+    out.setFilePointer(5000);
+    EXPECT_EQ(10u, out.write(&expected[5000], 10));
+
+    out.setFilePointer(0, seek_end);
+    EXPECT_EQ(expected.size(), out.getFilePointer());
+  }
+
+  {
+    mm_file_io_c in{file_name, MODE_READ, flags};
+    auto actual   = std::vector<unsigned char>(expected.size());
+    auto position = 0u;
+
+    EXPECT_EQ(expected.size(), in.get_size());
+
+    for (auto size : { 1u, 4999u, 20u, 100000u, 7u }) {
+      EXPECT_EQ(size, in.read(&actual[position], size));
+      position += size;
+    }
+
+    EXPECT_EQ(expected.size() - position, in.read(&actual[position], expected.size()));
+    EXPECT_TRUE(in.eof());
+    EXPECT_EQ(expected, actual);
+
+    in.setFilePointer(4990);
+    EXPECT_EQ(30u, in.read(&actual[0], 30));
+    EXPECT_TRUE(std::equal(&expected[4990], &expected[5020], &actual[0]));
+  }
+
+  boost::filesystem::remove(file_name);
+}
+
 TEST(MmIo, Slurp) {
   memory_cptr m;
 
@@ -16,4 +91,72 @@ TEST(MmIo, Slurp) {
   ASSERT_THROW(mm_file_io_c::slurp("doesnotexist"), mtx::mm_io::exception);
 }
 
+TEST(MmIo, FileWriteAndReadBack) {
+  write_and_read_back();
+}
+
+TEST(MmIo, FileWriteAndReadBackDirectOutput) {
+  // File systems without O_DIRECT support are written normally.
+  write_and_read_back(mm_file_io_c::FLAG_DIRECT_OUTPUT);
+}
+
+TEST(MmIo, FileWriteAndReadBackAvoidingPageCache) {
+  write_and_read_back(mm_file_io_c::FLAG_AVOID_PAGE_CACHE);
+}
+
+#if !defined(SYS_WINDOWS)
+TEST(MmIo, Pipes) {
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(fds));
+
+  auto expected = create_pattern(300000);
+  auto written  = uint64_t{};
+
+  auto writer   = std::thread{[&expected, &written, &fds]() {
+    {
+      mm_file_io_c out{(boost::format("/dev/fd/%1%") % fds[1]).str(), MODE_CREATE};
+      out.write(&expected[0], 10);
+      out.write(&expected[10], 100000);
+      out.write(&expected[100010], expected.size() - 100010);
+
+      out.setFilePointer(0, seek_end);
+      written = out.getFilePointer();
+    }
+
+    ::close(fds[1]);
+  }};
+
+  // One byte more so that reading until the end of the stream fits.
+  auto actual = std::vector<unsigned char>(expected.size() + 1);
+
+  {
+    mm_file_io_c in{(boost::format("/dev/fd/%1%") % fds[0]).str()};
+
+    EXPECT_THROW(in.setFilePointer(0, seek_end), mtx::mm_io::seek_x);
+
+    // Data that is still buffered can be read again.
+    EXPECT_EQ(10u, in.read(&actual[0], 10));
+    in.setFilePointer(0);
+    EXPECT_EQ(10u, in.read(&actual[0], 10));
+
+    auto position = 10u;
+    while (!in.eof()) {
+      auto num_read = in.read(&actual[position], std::min<std::size_t>(100000, expected.size() - position + 1));
+      position     += num_read;
+    }
+
+    EXPECT_EQ(expected.size(), position);
+    EXPECT_THROW(in.setFilePointer(0), mtx::mm_io::seek_x);
+  }
+
+  ::close(fds[0]);
+  writer.join();
+
+  actual.resize(expected.size());
+
+  EXPECT_EQ(expected.size(), written);
+  EXPECT_EQ(expected, actual);
+}
+#endif
+
 }
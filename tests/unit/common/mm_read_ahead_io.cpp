@@ -0,0 +1,104 @@
+#include "common/common_pch.h"
+
+#include "common/memory_accounting.h"
+#include "common/mm_read_ahead_io.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<unsigned char>
+create_data(std::size_t size) {
+  auto data = std::vector<unsigned char>(size);
+  for (auto idx = 0u; idx < size; ++idx)
+    data[idx] = (idx * 7 + idx / 251) & 0xff;
+
+  return data;
+}
+
+TEST(MmReadAheadIo, SequentialRead) {
+  auto data = create_data(5 * 1024 * 1024 + 17);
+  mm_read_ahead_io_c io{new mm_mem_io_c{data.data(), data.size()}, 1024 * 1024, 4};
+
+  EXPECT_EQ(static_cast<int64_t>(data.size()), io.get_size());
+
+  auto content = std::vector<unsigned char>(data.size() + 100);
+  auto num_read = 0u;
+
+  while (!io.eof()) {
+    auto chunk = std::min<std::size_t>(4711, content.size() - num_read);
+    num_read  += io.read(&content[num_read], chunk);
+  }
+
+  ASSERT_EQ(data.size(), num_read);
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), content.begin()));
+  EXPECT_EQ(data.size(), io.getFilePointer());
+}
+
+TEST(MmReadAheadIo, Seeking) {
+  auto data = create_data(3 * 1024 * 1024);
+  mm_read_ahead_io_c io{new mm_mem_io_c{data.data(), data.size()}, 256 * 1024, 4};
+  auto buffer = std::vector<unsigned char>(300000);
+
+  for (auto position : std::vector<uint64_t>{ 0, 100, 2000000, 10, 2999999, 700000, 700001, 3 * 1024 * 1024 }) {
+    io.setFilePointer(position);
+    EXPECT_EQ(position, io.getFilePointer());
+
+    auto wanted   = std::min<std::size_t>(buffer.size(), data.size() - position);
+    auto num_read = io.read(buffer.data(), buffer.size());
+
+    ASSERT_EQ(wanted, num_read);
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + num_read, data.begin() + position));
+  }
+
+  io.setFilePointer(-1000, seek_end);
+  EXPECT_EQ(data.size() - 1000, io.getFilePointer());
+  EXPECT_EQ(data[data.size() - 1000], io.read_uint8());
+
+  io.skip(-2);
+  EXPECT_EQ(data[data.size() - 1001], io.read_uint8());
+}
+
+TEST(MmReadAheadIo, OpenWithBufferSize) {
+  auto data = create_data(2 * 1024 * 1024 + 3);
+
+  auto synchronous = std::unique_ptr<mm_io_c>(mm_read_ahead_io_c::open(new mm_mem_io_c{data.data(), data.size()}, 0));
+  EXPECT_EQ(nullptr, dynamic_cast<mm_read_ahead_io_c *>(synchronous.get()));
+
+  for (auto buffer_size : std::vector<std::size_t>{ 1000, 300 * 1024, 3 * 1024 * 1024 + 5 }) {
+    auto io = std::unique_ptr<mm_io_c>(mm_read_ahead_io_c::open(new mm_mem_io_c{data.data(), data.size()}, buffer_size));
+    EXPECT_NE(nullptr, dynamic_cast<mm_read_ahead_io_c *>(io.get()));
+
+    auto content = std::vector<unsigned char>(data.size());
+    auto num_read = 0u;
+
+    while (num_read < content.size()) {
+      auto chunk = io->read(&content[num_read], std::min<std::size_t>(77777, content.size() - num_read));
+      if (!chunk)
+        break;
+      num_read += chunk;
+    }
+
+    ASSERT_EQ(data.size(), num_read);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), content.begin()));
+  }
+}
+
+TEST(MmReadAheadIo, BuffersAreAccounted) {
+  auto data      = create_data(2 * 1024 * 1024);
+  auto &memory   = mtx::memory_accounting::component("read-ahead buffers");
+  auto base      = memory.get_current();
+  auto buffer    = std::vector<unsigned char>(data.size());
+
+  {
+    mm_read_ahead_io_c io{new mm_mem_io_c{data.data(), data.size()}, 256 * 1024, 4};
+
+    ASSERT_EQ(data.size(), io.read(buffer.data(), buffer.size()));
+    EXPECT_LT(base, memory.get_current());
+    EXPECT_GE(base + 6 * 256 * 1024, memory.get_current());
+  }
+
+  EXPECT_EQ(base, memory.get_current());
+}
+
+}
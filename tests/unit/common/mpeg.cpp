@@ -0,0 +1,51 @@
+#include "common/common_pch.h"
+
+#include "common/mpeg.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+auto s_remove_0x0c = [](unsigned char nalu_header) { return 0x0c == nalu_header; };
+auto s_remove_none = [](unsigned char) { return false; };
+
+memory_cptr
+create(std::vector<unsigned char> const &bytes) {
+  return memory_c::clone(bytes.data(), bytes.size());
+}
+
+std::vector<unsigned char>
+to_vector(memory_cptr const &mem) {
+  return std::vector<unsigned char>(mem->get_buffer(), mem->get_buffer() + mem->get_size());
+}
+
+TEST(MPEG, RemoveNALUsSameSizeLength) {
+  auto data   = create({ 0, 2, 0x65, 0x01,  0, 3, 0x0c, 0xff, 0xff,  0, 1, 0x41,  0, 2, 0x0c, 0xff });
+  auto result = mtx::mpeg::remove_nalus_and_change_nalu_size_len(data, 2, 2, s_remove_0x0c);
+
+  EXPECT_EQ(std::vector<unsigned char>({ 0, 2, 0x65, 0x01,  0, 1, 0x41 }), to_vector(result));
+}
+
+TEST(MPEG, ChangeNALUSizeLengthGrowing) {
+  auto data   = create({ 2, 0x65, 0x01,  3, 0x0c, 0xff, 0xff,  1, 0x41 });
+  auto result = mtx::mpeg::remove_nalus_and_change_nalu_size_len(data, 1, 4, s_remove_none);
+
+  EXPECT_EQ(std::vector<unsigned char>({ 0, 0, 0, 2, 0x65, 0x01,  0, 0, 0, 3, 0x0c, 0xff, 0xff,  0, 0, 0, 1, 0x41 }), to_vector(result));
+}
+
+TEST(MPEG, ChangeNALUSizeLengthShrinkingAndRemoving) {
+  auto data   = create({ 0, 0, 0, 2, 0x65, 0x01,  0, 0, 0, 1, 0x0c,  0, 0, 0, 1, 0x41 });
+  auto result = mtx::mpeg::remove_nalus_and_change_nalu_size_len(data, 4, 2, s_remove_0x0c);
+
+  EXPECT_EQ(std::vector<unsigned char>({ 0, 2, 0x65, 0x01,  0, 1, 0x41 }), to_vector(result));
+}
+
+TEST(MPEG, ChangeNALUSizeLengthTooSmall) {
+  auto bytes = std::vector<unsigned char>(2 + 300, 0x41);
+  bytes[0]   = 300 >> 8;
+  bytes[1]   = 300 & 0xff;
+
+  EXPECT_THROW(mtx::mpeg::remove_nalus_and_change_nalu_size_len(create(bytes), 2, 1, s_remove_none), mtx::mpeg::nalu_size_length_x);
+}
+
+}
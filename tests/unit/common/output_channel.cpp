@@ -0,0 +1,64 @@
+#include "common/common_pch.h"
+
+#include "common/output_channel.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(OutputChannel, NotRunningByDefault) {
+  mtx::output::channel_c channel;
+
+  EXPECT_FALSE(channel.is_running());
+  EXPECT_FALSE(mtx::output::channel_c::is_own_thread());
+}
+
+TEST(OutputChannel, OrderAndFlush) {
+  mtx::output::channel_c channel;
+  auto values  = std::vector<int>{};
+
+  channel.start();
+  EXPECT_TRUE(channel.is_running());
+
+  for (auto idx = 0; idx < 1000; ++idx)
+    channel.post([&values, idx]() { values.push_back(idx); });
+
+  channel.flush();
+
+  ASSERT_EQ(1000u, values.size());
+  for (auto idx = 0; idx < 1000; ++idx)
+    EXPECT_EQ(idx, values[idx]);
+
+  channel.stop();
+  EXPECT_FALSE(channel.is_running());
+}
+
+TEST(OutputChannel, MultipleProducers) {
+  mtx::output::channel_c channel;
+  auto values    = std::vector<std::vector<int>>(4);
+  auto producers = std::vector<std::thread>{};
+
+  channel.start();
+
+  for (auto producer_idx = 0u; producer_idx < values.size(); ++producer_idx)
+    producers.emplace_back([&channel, &values, producer_idx]() {
+      for (auto idx = 0; idx < 10000; ++idx)
+        channel.post([&values, producer_idx, idx]() {
+          EXPECT_TRUE(mtx::output::channel_c::is_own_thread());
+          values[producer_idx].push_back(idx);
+        });
+    });
+
+  for (auto &producer : producers)
+    producer.join();
+
+  channel.stop();
+
+  for (auto const &producer_values : values) {
+    ASSERT_EQ(10000u, producer_values.size());
+    for (auto idx = 0; idx < 10000; ++idx)
+      EXPECT_EQ(idx, producer_values[idx]);
+  }
+}
+
+}
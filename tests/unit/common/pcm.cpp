@@ -0,0 +1,106 @@
+#include "common/common_pch.h"
+
+#include "common/bswap.h"
+#include "common/pcm.h"
+#include "common/simd.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<mtx::simd::level_e> const s_all_levels{
+  mtx::simd::level_e::none,
+  mtx::simd::level_e::sse2,
+  mtx::simd::level_e::ssse3,
+  mtx::simd::level_e::avx2,
+};
+
+std::vector<unsigned char>
+create_samples(std::size_t num_bytes) {
+  auto bytes = std::vector<unsigned char>(num_bytes);
+  for (auto idx = 0u; idx < num_bytes; ++idx)
+    bytes[idx] = idx * 13 + 5;
+
+  return bytes;
+}
+
+std::vector<unsigned char>
+remove_channels_naively(std::vector<unsigned char> const &src,
+                        std::size_t bytes_per_channel,
+                        std::size_t num_input_channels,
+                        std::size_t num_output_channels) {
+  auto input_frame_size  = bytes_per_channel * num_input_channels;
+  auto output_frame_size = bytes_per_channel * num_output_channels;
+  auto result            = std::vector<unsigned char>{};
+
+  for (auto frame_pos = 0u; (frame_pos + input_frame_size) <= src.size(); frame_pos += input_frame_size)
+    result.insert(result.end(), src.begin() + frame_pos, src.begin() + frame_pos + output_frame_size);
+
+  return result;
+}
+
+// All layouts of Blu-ray PCM with an odd number of channels, 16 and
+// 24 bits per sample, using every available instruction set.
+TEST(PCM, RemoveChannelsBluRayLayouts) {
+  for (auto level : s_all_levels) {
+    mtx::simd::set_max_level(level);
+
+    for (auto bytes_per_channel : std::vector<std::size_t>{ 2, 3 })
+      for (auto num_output_channels : std::vector<std::size_t>{ 1, 3, 5, 7 })
+        for (auto num_bytes : std::vector<std::size_t>{ 0, 5, 16, 17, 100, 1000, 4099 }) {
+          auto src      = create_samples(num_bytes);
+          auto expected = remove_channels_naively(src, bytes_per_channel, num_output_channels + 1, num_output_channels);
+          auto dst      = std::vector<unsigned char>(expected.size());
+
+          EXPECT_EQ(expected.size(), mtx::pcm::remove_channels(src.data(), dst.data(), src.size(), bytes_per_channel, num_output_channels + 1, num_output_channels));
+          EXPECT_EQ(expected, dst);
+
+          auto in_place_size = mtx::pcm::remove_channels(src.data(), src.data(), src.size(), bytes_per_channel, num_output_channels + 1, num_output_channels);
+          src.resize(in_place_size);
+          EXPECT_EQ(expected, src);
+        }
+  }
+
+  mtx::simd::set_max_level(mtx::simd::level_e::avx2);
+}
+
+TEST(PCM, RemoveMultipleChannels) {
+  auto src      = create_samples(2 * 6 * 10 + 3);
+  auto expected = remove_channels_naively(src, 2, 6, 2);
+  auto dst      = std::vector<unsigned char>(expected.size());
+
+  EXPECT_EQ(expected.size(), mtx::pcm::remove_channels(src.data(), dst.data(), src.size(), 2, 6, 2));
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(PCM, RemoveChannelsNeedsSeparateBufferOnlyForSSSE3) {
+  mtx::simd::set_max_level(mtx::simd::level_e::sse2);
+  EXPECT_FALSE(mtx::pcm::remove_channels_needs_separate_buffer(4096, 2, 4, 3));
+
+  mtx::simd::set_max_level(mtx::simd::level_e::avx2);
+  EXPECT_FALSE(mtx::pcm::remove_channels_needs_separate_buffer(15,   2, 4, 3));
+  EXPECT_FALSE(mtx::pcm::remove_channels_needs_separate_buffer(4096, 3, 8, 7));
+#if defined(MTX_SIMD_X86)
+  EXPECT_EQ(mtx::simd::level_e::ssse3 <= mtx::simd::get_level(), mtx::pcm::remove_channels_needs_separate_buffer(4096, 2, 4, 3));
+#endif
+}
+
+TEST(PCM, ByteSwappingWithAllInstructionSets) {
+  for (auto level : s_all_levels) {
+    mtx::simd::set_max_level(level);
+
+    for (auto word_length : std::vector<std::size_t>{ 2, 3, 4, 8 }) {
+      auto src = create_samples(word_length * 101);
+      auto dst = std::vector<unsigned char>(src.size());
+
+      mtx::bswap_buffer(src.data(), dst.data(), src.size(), word_length);
+
+      for (auto idx = 0u; idx < src.size(); idx += word_length)
+        EXPECT_TRUE(std::equal(src.begin() + idx, src.begin() + idx + word_length, dst.rbegin() + (dst.size() - idx - word_length)));
+    }
+  }
+
+  mtx::simd::set_max_level(mtx::simd::level_e::avx2);
+}
+
+}
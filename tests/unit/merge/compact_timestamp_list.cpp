@@ -0,0 +1,68 @@
+#include "common/common_pch.h"
+
+#include "merge/compact_timestamp_list.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<int64_t>
+create_timestamps() {
+  auto timestamps = std::vector<int64_t>{};
+  auto timestamp  = int64_t{};
+
+  for (auto idx = 0; idx < 1000; ++idx) {
+    timestamps.push_back(timestamp);
+    timestamp += (idx % 3) ? 41708000 : 41709000;
+  }
+
+  // Unsorted values as allowed by format v4 and extreme values
+  timestamps.insert(timestamps.end(), { 5, -120000000, 40000000, 0, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), 3 });
+
+  return timestamps;
+}
+
+TEST(CompactTimestampList, Empty) {
+  auto list = compact_timestamp_list_c{};
+
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0u, list.size());
+}
+
+TEST(CompactTimestampList, SequentialAccess) {
+  auto timestamps = create_timestamps();
+  auto list       = compact_timestamp_list_c{};
+
+  for (auto timestamp : timestamps)
+    list.add(timestamp);
+
+  ASSERT_EQ(timestamps.size(), list.size());
+  EXPECT_EQ(timestamps.back(), list.back());
+
+  for (auto idx = 0u; idx < timestamps.size(); ++idx) {
+    EXPECT_EQ(timestamps[idx], list.get(idx));
+    EXPECT_EQ(timestamps[idx], list.get(idx));
+  }
+}
+
+TEST(CompactTimestampList, RandomAccess) {
+  auto timestamps = create_timestamps();
+  auto list       = compact_timestamp_list_c{};
+
+  for (auto timestamp : timestamps)
+    list.add(timestamp);
+
+  for (auto idx : std::vector<std::size_t>{ 999, 0, 500, 64, 63, 65, 1006, 1000, 128, 127, 1 })
+    EXPECT_EQ(timestamps[idx], list.get(idx));
+}
+
+TEST(CompactTimestampList, MemoryUsage) {
+  auto list = compact_timestamp_list_c{};
+
+  for (auto idx = 0; idx < 100000; ++idx)
+    list.add(idx * 40000000ll);
+
+  EXPECT_GT(100000u * sizeof(int64_t) / 2, list.get_memory_usage());
+}
+
+}
@@ -0,0 +1,157 @@
+#include "common/common_pch.h"
+
+#include "common/memory_accounting.h"
+#include "merge/packetizer_worker.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/init.h"
+
+namespace {
+
+TEST(PacketizerWorker, CompletionsInSubmissionOrder) {
+  packetizer_worker_c worker{4};
+  auto parsed    = std::vector<int>{};
+  auto completed = std::vector<int>{};
+
+  for (auto idx = 0; idx < 100; ++idx) {
+    worker.submit([idx, &parsed, &completed]() -> packetizer_worker_c::completion_t {
+      if (!(idx % 7))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+      parsed.push_back(idx);
+
+      return [idx, &completed]() {
+        completed.push_back(idx);
+      };
+    });
+
+    worker.complete_finished_jobs();
+  }
+
+  worker.complete_all_jobs();
+
+  EXPECT_TRUE(worker.is_idle());
+  ASSERT_EQ(100u, completed.size());
+  ASSERT_EQ(100u, parsed.size());
+
+  for (auto idx = 0; idx < 100; ++idx) {
+    EXPECT_EQ(idx, parsed[idx]);
+    EXPECT_EQ(idx, completed[idx]);
+  }
+}
+
+TEST(PacketizerWorker, LimitsPendingJobs) {
+  packetizer_worker_c worker{2};
+  auto completed = 0;
+
+  for (auto idx = 0; idx < 5; ++idx)
+    worker.submit([&completed]() -> packetizer_worker_c::completion_t {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      return [&completed]() { ++completed; };
+    });
+
+  // Submitting the third, fourth and fifth jobs had to complete the
+  // oldest ones first.
+  EXPECT_EQ(3, completed);
+
+  worker.complete_all_jobs();
+  EXPECT_EQ(5, completed);
+}
+
+TEST(PacketizerWorker, EmptyCompletion) {
+  packetizer_worker_c worker;
+
+  worker.submit([]() { return packetizer_worker_c::completion_t{}; });
+  worker.complete_all_jobs();
+
+  EXPECT_TRUE(worker.is_idle());
+  EXPECT_FALSE(worker.complete_finished_jobs());
+}
+
+TEST(PacketizerWorker, PacketDataIsCopiedBeforeSubmitting) {
+  packetizer_worker_c worker;
+  auto release_job = std::promise<void>{};
+  auto job_may_run = release_job.get_future().share();
+  unsigned char source[4] = { 1, 2, 3, 4 };
+  auto packet      = std::make_shared<packet_t>(memory_cptr{new memory_c(source, sizeof(source), false)});
+  auto parsed      = std::vector<unsigned char>{};
+
+  worker.submit(packet, [packet, job_may_run, &parsed]() -> packetizer_worker_c::completion_t {
+    job_may_run.wait();
+    parsed.assign(packet->data->get_buffer(), packet->data->get_buffer() + packet->data->get_size());
+    return {};
+  });
+
+  // The reader re-uses its buffer as soon as process() has returned.
+  std::memset(source, 0, sizeof(source));
+  release_job.set_value();
+  worker.complete_all_jobs();
+
+  EXPECT_EQ((std::vector<unsigned char>{ 1, 2, 3, 4 }), parsed);
+}
+
+TEST(PacketizerWorker, PendingPacketDataIsAccounted) {
+  auto &memory     = mtx::memory_accounting::component("packetizer workers");
+  auto base        = memory.get_current();
+  auto release_job = std::promise<void>{};
+  auto job_may_run = release_job.get_future().share();
+
+  {
+    packetizer_worker_c worker;
+
+    for (auto idx = 0; idx < 3; ++idx)
+      worker.submit(std::make_shared<packet_t>(memory_c::alloc(1000)), [job_may_run]() -> packetizer_worker_c::completion_t {
+        job_may_run.wait();
+        return {};
+      });
+
+    EXPECT_EQ(base + 3000, memory.get_current());
+
+    release_job.set_value();
+    worker.complete_all_jobs();
+
+    EXPECT_EQ(base, memory.get_current());
+
+    worker.submit(std::make_shared<packet_t>(memory_c::alloc(500)), []() { return packetizer_worker_c::completion_t{}; });
+    EXPECT_EQ(base + 500, memory.get_current());
+  }
+
+  // Results still pending when the worker is destroyed are released.
+  EXPECT_EQ(base, memory.get_current());
+}
+
+TEST(PacketizerWorker, MessagesAreOutputBySubmittingThread) {
+  packetizer_worker_c worker;
+  auto job_done = std::promise<void>{};
+
+  g_warning_issued = false;
+
+  worker.submit([&job_done]() -> packetizer_worker_c::completion_t {
+    mxwarn("warning from a parser thread\n");
+    job_done.set_value();
+    return {};
+  });
+
+  job_done.get_future().wait();
+  EXPECT_FALSE(g_warning_issued);
+
+  worker.complete_all_jobs();
+  EXPECT_TRUE(g_warning_issued);
+}
+
+TEST(PacketizerWorker, ExceptionsArePassedOn) {
+  packetizer_worker_c worker;
+  auto completed = 0;
+
+  worker.submit([&completed]() -> packetizer_worker_c::completion_t { return [&completed]() { ++completed; }; });
+  worker.submit([]() -> packetizer_worker_c::completion_t { throw mtx::exception{}; });
+  worker.submit([&completed]() -> packetizer_worker_c::completion_t { return [&completed]() { ++completed; }; });
+
+  EXPECT_THROW(worker.complete_all_jobs(), mtx::exception);
+  EXPECT_EQ(1, completed);
+
+  worker.complete_all_jobs();
+  EXPECT_EQ(2, completed);
+}
+
+}
@@ -0,0 +1,94 @@
+#include "common/common_pch.h"
+
+#include "merge/progress_report.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+progress_report_c::sample_t
+create_sample(int64_t time_ms,
+              uint64_t bytes_read,
+              uint64_t bytes_written,
+              std::vector<progress_report_c::track_t> tracks = {}) {
+  auto sample            = progress_report_c::sample_t{};
+  sample.m_time_ms       = time_ms;
+  sample.m_percentage    = bytes_read * 100 / 1000000;
+  sample.m_bytes_read    = bytes_read;
+  sample.m_bytes_total   = 1000000;
+  sample.m_bytes_written = bytes_written;
+  sample.m_tracks        = tracks;
+
+  return sample;
+}
+
+TEST(ProgressReport, FirstSample) {
+  auto report = progress_report_c{};
+  auto json   = report.add_sample(create_sample(5000, 1000, 500, { { 1, 10 } }));
+
+  EXPECT_EQ(0,    json["progress"].get<int>());
+  EXPECT_EQ(0,    json["elapsed"].get<int64_t>());
+  EXPECT_EQ(1000, json["bytes_read"].get<uint64_t>());
+  EXPECT_EQ(500,  json["bytes_written"].get<uint64_t>());
+  EXPECT_TRUE(json["read_rate"].is_null());
+  EXPECT_TRUE(json["write_rate"].is_null());
+  EXPECT_TRUE(json["timestamp"].is_null());
+  EXPECT_TRUE(json["remaining_time"].is_null());
+
+  ASSERT_EQ(1u, json["tracks"].size());
+  EXPECT_EQ(1,  json["tracks"][0]["id"].get<int64_t>());
+  EXPECT_EQ(10, json["tracks"][0]["packets"].get<int64_t>());
+  EXPECT_TRUE(json["tracks"][0]["packet_rate"].is_null());
+}
+
+TEST(ProgressReport, Rates) {
+  auto report = progress_report_c{};
+
+  report.add_sample(create_sample(1000, 0, 0, { { 1, 0 } }));
+  auto json = report.add_sample(create_sample(1500, 100000, 50000, { { 1, 25 }, { 2, 5 } }));
+
+  EXPECT_EQ(500,    json["elapsed"].get<int64_t>());
+  EXPECT_EQ(200000, json["read_rate"].get<uint64_t>());
+  EXPECT_EQ(100000, json["write_rate"].get<uint64_t>());
+
+  ASSERT_EQ(2u, json["tracks"].size());
+  EXPECT_DOUBLE_EQ(50.0, json["tracks"][0]["packet_rate"].get<double>());
+  EXPECT_DOUBLE_EQ(10.0, json["tracks"][1]["packet_rate"].get<double>());
+}
+
+TEST(ProgressReport, RatesAfterSeekingBack) {
+  auto report = progress_report_c{};
+
+  report.add_sample(create_sample(1000, 500000, 50000, { { 1, 25 } }));
+  auto json = report.add_sample(create_sample(1500, 100000, 50000, { { 1, 25 } }));
+
+  ASSERT_TRUE(json["read_rate"].is_number_unsigned());
+  EXPECT_EQ(0, json["read_rate"].get<uint64_t>());
+  EXPECT_EQ(0, json["write_rate"].get<uint64_t>());
+  EXPECT_DOUBLE_EQ(0.0, json["tracks"][0]["packet_rate"].get<double>());
+}
+
+TEST(ProgressReport, RemainingTime) {
+  auto report = progress_report_c{};
+
+  report.add_sample(create_sample(0, 0, 0));
+
+  // Less than a second is too short for an estimate.
+  EXPECT_TRUE(report.add_sample(create_sample(500, 100000, 0))["remaining_time"].is_null());
+
+  auto json = report.add_sample(create_sample(2000, 250000, 0));
+  EXPECT_EQ(6000, json["remaining_time"].get<int64_t>());
+
+  json = report.add_sample(create_sample(4000, 1000000, 0));
+  EXPECT_EQ(0, json["remaining_time"].get<int64_t>());
+}
+
+TEST(ProgressReport, Timestamp) {
+  auto report        = progress_report_c{};
+  auto sample        = create_sample(0, 0, 0);
+  sample.m_timestamp = timestamp_c::ms(1234);
+
+  EXPECT_EQ(1234000000, report.add_sample(sample)["timestamp"].get<int64_t>());
+}
+
+}